@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cask/ecs/entity_compactor.hpp>
+#include <cask/ecs/entity_events.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/event/event_queue.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct AmortizedCompactor {
+    using Clock = std::chrono::steady_clock;
+    using RetireFn = void (*)(void* observer, uint32_t entity);
+    static constexpr size_t entities_per_slice = 256;
+
+    size_t entity_budget_ = 0;
+    Clock::duration time_budget_ = Clock::duration::zero();
+    EventQueue<DestroyEntity> staged_;
+    std::vector<uint32_t> pending_;
+    std::vector<bool> retiring_;
+    size_t head_ = 0;
+    size_t compacted_ = 0;
+    std::vector<std::pair<void*, RetireFn>> observers_;
+
+    bool budgeted() const {
+        return entity_budget_ > 0 || time_budget_ > Clock::duration::zero();
+    }
+
+    bool retiring(uint32_t entity) const {
+        return entity < retiring_.size() && retiring_[entity];
+    }
+
+    void observe(void* observer, RetireFn retire) {
+        observers_.emplace_back(observer, retire);
+    }
+
+    size_t pending() const {
+        return pending_.size() - head_;
+    }
+
+    template<typename Events>
+    size_t retire(const EntityTable& table, const Events& events) {
+        size_t retired = 0;
+        size_t largest = retiring_.size();
+        for (auto& event : events) {
+            largest = std::max(largest, size_t(event.entity) + 1);
+        }
+        retiring_.resize(largest);
+        for (auto& event : events) {
+            if (retiring_[event.entity] || !table.alive(event.entity)) continue;
+            retiring_[event.entity] = true;
+            pending_.push_back(event.entity);
+            ++retired;
+            for (auto& [observer, retire] : observers_) {
+                retire(observer, event.entity);
+            }
+        }
+        return retired;
+    }
+
+    size_t compact(EntityCompactor& compactor) {
+        auto deadline = Clock::now() + time_budget_;
+        size_t limit = entity_budget_ > 0 ? std::min(entity_budget_, pending()) : pending();
+        size_t done = 0;
+        while (done < limit) {
+            size_t count = std::min(entities_per_slice, limit - done);
+            for (size_t index = head_; index < head_ + count; ++index) {
+                retiring_[pending_[index]] = false;
+                staged_.emit(DestroyEntity{pending_[index]});
+            }
+            staged_.swap();
+            compactor.compact(staged_);
+            head_ += count;
+            done += count;
+            if (time_budget_ > Clock::duration::zero() && Clock::now() >= deadline) break;
+        }
+        if (head_ == pending_.size()) {
+            pending_.clear();
+            head_ = 0;
+        }
+        compacted_ += done;
+        return done;
+    }
+
+    size_t compact(EntityCompactor& compactor, EventQueue<DestroyEntity>& queue) {
+        retire(*compactor.table_, queue.poll());
+        return compact(compactor);
+    }
+};
+
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cask/foundation/file_watcher.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/resource/resource_store.hpp>
+#include <cask/resource/resource_sources.hpp>
+#include <cask/resource/resource_loader_registry.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct ReloadFailure {
+    std::string key;
+    std::string error;
+};
+
+struct ReloadWorker {
+    using Apply = std::function<void()>;
+    using Job = std::function<Apply()>;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::pair<std::string, Job>> jobs_;
+    std::vector<Apply> completed_;
+    std::vector<Apply> applying_;
+    std::vector<ReloadFailure> failures_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    ReloadWorker()
+        : thread_([this] { run(); }) {}
+
+    ~ReloadWorker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void submit(std::string key, Job job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.emplace_back(std::move(key), std::move(job));
+        }
+        wake_.notify_one();
+    }
+
+    size_t apply_completed() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::swap(applying_, completed_);
+        }
+        for (auto& apply : applying_) {
+            apply();
+        }
+        size_t applied = applying_.size();
+        applying_.clear();
+        return applied;
+    }
+
+    void take_failures(std::vector<ReloadFailure>& failures) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(failures, failures_);
+        failures_.clear();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) return;
+            auto [key, job] = std::move(jobs_.front());
+            jobs_.pop_front();
+            lock.unlock();
+            Apply apply;
+            std::optional<std::string> error;
+            try {
+                apply = job();
+            } catch (const std::exception& exception) {
+                error = exception.what();
+            } catch (...) {
+                error = "unknown exception";
+            }
+            lock.lock();
+            if (error) failures_.push_back(ReloadFailure{std::move(key), std::move(*error)});
+            if (apply) completed_.push_back(std::move(apply));
+        }
+    }
+};
+
+struct ReloadTarget {
+    const WriteGeneration* generation = nullptr;
+    std::function<size_t()> source_signature;
+    std::function<void(std::unordered_map<std::string, std::vector<std::string>>&)> collect_paths;
+    std::function<ReloadWorker::Job(const std::string& key)> reload;
+};
+
+struct AssetReloader {
+    using Clock = std::chrono::steady_clock;
+
+    std::string root_;
+    std::string path_field_ = "path";
+    Clock::duration quiet_period_ = std::chrono::milliseconds(100);
+    FileWatcher watcher_;
+    ChangeDebouncer debouncer_;
+    std::vector<ReloadTarget> targets_;
+    std::vector<std::optional<size_t>> indexed_signatures_;
+    std::unordered_map<std::string, std::vector<std::pair<size_t, std::string>>> path_to_sources_;
+    std::vector<std::string> changed_;
+    std::vector<std::string> ready_;
+    std::vector<ReloadFailure> failures_;
+    size_t reloads_scheduled_ = 0;
+    size_t reloads_applied_ = 0;
+    size_t reloads_failed_ = 0;
+    std::unique_ptr<ReloadWorker> worker_ = std::make_unique<ReloadWorker>();
+
+    template<typename Resource>
+    void track(ResourceStore<Resource>* store, ResourceSources<Resource>* sources, const ResourceLoaderRegistry<Resource>* loaders) {
+        track(sources, loaders, std::function<void(const std::string&, Resource&)>([store](const std::string& key, Resource& resource) {
+            auto handle = store->key_to_handle_.find(key);
+            if (handle == store->key_to_handle_.end()) return;
+            store->resources_[handle->second] = std::move(resource);
+        }));
+    }
+
+    template<typename Resource>
+    void track(ResourceSources<Resource>* sources, const ResourceLoaderRegistry<Resource>* loaders, std::function<void(const std::string&, Resource&)> write, const WriteGeneration* generation = nullptr) {
+        ReloadTarget target;
+        target.generation = generation;
+        std::string field = path_field_;
+        target.source_signature = [sources, field] {
+            std::hash<std::string> hash;
+            size_t signature = sources->entries.size();
+            for (auto& [key, entry] : sources->entries) {
+                signature = signature * 31 + hash(key);
+                if (!entry.contains(field)) continue;
+                signature = signature * 31 + hash(entry[field].template get<std::string>());
+            }
+            return signature;
+        };
+        target.collect_paths = [sources, field](std::unordered_map<std::string, std::vector<std::string>>& paths) {
+            for (auto& [key, entry] : sources->entries) {
+                if (!entry.contains(field)) continue;
+                paths[entry[field].template get<std::string>()].push_back(key);
+            }
+        };
+        target.reload = [sources, loaders, write](const std::string& key) -> ReloadWorker::Job {
+            auto found = sources->entries.find(key);
+            if (found == sources->entries.end()) return {};
+            auto entry = found->second;
+            return [loaders, write, key, entry]() -> ReloadWorker::Apply {
+                auto resource = std::make_shared<Resource>(loaders->load(entry));
+                return [write, key, resource] {
+                    write(key, *resource);
+                };
+            };
+        };
+        targets_.push_back(std::move(target));
+        indexed_signatures_.push_back(std::nullopt);
+    }
+
+    void update(Clock::time_point now) {
+        refresh_index();
+
+        changed_.clear();
+        watcher_.poll(changed_);
+        for (auto& path : changed_) {
+            if (path_to_sources_.count(path) == 0) continue;
+            debouncer_.note(path, now);
+        }
+
+        ready_.clear();
+        debouncer_.settled(now, quiet_period_, ready_);
+        for (auto& path : ready_) {
+            for (auto& [target, key] : path_to_sources_[path]) {
+                auto job = targets_[target].reload(key);
+                if (!job) continue;
+                worker_->submit(key, std::move(job));
+                ++reloads_scheduled_;
+            }
+        }
+
+        reloads_applied_ += worker_->apply_completed();
+        worker_->take_failures(failures_);
+        reloads_failed_ += failures_.size();
+    }
+
+private:
+    static std::string parent_directory(const std::string& path) {
+        auto separator = path.find_last_of('/');
+        if (separator == std::string::npos) return std::string();
+        return path.substr(0, separator);
+    }
+
+    void refresh_index() {
+        bool stale = false;
+        for (size_t target = 0; target < targets_.size(); ++target) {
+            auto& tracked = targets_[target];
+            size_t signature = tracked.generation ? size_t(tracked.generation->value_) : tracked.source_signature();
+            if (signature == indexed_signatures_[target]) continue;
+            indexed_signatures_[target] = signature;
+            stale = true;
+        }
+        if (!stale) return;
+
+        path_to_sources_.clear();
+        std::unordered_map<std::string, std::vector<std::string>> paths;
+        for (size_t target = 0; target < targets_.size(); ++target) {
+            paths.clear();
+            targets_[target].collect_paths(paths);
+            for (auto& [path, keys] : paths) {
+                for (auto& key : keys) {
+                    path_to_sources_[path].emplace_back(target, key);
+                }
+                watcher_.watch(root_, parent_directory(path));
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,586 @@
+#pragma once
+
+#include <cask/ecs/component_store.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct Aabb {
+    float min[3] = {std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+    float max[3] = {-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+
+    void expand(const float* point) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], point[axis]);
+            max[axis] = std::max(max[axis], point[axis]);
+        }
+    }
+
+    void expand(const Aabb& other) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], other.min[axis]);
+            max[axis] = std::max(max[axis], other.max[axis]);
+        }
+    }
+
+    bool empty() const {
+        return min[0] > max[0] || min[1] > max[1] || min[2] > max[2];
+    }
+
+    bool overlaps(const Aabb& other) const {
+        return min[0] <= other.max[0] && max[0] >= other.min[0]
+            && min[1] <= other.max[1] && max[1] >= other.min[1]
+            && min[2] <= other.max[2] && max[2] >= other.min[2];
+    }
+
+    float center(int axis) const {
+        return (min[axis] + max[axis]) * 0.5f;
+    }
+
+    float half_area() const {
+        if (empty()) return 0.0f;
+        float x = max[0] - min[0];
+        float y = max[1] - min[1];
+        float z = max[2] - min[2];
+        return x * y + y * z + z * x;
+    }
+
+    bool operator==(const Aabb&) const = default;
+};
+
+inline Aabb compute_bounds(const float* vertices, size_t vertex_count, uint32_t stride) {
+    Aabb bounds;
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        bounds.expand(vertices + vertex * stride);
+    }
+    return bounds;
+}
+
+struct Plane {
+    float normal[3];
+    float distance;
+};
+
+struct Frustum {
+    std::array<Plane, 6> planes;
+
+    static Frustum from_matrix(const float* matrix) {
+        auto row = [matrix](int index, int column) { return matrix[column * 4 + index]; };
+        Frustum frustum;
+        for (int axis = 0; axis < 3; ++axis) {
+            for (int side = 0; side < 2; ++side) {
+                float sign = side == 0 ? 1.0f : -1.0f;
+                Plane& plane = frustum.planes[axis * 2 + side];
+                for (int column = 0; column < 3; ++column) {
+                    plane.normal[column] = row(3, column) + sign * row(axis, column);
+                }
+                plane.distance = row(3, 3) + sign * row(axis, 3);
+                float length = std::sqrt(plane.normal[0] * plane.normal[0] + plane.normal[1] * plane.normal[1] + plane.normal[2] * plane.normal[2]);
+                for (auto& component : plane.normal) component /= length;
+                plane.distance /= length;
+            }
+        }
+        return frustum;
+    }
+};
+
+struct Ray {
+    float origin[3];
+    float direction[3];
+    float max_distance = std::numeric_limits<float>::infinity();
+};
+
+struct MeshBounds {
+    std::vector<Aabb> bounds_;
+    uint64_t revision_ = 0;
+
+    void record(uint32_t mesh, const Aabb& bounds) {
+        if (mesh >= bounds_.size()) bounds_.resize(mesh + 1);
+        bounds_[mesh] = bounds;
+        ++revision_;
+    }
+
+    const Aabb* find(uint32_t mesh) const {
+        if (mesh >= bounds_.size() || bounds_[mesh].empty()) return nullptr;
+        return &bounds_[mesh];
+    }
+};
+
+constexpr size_t bvh_width = 4;
+constexpr size_t bvh_leaf_capacity = 8;
+constexpr size_t bvh_leaf_fill = 6;
+constexpr size_t bvh_inline_stack = 64;
+constexpr int32_t bvh_empty_lane = std::numeric_limits<int32_t>::min();
+constexpr uint32_t bvh_absent = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t bvh_pending = bvh_absent - 1;
+
+struct BvhNode {
+    alignas(16) float min_x[bvh_width];
+    alignas(16) float min_y[bvh_width];
+    alignas(16) float min_z[bvh_width];
+    alignas(16) float max_x[bvh_width];
+    alignas(16) float max_y[bvh_width];
+    alignas(16) float max_z[bvh_width];
+    int32_t children[bvh_width];
+    uint32_t parent;
+    uint32_t parent_lane;
+
+    BvhNode() {
+        for (size_t lane = 0; lane < bvh_width; ++lane) {
+            set_lane(lane, Aabb{});
+            children[lane] = bvh_empty_lane;
+        }
+        parent = bvh_absent;
+        parent_lane = 0;
+    }
+
+    void set_lane(size_t lane, const Aabb& bounds) {
+        min_x[lane] = bounds.min[0];
+        min_y[lane] = bounds.min[1];
+        min_z[lane] = bounds.min[2];
+        max_x[lane] = bounds.max[0];
+        max_y[lane] = bounds.max[1];
+        max_z[lane] = bounds.max[2];
+    }
+
+    Aabb lane(size_t lane) const {
+        Aabb bounds;
+        bounds.min[0] = min_x[lane];
+        bounds.min[1] = min_y[lane];
+        bounds.min[2] = min_z[lane];
+        bounds.max[0] = max_x[lane];
+        bounds.max[1] = max_y[lane];
+        bounds.max[2] = max_z[lane];
+        return bounds;
+    }
+
+    Aabb bounds() const {
+        Aabb all;
+        for (size_t index = 0; index < bvh_width; ++index) {
+            if (children[index] != bvh_empty_lane) all.expand(lane(index));
+        }
+        return all;
+    }
+};
+
+struct BvhBuildItem {
+    float center[3];
+    uint32_t entity;
+};
+
+struct BvhLeaf {
+    uint32_t parent;
+    uint32_t parent_lane;
+    uint32_t count = 0;
+    std::array<uint32_t, bvh_leaf_capacity> entities;
+};
+
+struct Bvh {
+    std::vector<BvhNode> nodes_;
+    std::vector<BvhLeaf> leaves_;
+    std::vector<Aabb> bounds_;
+    std::vector<uint32_t> leaf_of_;
+    std::vector<uint32_t> pending_;
+    std::vector<uint32_t> dirty_leaves_;
+    std::vector<uint8_t> node_dirty_;
+    EntityWatch watch_;
+    size_t size_ = 0;
+    size_t depth_ = 0;
+    size_t inserted_since_build_ = 0;
+    size_t builds_ = 0;
+    bool needs_build_ = false;
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool contains(uint32_t entity) const {
+        return entity < leaf_of_.size() && leaf_of_[entity] != bvh_absent;
+    }
+
+    const Aabb& bounds(uint32_t entity) const {
+        return bounds_[entity];
+    }
+
+    void insert(uint32_t entity, const Aabb& bounds) {
+        if (contains(entity)) {
+            update(entity, bounds);
+            return;
+        }
+        if (entity >= leaf_of_.size()) {
+            leaf_of_.resize(entity + 1, bvh_absent);
+            bounds_.resize(entity + 1);
+        }
+        bounds_[entity] = bounds;
+        ++size_;
+        ++inserted_since_build_;
+        uint32_t leaf = best_leaf(bounds);
+        if (leaf == bvh_absent || leaves_[leaf].count == bvh_leaf_capacity) {
+            leaf_of_[entity] = bvh_pending;
+            pending_.push_back(entity);
+            needs_build_ = true;
+            return;
+        }
+        leaves_[leaf].entities[leaves_[leaf].count++] = entity;
+        leaf_of_[entity] = leaf;
+        mark_dirty(leaf);
+    }
+
+    void update(uint32_t entity, const Aabb& bounds) {
+        bounds_[entity] = bounds;
+        if (leaf_of_[entity] != bvh_pending) mark_dirty(leaf_of_[entity]);
+    }
+
+    void remove(uint32_t entity) {
+        if (!contains(entity)) return;
+        uint32_t leaf = leaf_of_[entity];
+        leaf_of_[entity] = bvh_absent;
+        --size_;
+        if (leaf == bvh_pending) {
+            std::erase(pending_, entity);
+            return;
+        }
+        auto& slots = leaves_[leaf];
+        auto* found = std::find(slots.entities.begin(), slots.entities.begin() + slots.count, entity);
+        *found = slots.entities[--slots.count];
+        mark_dirty(leaf);
+    }
+
+    void watch(EntityWatchers& watchers) {
+        watch_ = EntityWatch(watchers, this, forget_entity);
+    }
+
+    void unwatch() {
+        watch_.reset();
+    }
+
+    void sync(const ComponentStore<Aabb>& store) {
+        for (size_t index = 0; index < store.entities_.size(); ++index) {
+            uint32_t entity = store.entities_[index];
+            const Aabb& bounds = store.components_[index];
+            if (!contains(entity)) {
+                insert(entity, bounds);
+            } else if (!(bounds_[entity] == bounds)) {
+                update(entity, bounds);
+            }
+        }
+        commit();
+    }
+
+    void commit() {
+        if (needs_build_ || inserted_since_build_ * 4 > size_) {
+            build();
+            return;
+        }
+        refit();
+    }
+
+    void build() {
+        std::vector<BvhBuildItem> items;
+        items.reserve(size_);
+        for (auto& leaf : leaves_) {
+            for (uint32_t index = 0; index < leaf.count; ++index) {
+                items.push_back(build_item(leaf.entities[index]));
+            }
+        }
+        for (uint32_t entity : pending_) {
+            items.push_back(build_item(entity));
+        }
+        nodes_.clear();
+        leaves_.clear();
+        pending_.clear();
+        dirty_leaves_.clear();
+        needs_build_ = false;
+        inserted_since_build_ = 0;
+        depth_ = 0;
+        ++builds_;
+        if (items.empty()) return;
+        nodes_.reserve(items.size() / bvh_leaf_fill + 1);
+        leaves_.reserve(items.size() / bvh_leaf_fill * 2 + 1);
+        if (items.size() <= bvh_leaf_fill) {
+            nodes_.emplace_back();
+            auto [child, bounds] = build_leaf(items, 0, items.size(), 0, 0);
+            nodes_[0].children[0] = child;
+            nodes_[0].set_lane(0, bounds);
+            depth_ = 1;
+        } else {
+            build_node(items, 0, items.size(), bvh_absent, 0, 1);
+        }
+        node_dirty_.assign(nodes_.size(), 0);
+    }
+
+    void refit() {
+        if (dirty_leaves_.empty()) return;
+        for (uint32_t leaf : dirty_leaves_) {
+            auto& slots = leaves_[leaf];
+            Aabb bounds;
+            for (uint32_t index = 0; index < slots.count; ++index) {
+                bounds.expand(bounds_[slots.entities[index]]);
+            }
+            nodes_[slots.parent].set_lane(slots.parent_lane, bounds);
+            node_dirty_[slots.parent] = 1;
+        }
+        dirty_leaves_.clear();
+        for (size_t index = nodes_.size(); index-- > 1;) {
+            if (!node_dirty_[index]) continue;
+            node_dirty_[index] = 0;
+            auto& node = nodes_[index];
+            nodes_[node.parent].set_lane(node.parent_lane, node.bounds());
+            node_dirty_[node.parent] = 1;
+        }
+        node_dirty_[0] = 0;
+    }
+
+    template<typename Fn>
+    void query(const Aabb& box, Fn&& fn) const {
+        traverse(
+            [&box](const BvhNode& node, bool* hit, bool*) {
+                for (size_t lane = 0; lane < bvh_width; ++lane) {
+                    hit[lane] = (node.min_x[lane] <= box.max[0]) & (node.max_x[lane] >= box.min[0])
+                              & (node.min_y[lane] <= box.max[1]) & (node.max_y[lane] >= box.min[1])
+                              & (node.min_z[lane] <= box.max[2]) & (node.max_z[lane] >= box.min[2]);
+                }
+            },
+            [&box](const Aabb& bounds) { return bounds.overlaps(box); },
+            [&fn](uint32_t entity) { fn(entity); });
+    }
+
+    template<typename Fn>
+    void query(const Frustum& frustum, Fn&& fn) const {
+        traverse(
+            [&frustum](const BvhNode& node, bool* hit, bool* inside) {
+                bool visible[bvh_width] = {true, true, true, true};
+                bool contained[bvh_width] = {true, true, true, true};
+                for (auto& plane : frustum.planes) {
+                    const float* far_x = plane.normal[0] >= 0.0f ? node.max_x : node.min_x;
+                    const float* far_y = plane.normal[1] >= 0.0f ? node.max_y : node.min_y;
+                    const float* far_z = plane.normal[2] >= 0.0f ? node.max_z : node.min_z;
+                    const float* near_x = plane.normal[0] >= 0.0f ? node.min_x : node.max_x;
+                    const float* near_y = plane.normal[1] >= 0.0f ? node.min_y : node.max_y;
+                    const float* near_z = plane.normal[2] >= 0.0f ? node.min_z : node.max_z;
+                    for (size_t lane = 0; lane < bvh_width; ++lane) {
+                        float outer = plane.normal[0] * far_x[lane] + plane.normal[1] * far_y[lane] + plane.normal[2] * far_z[lane] + plane.distance;
+                        float inner = plane.normal[0] * near_x[lane] + plane.normal[1] * near_y[lane] + plane.normal[2] * near_z[lane] + plane.distance;
+                        visible[lane] &= outer >= 0.0f;
+                        contained[lane] &= inner >= 0.0f;
+                    }
+                }
+                for (size_t lane = 0; lane < bvh_width; ++lane) {
+                    hit[lane] = visible[lane] & (node.min_x[lane] <= node.max_x[lane]);
+                    inside[lane] = contained[lane];
+                }
+            },
+            [&frustum](const Aabb& bounds) {
+                for (auto& plane : frustum.planes) {
+                    float distance = plane.distance;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        distance += plane.normal[axis] * (plane.normal[axis] >= 0.0f ? bounds.max[axis] : bounds.min[axis]);
+                    }
+                    if (distance < 0.0f) return false;
+                }
+                return true;
+            },
+            [&fn](uint32_t entity) { fn(entity); });
+    }
+
+    template<typename Fn>
+    void query(const Ray& ray, Fn&& fn) const {
+        float inverse[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            inverse[axis] = 1.0f / ray.direction[axis];
+        }
+        auto slab = [&ray, &inverse](float min, float max, int axis, float& enter, float& exit) {
+            float near = (min - ray.origin[axis]) * inverse[axis];
+            float far = (max - ray.origin[axis]) * inverse[axis];
+            enter = std::max(enter, std::min(near, far));
+            exit = std::min(exit, std::max(near, far));
+        };
+        traverse(
+            [&ray, &slab](const BvhNode& node, bool* hit, bool*) {
+                for (size_t lane = 0; lane < bvh_width; ++lane) {
+                    float enter = 0.0f;
+                    float exit = ray.max_distance;
+                    slab(node.min_x[lane], node.max_x[lane], 0, enter, exit);
+                    slab(node.min_y[lane], node.max_y[lane], 1, enter, exit);
+                    slab(node.min_z[lane], node.max_z[lane], 2, enter, exit);
+                    hit[lane] = enter <= exit;
+                }
+            },
+            [](const Aabb&) { return true; },
+            [this, &ray, &slab, &fn](uint32_t entity) {
+                const Aabb& bounds = bounds_[entity];
+                float enter = 0.0f;
+                float exit = ray.max_distance;
+                for (int axis = 0; axis < 3; ++axis) {
+                    slab(bounds.min[axis], bounds.max[axis], axis, enter, exit);
+                }
+                if (enter <= exit) fn(entity, enter);
+            });
+    }
+
+private:
+    static void forget_entity(void* bvh, uint32_t entity) {
+        static_cast<Bvh*>(bvh)->remove(entity);
+    }
+
+    void mark_dirty(uint32_t leaf) {
+        dirty_leaves_.push_back(leaf);
+    }
+
+    uint32_t best_leaf(const Aabb& bounds) const {
+        if (nodes_.empty()) return bvh_absent;
+        uint32_t index = 0;
+        while (true) {
+            auto& node = nodes_[index];
+            size_t best = bvh_width;
+            float best_growth = std::numeric_limits<float>::infinity();
+            for (size_t lane = 0; lane < bvh_width; ++lane) {
+                if (node.children[lane] == bvh_empty_lane) continue;
+                Aabb grown = node.lane(lane);
+                float before = grown.half_area();
+                grown.expand(bounds);
+                float growth = grown.half_area() - before;
+                if (growth < best_growth) {
+                    best_growth = growth;
+                    best = lane;
+                }
+            }
+            if (best == bvh_width) return bvh_absent;
+            int32_t child = node.children[best];
+            if (child < 0) return uint32_t(-child - 1);
+            index = uint32_t(child);
+        }
+    }
+
+    BvhBuildItem build_item(uint32_t entity) const {
+        auto& bounds = bounds_[entity];
+        return BvhBuildItem{{bounds.center(0), bounds.center(1), bounds.center(2)}, entity};
+    }
+
+    static int longest_axis(const std::vector<BvhBuildItem>& items, size_t begin, size_t end) {
+        Aabb centroids;
+        for (size_t index = begin; index < end; ++index) {
+            centroids.expand(items[index].center);
+        }
+        float extent[3] = {
+            centroids.max[0] - centroids.min[0],
+            centroids.max[1] - centroids.min[1],
+            centroids.max[2] - centroids.min[2]
+        };
+        if (extent[0] >= extent[1] && extent[0] >= extent[2]) return 0;
+        return extent[1] >= extent[2] ? 1 : 2;
+    }
+
+    static size_t split(std::vector<BvhBuildItem>& items, size_t begin, size_t end) {
+        size_t count = end - begin;
+        size_t half = (count / 2 + bvh_leaf_fill - 1) / bvh_leaf_fill * bvh_leaf_fill;
+        size_t middle = begin + std::max(half, bvh_leaf_fill);
+        if (middle >= end) return end;
+        int axis = longest_axis(items, begin, end);
+        std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+            [axis](const BvhBuildItem& left, const BvhBuildItem& right) {
+                return left.center[axis] < right.center[axis];
+            });
+        return middle;
+    }
+
+    std::pair<int32_t, Aabb> build_leaf(const std::vector<BvhBuildItem>& items, size_t begin, size_t end, uint32_t parent, uint32_t lane) {
+        uint32_t leaf = uint32_t(leaves_.size());
+        auto& slots = leaves_.emplace_back();
+        slots.parent = parent;
+        slots.parent_lane = lane;
+        Aabb bounds;
+        for (size_t index = begin; index < end; ++index) {
+            uint32_t entity = items[index].entity;
+            slots.entities[slots.count++] = entity;
+            leaf_of_[entity] = leaf;
+            bounds.expand(bounds_[entity]);
+        }
+        return {-int32_t(leaf) - 1, bounds};
+    }
+
+    std::pair<int32_t, Aabb> build_node(std::vector<BvhBuildItem>& items, size_t begin, size_t end, uint32_t parent, uint32_t lane, size_t depth) {
+        if (end - begin <= bvh_leaf_fill) return build_leaf(items, begin, end, parent, lane);
+        depth_ = std::max(depth_, depth);
+        uint32_t index = uint32_t(nodes_.size());
+        nodes_.emplace_back();
+        nodes_[index].parent = parent;
+        nodes_[index].parent_lane = lane;
+        size_t middle = split(items, begin, end);
+        std::array<size_t, bvh_width + 1> bounds_at = {begin, split(items, begin, middle), middle, split(items, middle, end), end};
+        Aabb all;
+        for (uint32_t child = 0; child < bvh_width; ++child) {
+            if (bounds_at[child] == bounds_at[child + 1]) continue;
+            auto [code, bounds] = build_node(items, bounds_at[child], bounds_at[child + 1], index, child, depth + 1);
+            nodes_[index].children[child] = code;
+            nodes_[index].set_lane(child, bounds);
+            all.expand(bounds);
+        }
+        return {int32_t(index), all};
+    }
+
+    template<typename Emit>
+    void emit_subtree(int32_t child, Emit& emit) const {
+        if (child < 0) {
+            auto& slots = leaves_[size_t(-child - 1)];
+            for (uint32_t index = 0; index < slots.count; ++index) {
+                emit(slots.entities[index]);
+            }
+            return;
+        }
+        auto& node = nodes_[size_t(child)];
+        for (size_t lane = 0; lane < bvh_width; ++lane) {
+            if (node.children[lane] != bvh_empty_lane) emit_subtree(node.children[lane], emit);
+        }
+    }
+
+    template<typename TestNode, typename TestEntity, typename Emit>
+    void traverse(TestNode&& test_node, TestEntity&& test_entity, Emit&& emit) const {
+        if (nodes_.empty()) return;
+        size_t limit = (bvh_width - 1) * depth_ + 1;
+        if (limit <= bvh_inline_stack) {
+            std::array<uint32_t, bvh_inline_stack> stack;
+            walk(stack.data(), test_node, test_entity, emit);
+            return;
+        }
+        std::vector<uint32_t> stack(limit);
+        walk(stack.data(), test_node, test_entity, emit);
+    }
+
+    template<typename TestNode, typename TestEntity, typename Emit>
+    void walk(uint32_t* stack, TestNode& test_node, TestEntity& test_entity, Emit& emit) const {
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            auto& node = nodes_[stack[--top]];
+            bool hit[bvh_width];
+            bool inside[bvh_width] = {false, false, false, false};
+            test_node(node, hit, inside);
+            for (size_t lane = 0; lane < bvh_width; ++lane) {
+                int32_t child = node.children[lane];
+                if (!hit[lane] || child == bvh_empty_lane) continue;
+                if (inside[lane]) {
+                    emit_subtree(child, emit);
+                } else if (child >= 0) {
+                    stack[top++] = uint32_t(child);
+                } else {
+                    auto& slots = leaves_[size_t(-child - 1)];
+                    for (uint32_t index = 0; index < slots.count; ++index) {
+                        uint32_t entity = slots.entities[index];
+                        if (test_entity(bounds_[entity])) emit(entity);
+                    }
+                }
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/ecs/entity_events.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+constexpr uint32_t deferred_entity_bit = uint32_t(1) << 31;
+constexpr uint32_t deferred_serial_mask = deferred_entity_bit - 1;
+
+inline bool is_deferred_entity(uint32_t entity) {
+    return (entity & deferred_entity_bit) != 0;
+}
+
+inline uint32_t deferred_entity(uint64_t serial) {
+    return deferred_entity_bit | uint32_t(serial & deferred_serial_mask);
+}
+
+enum class CommandKind : uint8_t { create, insert, remove, destroy };
+
+struct CommandArena {
+    static constexpr size_t block_size = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::vector<size_t> block_sizes_;
+    size_t block_ = 0;
+    size_t offset_ = 0;
+
+    void* allocate(size_t size, size_t alignment) {
+        while (true) {
+            if (block_ < blocks_.size()) {
+                auto base = reinterpret_cast<uintptr_t>(blocks_[block_].get());
+                size_t aligned = ((base + offset_ + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+                if (aligned + size <= block_sizes_[block_]) {
+                    offset_ = aligned + size;
+                    return blocks_[block_].get() + aligned;
+                }
+                ++block_;
+                offset_ = 0;
+                continue;
+            }
+            size_t capacity = std::max(block_size, size + alignment);
+            blocks_.emplace_back(new std::byte[capacity]);
+            block_sizes_.push_back(capacity);
+        }
+    }
+
+    void reset() {
+        block_ = 0;
+        offset_ = 0;
+    }
+};
+
+struct Command {
+    CommandKind kind;
+    uint32_t entity;
+    void* store;
+    void* payload;
+    void (*apply)(void* store, uint32_t entity, void* payload);
+    void (*discard)(void* payload);
+    void* (*clone)(CommandArena& arena, const void* payload);
+};
+
+template<typename Component>
+void insert_command(void* store, uint32_t entity, void* payload) {
+    auto* component = static_cast<Component*>(payload);
+    static_cast<ComponentStore<Component>*>(store)->insert(entity, std::move(*component));
+    component->~Component();
+}
+
+template<typename Component>
+void remove_command(void* store, uint32_t entity, void*) {
+    static_cast<ComponentStore<Component>*>(store)->remove(entity);
+}
+
+template<typename Component>
+void discard_payload(void* payload) {
+    static_cast<Component*>(payload)->~Component();
+}
+
+template<typename Component>
+void* clone_payload(CommandArena& arena, const void* payload) {
+    void* copy = arena.allocate(sizeof(Component), alignof(Component));
+    new (copy) Component(*static_cast<const Component*>(payload));
+    return copy;
+}
+
+template<typename Component>
+constexpr auto payload_cloner() -> void* (*)(CommandArena&, const void*) {
+    if constexpr (std::is_copy_constructible_v<Component>) {
+        return clone_payload<Component>;
+    } else {
+        return nullptr;
+    }
+}
+
+struct CommandBuffer {
+    std::vector<Command> commands_;
+    CommandArena arena_;
+    std::vector<uint64_t> serials_;
+    std::atomic<uint64_t>* serial_source_ = nullptr;
+    uint64_t next_serial_ = 0;
+    size_t rejected_ = 0;
+
+    uint32_t create() {
+        uint64_t serial = serial_source_ ? serial_source_->fetch_add(1, std::memory_order_relaxed) : next_serial_++;
+        serials_.push_back(serial);
+        uint32_t entity = deferred_entity(serial);
+        commands_.push_back(Command{CommandKind::create, entity, nullptr, nullptr, nullptr, nullptr, nullptr});
+        return entity;
+    }
+
+    std::optional<size_t> deferred_index(uint32_t entity) const {
+        if (serials_.empty()) return std::nullopt;
+        uint64_t first = serials_.front();
+        uint64_t serial = first + ((uint64_t(entity) - first) & deferred_serial_mask);
+        auto found = std::lower_bound(serials_.begin(), serials_.end(), serial);
+        if (found == serials_.end() || *found != serial) return std::nullopt;
+        return size_t(found - serials_.begin());
+    }
+
+    template<typename Component>
+    void insert(ComponentStore<Component>* store, uint32_t entity, Component component) {
+        void* payload = arena_.allocate(sizeof(Component), alignof(Component));
+        new (payload) Component(std::move(component));
+        commands_.push_back(Command{CommandKind::insert, entity, store, payload, insert_command<Component>, discard_payload<Component>, payload_cloner<Component>()});
+    }
+
+    template<typename Component>
+    void remove(ComponentStore<Component>* store, uint32_t entity) {
+        commands_.push_back(Command{CommandKind::remove, entity, store, nullptr, remove_command<Component>, nullptr, nullptr});
+    }
+
+    void destroy(uint32_t entity) {
+        commands_.push_back(Command{CommandKind::destroy, entity, nullptr, nullptr, nullptr, nullptr, nullptr});
+    }
+
+    bool empty() const {
+        return commands_.empty();
+    }
+
+    size_t size() const {
+        return commands_.size();
+    }
+
+    void play(EntityTable& table, EventQueue<DestroyEntity>& destroy_queue, std::vector<uint32_t>& created, StoreGenerations* generations = nullptr) {
+        created.clear();
+        auto resolve = [this, &table, &created](uint32_t entity, uint32_t& resolved) {
+            if (!is_deferred_entity(entity)) {
+                resolved = entity;
+                return table.alive(entity);
+            }
+            auto index = deferred_index(entity);
+            if (!index || *index >= created.size()) return false;
+            resolved = created[*index];
+            return table.alive(resolved);
+        };
+        for (auto& command : commands_) {
+            uint32_t entity = 0;
+            if (command.kind != CommandKind::create && !resolve(command.entity, entity)) {
+                ++rejected_;
+                continue;
+            }
+            switch (command.kind) {
+                case CommandKind::create:
+                    created.push_back(table.create());
+                    break;
+                case CommandKind::insert:
+                case CommandKind::remove:
+                    command.apply(command.store, entity, command.payload);
+                    command.discard = nullptr;
+                    if (generations) generations->touch(command.store, entity);
+                    break;
+                case CommandKind::destroy:
+                    destroy_queue.emit(DestroyEntity{entity});
+                    break;
+            }
+        }
+        clear();
+    }
+
+    void clear() {
+        for (auto& command : commands_) {
+            if (command.discard) command.discard(command.payload);
+        }
+        commands_.clear();
+        arena_.reset();
+        serials_.clear();
+    }
+
+    CommandBuffer() = default;
+
+    CommandBuffer(const CommandBuffer& other) {
+        *this = other;
+    }
+
+    CommandBuffer& operator=(const CommandBuffer& other) {
+        if (this == &other) return *this;
+        clear();
+        commands_.reserve(other.commands_.size());
+        for (auto& command : other.commands_) {
+            if (!command.payload) {
+                commands_.push_back(command);
+                continue;
+            }
+            assert(command.clone);
+            if (!command.clone) continue;
+            auto& copied = commands_.emplace_back(command);
+            copied.payload = command.clone(arena_, command.payload);
+        }
+        serials_ = other.serials_;
+        next_serial_ = other.next_serial_;
+        rejected_ = other.rejected_;
+        return *this;
+    }
+
+    ~CommandBuffer() {
+        clear();
+    }
+};
+
+struct CommandBuffers {
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<CommandBuffer>> buffers_;
+    std::vector<uint32_t> created_;
+    std::atomic<uint64_t> serials_{0};
+    size_t commands_played_ = 0;
+    size_t commands_rejected_ = 0;
+
+    CommandBuffers() = default;
+
+    CommandBuffers& operator=(const CommandBuffers& other) {
+        if (this == &other) return *this;
+        std::scoped_lock lock(mutex_, other.mutex_);
+        buffers_.resize(other.buffers_.size());
+        for (size_t slot = 0; slot < buffers_.size(); ++slot) {
+            if (!buffers_[slot]) buffers_[slot] = std::make_unique<CommandBuffer>();
+            *buffers_[slot] = *other.buffers_[slot];
+        }
+        commands_played_ = other.commands_played_;
+        commands_rejected_ = other.commands_rejected_;
+        return *this;
+    }
+
+    void reserve(size_t slots) {
+        std::lock_guard lock(mutex_);
+        while (buffers_.size() < slots) {
+            buffers_.push_back(std::make_unique<CommandBuffer>());
+            buffers_.back()->serial_source_ = &serials_;
+        }
+    }
+
+    CommandBuffer& at(size_t slot) {
+        reserve(slot + 1);
+        std::lock_guard lock(mutex_);
+        return *buffers_[slot];
+    }
+
+    size_t pending() {
+        std::lock_guard lock(mutex_);
+        size_t count = 0;
+        for (auto& buffer : buffers_) {
+            count += buffer->size();
+        }
+        return count;
+    }
+
+    void play(EntityTable& table, EventQueue<DestroyEntity>& destroy_queue, StoreGenerations* generations = nullptr) {
+        std::lock_guard lock(mutex_);
+        for (auto& buffer : buffers_) {
+            commands_played_ += buffer->size();
+            size_t rejected = buffer->rejected_;
+            buffer->play(table, destroy_queue, created_, generations);
+            commands_rejected_ += buffer->rejected_ - rejected;
+        }
+    }
+};
+
+}
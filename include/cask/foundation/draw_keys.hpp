@@ -0,0 +1,313 @@
+#pragma once
+
+#include <cask/ecs/component_store.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/foundation/worker_pool.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/texture_data.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace cask {
+
+struct DrawKey {
+    uint64_t key;
+    uint32_t entity;
+};
+
+constexpr uint64_t draw_key_field_mask = (uint64_t(1) << 24) - 1;
+
+inline bool draw_key_fits(uint32_t id) {
+    return id <= draw_key_field_mask;
+}
+
+inline uint64_t make_draw_key(uint16_t layer, uint32_t texture, uint32_t mesh) {
+    assert(draw_key_fits(texture) && draw_key_fits(mesh));
+    return (uint64_t(layer) << 48) | (uint64_t(texture) << 24) | uint64_t(mesh);
+}
+
+inline uint16_t draw_key_layer(uint64_t key) {
+    return uint16_t(key >> 48);
+}
+
+inline uint32_t draw_key_texture(uint64_t key) {
+    return uint32_t((key >> 24) & draw_key_field_mask);
+}
+
+inline uint32_t draw_key_mesh(uint64_t key) {
+    return uint32_t(key & draw_key_field_mask);
+}
+
+struct RadixSorter {
+    static constexpr size_t radix = 256;
+    static constexpr size_t passes = 8;
+    static constexpr size_t parallel_threshold = 1 << 16;
+
+    using Histogram = std::array<std::array<size_t, radix>, passes>;
+
+    std::vector<DrawKey> scratch_;
+    std::vector<Histogram> counts_;
+    std::unique_ptr<WorkerPool> pool_;
+
+    void sort(std::vector<DrawKey>& keys, size_t workers) {
+        size_t size = keys.size();
+        if (size < 2) return;
+        workers = size < parallel_threshold ? 1 : std::max<size_t>(1, workers);
+        scratch_.resize(size);
+        counts_.resize(workers);
+        size_t chunk = (size + workers - 1) / workers;
+        DrawKey* source = keys.data();
+        DrawKey* target = scratch_.data();
+        run(workers, [&](size_t worker) {
+            auto& count = counts_[worker];
+            for (auto& digits : count) {
+                digits.fill(0);
+            }
+            size_t end = std::min(size, (worker + 1) * chunk);
+            for (size_t index = worker * chunk; index < end; ++index) {
+                uint64_t key = source[index].key;
+                for (size_t pass = 0; pass < passes; ++pass) {
+                    ++count[pass][(key >> (pass * 8)) & (radix - 1)];
+                }
+            }
+        });
+        bool counted = true;
+        for (size_t pass = 0; pass < passes; ++pass) {
+            size_t shift = pass * 8;
+            if (uniform(pass, size)) continue;
+            if (!counted) {
+                run(workers, [&](size_t worker) {
+                    auto& count = counts_[worker][pass];
+                    count.fill(0);
+                    size_t end = std::min(size, (worker + 1) * chunk);
+                    for (size_t index = worker * chunk; index < end; ++index) {
+                        ++count[(source[index].key >> shift) & (radix - 1)];
+                    }
+                });
+            }
+            size_t offset = 0;
+            for (size_t digit = 0; digit < radix; ++digit) {
+                for (size_t worker = 0; worker < workers; ++worker) {
+                    size_t count = counts_[worker][pass][digit];
+                    counts_[worker][pass][digit] = offset;
+                    offset += count;
+                }
+            }
+            run(workers, [&](size_t worker) {
+                auto& next = counts_[worker][pass];
+                size_t end = std::min(size, (worker + 1) * chunk);
+                for (size_t index = worker * chunk; index < end; ++index) {
+                    target[next[(source[index].key >> shift) & (radix - 1)]++] = source[index];
+                }
+            });
+            std::swap(source, target);
+            counted = workers == 1;
+        }
+        if (source != keys.data()) std::copy(source, source + size, keys.data());
+    }
+
+private:
+    bool uniform(size_t pass, size_t size) const {
+        for (size_t digit = 0; digit < radix; ++digit) {
+            size_t total = 0;
+            for (auto& count : counts_) {
+                total += count[pass][digit];
+            }
+            if (total == size) return true;
+            if (total != 0) return false;
+        }
+        return false;
+    }
+
+    template<typename Fn>
+    void run(size_t workers, Fn&& fn) {
+        if (workers == 1) {
+            fn(0);
+            return;
+        }
+        if (!pool_) pool_ = std::make_unique<WorkerPool>();
+        pool_->run(workers, fn);
+    }
+};
+
+struct DrawKeys {
+    static constexpr uint32_t untextured = uint32_t(draw_key_field_mask);
+    static constexpr size_t full_sort_divisor = 8;
+
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t frame = 0;
+        bool rejected = false;
+    };
+
+    ComponentStore<MeshHandle>* meshes_ = nullptr;
+    ComponentStore<TextureHandle>* textures_ = nullptr;
+    EntityWatch watch_;
+    const WriteGeneration* mesh_writes_ = nullptr;
+    const WriteGeneration* texture_writes_ = nullptr;
+    uint64_t seen_mesh_writes_ = 0;
+    uint64_t seen_texture_writes_ = 0;
+    size_t seen_meshes_ = 0;
+    size_t seen_textures_ = 0;
+    bool dirty_ = true;
+    std::function<uint16_t(uint32_t)> layer_;
+    size_t workers_ = std::thread::hardware_concurrency();
+
+    std::vector<DrawKey> keys_;
+    std::vector<DrawKey> changed_;
+    std::vector<DrawKey> merged_;
+    std::vector<Entry> entries_;
+    std::vector<bool> unchanged_;
+    uint32_t frame_ = 1;
+    RadixSorter sorter_;
+    size_t full_sorts_ = 0;
+    size_t patches_ = 0;
+    size_t scans_ = 0;
+    std::vector<uint32_t> rejected_;
+    size_t rejected_ids_ = 0;
+
+    std::span<const DrawKey> keys() const {
+        return keys_;
+    }
+
+    DrawKeys& watch(EntityWatchers& watchers) {
+        watch_ = EntityWatch(watchers, this, drop_entity, drop_entity);
+        dirty_ = true;
+        return *this;
+    }
+
+    void unwatch() {
+        watch_.reset();
+    }
+
+    DrawKeys& track(StoreGenerations& generations) {
+        mesh_writes_ = generations.track(meshes_);
+        texture_writes_ = textures_ ? generations.track(textures_) : nullptr;
+        dirty_ = true;
+        return *this;
+    }
+
+    uint64_t key_for(uint32_t entity, MeshHandle mesh) const {
+        bool fits = true;
+        return key_for(entity, mesh, fits);
+    }
+
+    uint64_t key_for(uint32_t entity, MeshHandle mesh, bool& fits) const {
+        bool textured = textures_ && textures_->has(entity);
+        uint32_t texture = textured ? textures_->get(entity).id : untextured;
+        fits = draw_key_fits(mesh.id) && (!textured || texture < untextured);
+        if (!fits) return 0;
+        uint16_t layer = layer_ ? layer_(entity) : 0;
+        return make_draw_key(layer, texture, mesh.id);
+    }
+
+    void build() {
+        if (!meshes_ || !stale()) return;
+        ++frame_;
+        ++scans_;
+        changed_.clear();
+        rejected_.clear();
+        std::fill(unchanged_.begin(), unchanged_.end(), false);
+        const auto& entities = meshes_->entities_;
+        size_t live = 0;
+        for (size_t index = 0; index < entities.size(); ++index) {
+            uint32_t entity = entities[index];
+            if (watch_.retiring(entity)) continue;
+            bool fits = true;
+            uint64_t key = key_for(entity, meshes_->components_[index], fits);
+            if (entity >= entries_.size()) {
+                entries_.resize(size_t(entity) + 1);
+                unchanged_.resize(size_t(entity) + 1);
+            }
+            auto& entry = entries_[entity];
+            bool kept = entry.frame == frame_ - 1;
+            if (!fits) {
+                if (!kept || !entry.rejected) ++rejected_ids_;
+                rejected_.push_back(entity);
+                entry = Entry{0, frame_, true};
+                continue;
+            }
+            ++live;
+            if (kept && !entry.rejected && entry.key == key) {
+                unchanged_[entity] = true;
+            } else {
+                changed_.push_back(DrawKey{key, entity});
+            }
+            entry = Entry{key, frame_, false};
+        }
+        remember();
+        if (changed_.empty() && keys_.size() == live) return;
+        if (changed_.size() * full_sort_divisor > live) {
+            rebuild_all();
+        } else {
+            patch();
+        }
+    }
+
+    void invalidate() {
+        std::fill(entries_.begin(), entries_.end(), Entry{});
+        dirty_ = true;
+    }
+
+private:
+    bool stale() const {
+        if (dirty_ || !mesh_writes_ || (textures_ && !texture_writes_)) return true;
+        if (meshes_->entities_.size() != seen_meshes_ || mesh_writes_->value_ != seen_mesh_writes_) return true;
+        return textures_ && (textures_->entities_.size() != seen_textures_ || texture_writes_->value_ != seen_texture_writes_);
+    }
+
+    void remember() {
+        seen_meshes_ = meshes_->entities_.size();
+        seen_mesh_writes_ = mesh_writes_ ? mesh_writes_->value_ : 0;
+        seen_textures_ = textures_ ? textures_->entities_.size() : 0;
+        seen_texture_writes_ = texture_writes_ ? texture_writes_->value_ : 0;
+        dirty_ = false;
+    }
+
+    void drop(uint32_t entity) {
+        if (entity < entries_.size() && entries_[entity].frame == frame_) dirty_ = true;
+    }
+
+    static void drop_entity(void* keys, uint32_t entity) {
+        static_cast<DrawKeys*>(keys)->drop(entity);
+    }
+
+    void rebuild_all() {
+        keys_.clear();
+        for (uint32_t entity : meshes_->entities_) {
+            if (entity >= entries_.size()) continue;
+            const auto& entry = entries_[entity];
+            if (entry.frame == frame_ && !entry.rejected) keys_.push_back(DrawKey{entry.key, entity});
+        }
+        sorter_.sort(keys_, workers_);
+        ++full_sorts_;
+    }
+
+    void patch() {
+        sorter_.sort(changed_, 1);
+        merged_.clear();
+        merged_.reserve(meshes_->entities_.size());
+        auto added = changed_.begin();
+        for (auto& key : keys_) {
+            if (!unchanged_[key.entity]) continue;
+            for (; added != changed_.end() && added->key < key.key; ++added) {
+                merged_.push_back(*added);
+            }
+            merged_.push_back(key);
+        }
+        merged_.insert(merged_.end(), added, changed_.end());
+        keys_.swap(merged_);
+        ++patches_;
+    }
+};
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cask/ecs/entity_compactor.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct EntityWatcher {
+    void* watcher;
+    void (*forget)(void* watcher, uint32_t entity);
+    void (*retire)(void* watcher, uint32_t entity);
+};
+
+struct EntityWatchers {
+    using ForgetFn = void (*)(void* watcher, uint32_t entity);
+
+    std::vector<EntityWatcher> watchers_;
+    const AmortizedCompactor* amortized_ = nullptr;
+
+    void attach(EntityCompactor& compactor) {
+        compactor.add(this, forget_entity);
+    }
+
+    void attach(AmortizedCompactor& amortized) {
+        amortized_ = &amortized;
+        amortized.observe(this, retire_entity);
+    }
+
+    void add(void* watcher, ForgetFn forget, ForgetFn retire = nullptr) {
+        watchers_.push_back(EntityWatcher{watcher, forget, retire});
+    }
+
+    void remove(const void* watcher) {
+        std::erase_if(watchers_, [watcher](const EntityWatcher& entry) { return entry.watcher == watcher; });
+    }
+
+    size_t size() const {
+        return watchers_.size();
+    }
+
+    bool retiring(uint32_t entity) const {
+        return amortized_ && amortized_->retiring(entity);
+    }
+
+    static void forget_entity(void* watchers, uint32_t entity) {
+        for (auto& entry : static_cast<EntityWatchers*>(watchers)->watchers_) {
+            entry.forget(entry.watcher, entity);
+        }
+    }
+
+    static void retire_entity(void* watchers, uint32_t entity) {
+        for (auto& entry : static_cast<EntityWatchers*>(watchers)->watchers_) {
+            if (entry.retire) entry.retire(entry.watcher, entity);
+        }
+    }
+};
+
+struct EntityWatch {
+    EntityWatchers* watchers_ = nullptr;
+    const void* watcher_ = nullptr;
+
+    EntityWatch() = default;
+
+    EntityWatch(EntityWatchers& watchers, void* watcher, EntityWatchers::ForgetFn forget, EntityWatchers::ForgetFn retire = nullptr)
+        : watchers_(&watchers)
+        , watcher_(watcher) {
+        watchers.add(watcher, forget, retire);
+    }
+
+    EntityWatch(EntityWatch&& other) noexcept
+        : watchers_(std::exchange(other.watchers_, nullptr))
+        , watcher_(std::exchange(other.watcher_, nullptr)) {}
+
+    EntityWatch& operator=(EntityWatch&& other) noexcept {
+        if (this == &other) return *this;
+        reset();
+        watchers_ = std::exchange(other.watchers_, nullptr);
+        watcher_ = std::exchange(other.watcher_, nullptr);
+        return *this;
+    }
+
+    EntityWatch(const EntityWatch&) = delete;
+    EntityWatch& operator=(const EntityWatch&) = delete;
+
+    ~EntityWatch() {
+        reset();
+    }
+
+    bool active() const {
+        return watchers_ != nullptr;
+    }
+
+    bool retiring(uint32_t entity) const {
+        return watchers_ && watchers_->retiring(entity);
+    }
+
+    void reset() {
+        if (watchers_) watchers_->remove(watcher_);
+        watchers_ = nullptr;
+        watcher_ = nullptr;
+    }
+};
+
+}
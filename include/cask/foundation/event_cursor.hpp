@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cask/world.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct SwapGeneration {
+    uint64_t value_ = 0;
+};
+
+inline void advance_generation(void* generation) {
+    ++static_cast<SwapGeneration*>(generation)->value_;
+}
+
+struct EventGenerations {
+    std::vector<std::pair<const void*, std::unique_ptr<SwapGeneration>>> generations_;
+
+    SwapGeneration* add(const void* queue) {
+        if (auto* existing = find(queue)) return existing;
+        generations_.emplace_back(queue, std::make_unique<SwapGeneration>());
+        return generations_.back().second.get();
+    }
+
+    SwapGeneration* find(const void* queue) const {
+        for (auto& [tracked, generation] : generations_) {
+            if (tracked == queue) return generation.get();
+        }
+        return nullptr;
+    }
+};
+
+template<typename Event>
+struct EventCursor {
+    EventQueue<Event>* queue_ = nullptr;
+    const SwapGeneration* generation_ = nullptr;
+    uint64_t seen_ = 0;
+    size_t missed_ = 0;
+    bool strict_ = true;
+
+    EventCursor() = default;
+
+    EventCursor(EventQueue<Event>* queue, const SwapGeneration* generation)
+        : queue_(queue)
+        , generation_(generation)
+        , seen_(generation ? generation->value_ : 0) {}
+
+    std::span<const Event> read() {
+        if (!queue_) return {};
+        if (generation_) {
+            uint64_t current = generation_->value_;
+            if (current == seen_) return {};
+            missed_ += current - seen_ - 1;
+            assert(!strict_ || current == seen_ + 1);
+            seen_ = current;
+        }
+        const auto& events = queue_->poll();
+        return std::span<const Event>(events.data(), events.size());
+    }
+
+    bool pending() const {
+        return generation_ && generation_->value_ != seen_;
+    }
+
+    size_t missed() const {
+        return missed_;
+    }
+};
+
+template<typename Event>
+EventCursor<Event> event_cursor(WorldView& world, EventQueue<Event>* queue) {
+    auto* generations = world.resolve<EventGenerations>("EventGenerations");
+    return EventCursor<Event>(queue, generations ? generations->find(queue) : nullptr);
+}
+
+}
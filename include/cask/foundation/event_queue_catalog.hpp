@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cask/event/event_queue.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cask {
+
+template<typename Event>
+size_t queue_delivered(void* queue) {
+    return static_cast<EventQueue<Event>*>(queue)->poll().size();
+}
+
+struct CatalogedQueue {
+    std::string name;
+    void* queue;
+    size_t (*delivered)(void*);
+};
+
+struct EventQueueCatalog {
+    std::vector<CatalogedQueue> queues_;
+
+    template<typename Event>
+    void add(const char* name, EventQueue<Event>* queue) {
+        queues_.push_back(CatalogedQueue{name, queue, queue_delivered<Event>});
+    }
+
+    void remove(const void* queue) {
+        std::erase_if(queues_, [queue](const CatalogedQueue& entry) { return entry.queue == queue; });
+    }
+};
+
+}
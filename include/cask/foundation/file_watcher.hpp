@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace cask {
+
+struct FileWatcher {
+    int descriptor_ = -1;
+    std::unordered_map<int, std::string> directories_;
+    std::unordered_map<std::string, int> watches_;
+    bool structure_events_ = false;
+    bool overflowed_ = false;
+
+    FileWatcher() {
+#ifdef __linux__
+        descriptor_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    ~FileWatcher() {
+#ifdef __linux__
+        if (descriptor_ >= 0) close(descriptor_);
+#endif
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool available() const {
+        return descriptor_ >= 0;
+    }
+
+    bool watching(const std::string& relative_directory) const {
+        return watches_.count(relative_directory) > 0;
+    }
+
+    bool watch(const std::string& root, const std::string& relative_directory) {
+        if (descriptor_ < 0) return false;
+        if (watching(relative_directory)) return true;
+#ifdef __linux__
+        std::string absolute = relative_directory.empty() ? root : root + "/" + relative_directory;
+        uint32_t events = IN_CLOSE_WRITE | IN_MOVED_TO;
+        if (structure_events_) events |= IN_CREATE | IN_DELETE | IN_MOVED_FROM;
+        int watch_id = inotify_add_watch(descriptor_, absolute.c_str(), events);
+        if (watch_id < 0) return false;
+        directories_[watch_id] = relative_directory;
+        watches_[relative_directory] = watch_id;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void forget(const std::string& relative_directory) {
+        auto watch = watches_.find(relative_directory);
+        if (watch == watches_.end()) return;
+#ifdef __linux__
+        inotify_rm_watch(descriptor_, watch->second);
+#endif
+        directories_.erase(watch->second);
+        watches_.erase(watch);
+    }
+
+    void poll(std::vector<std::string>& changed) {
+        if (descriptor_ < 0) return;
+#ifdef __linux__
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            ssize_t length = read(descriptor_, buffer, sizeof(buffer));
+            if (length <= 0) return;
+            for (ssize_t offset = 0; offset < length;) {
+                auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += ssize_t(sizeof(inotify_event) + event->len);
+                if (event->mask & IN_Q_OVERFLOW) overflowed_ = true;
+                auto directory = directories_.find(event->wd);
+                if (directory == directories_.end() || event->len == 0) continue;
+                std::string name(event->name);
+                changed.push_back(directory->second.empty() ? name : directory->second + "/" + name);
+            }
+        }
+#endif
+    }
+};
+
+struct ChangeDebouncer {
+    using Clock = std::chrono::steady_clock;
+
+    std::unordered_map<std::string, Clock::time_point> pending_;
+
+    void note(const std::string& path, Clock::time_point now) {
+        pending_[path] = now;
+    }
+
+    void settled(Clock::time_point now, Clock::duration quiet_period, std::vector<std::string>& ready) {
+        for (auto entry = pending_.begin(); entry != pending_.end();) {
+            if (now - entry->second < quiet_period) {
+                ++entry;
+                continue;
+            }
+            ready.push_back(entry->first);
+            entry = pending_.erase(entry);
+        }
+    }
+};
+
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cask/abi.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cask {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+};
+
+struct TraceBuffer {
+    static constexpr size_t capacity = size_t(1) << 15;
+
+    std::vector<TraceEvent> events_ = std::vector<TraceEvent>(capacity);
+    uint64_t head_ = 0;
+    std::mutex mutex_;
+    uint32_t thread_id_ = 0;
+    std::thread::id owner_;
+
+    void push(const TraceEvent& event) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_[head_ & (capacity - 1)] = event;
+        ++head_;
+    }
+
+    size_t recorded() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_t(std::min<uint64_t>(head_, capacity));
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        head_ = 0;
+    }
+
+    void copy_recorded(std::vector<TraceEvent>& events) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t count = std::min<uint64_t>(head_, capacity);
+        events.clear();
+        for (uint64_t index = head_ - count; index < head_; ++index) {
+            events.push_back(events_[index & (capacity - 1)]);
+        }
+    }
+};
+
+inline uint64_t trace_clock_ns() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline uint64_t next_profiler_id() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+struct FrameProfiler {
+    std::atomic<bool> enabled_{true};
+    uint64_t id_ = next_profiler_id();
+    uint64_t origin_ns_ = trace_clock_ns();
+    std::mutex buffers_mutex_;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+
+    bool enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    static constexpr size_t cached_profilers = 8;
+
+    TraceBuffer* thread_buffer() {
+        struct CachedBuffer {
+            uint64_t owner = 0;
+            TraceBuffer* buffer = nullptr;
+        };
+        thread_local std::vector<CachedBuffer> cached;
+        for (size_t index = 0; index < cached.size(); ++index) {
+            if (cached[index].owner != id_) continue;
+            std::rotate(cached.begin(), cached.begin() + index, cached.begin() + index + 1);
+            return cached.front().buffer;
+        }
+
+        TraceBuffer* found = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(buffers_mutex_);
+            for (auto& buffer : buffers_) {
+                if (buffer->owner_ == std::this_thread::get_id()) found = buffer.get();
+            }
+            if (!found) {
+                buffers_.push_back(std::make_unique<TraceBuffer>());
+                buffers_.back()->thread_id_ = uint32_t(buffers_.size());
+                buffers_.back()->owner_ = std::this_thread::get_id();
+                found = buffers_.back().get();
+            }
+        }
+        if (cached.size() == cached_profilers) cached.pop_back();
+        cached.insert(cached.begin(), CachedBuffer{id_, found});
+        return found;
+    }
+
+    void record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+        thread_buffer()->push(TraceEvent{name, start_ns, end_ns - start_ns});
+    }
+
+    size_t event_count() {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        size_t count = 0;
+        for (auto& buffer : buffers_) {
+            count += buffer->recorded();
+        }
+        return count;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        for (auto& buffer : buffers_) {
+            buffer->clear();
+        }
+    }
+
+    void write_chrome_trace(std::ostream& output) {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        std::vector<TraceEvent> events;
+        for (auto& buffer : buffers_) {
+            buffer->copy_recorded(events);
+            for (const TraceEvent& event : events) {
+                if (!first) output << ",";
+                first = false;
+                output << "{\"name\":\"";
+                write_escaped(output, event.name);
+                output << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id_
+                       << ",\"ts\":" << double(event.start_ns - origin_ns_) / 1000.0
+                       << ",\"dur\":" << double(event.duration_ns) / 1000.0 << "}";
+            }
+        }
+        output << "]}";
+    }
+
+    bool write_chrome_trace(const std::string& path) {
+        std::ofstream output(path, std::ios::trunc);
+        if (!output) return false;
+        write_chrome_trace(output);
+        return bool(output);
+    }
+
+private:
+    static void write_escaped(std::ostream& output, const char* text) {
+        for (const char* character = text; *character; ++character) {
+            if (*character == '"' || *character == '\\') output << '\\';
+            output << *character;
+        }
+    }
+};
+
+struct ProfilerBinding {
+    FrameProfiler* profiler_ = nullptr;
+    bool bound_ = false;
+
+    FrameProfiler* resolve(WorldHandle handle) {
+        if (bound_) return profiler_;
+        bound_ = true;
+        profiler_ = static_cast<FrameProfiler*>(world_resolve_component(handle, "FrameProfiler"));
+        return profiler_;
+    }
+};
+
+struct TraceScope {
+    FrameProfiler* profiler_;
+    const char* name_;
+    uint64_t start_ns_ = 0;
+
+    TraceScope(FrameProfiler* profiler, const char* name)
+        : profiler_(profiler && profiler->enabled() ? profiler : nullptr)
+        , name_(name) {
+        if (profiler_) start_ns_ = trace_clock_ns();
+    }
+
+    ~TraceScope() {
+        if (profiler_) profiler_->record(name_, start_ns_, trace_clock_ns());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+}
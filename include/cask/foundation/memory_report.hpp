@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/resource/resource_store.hpp>
+#include <cask/identity/entity_registry.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cask {
+
+struct MemoryUsage {
+    size_t used = 0;
+    size_t reserved = 0;
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        used += other.used;
+        reserved += other.reserved;
+        return *this;
+    }
+};
+
+template<typename Container>
+MemoryUsage container_memory(const Container& container) {
+    using Value = typename Container::value_type;
+    if constexpr (requires { container.capacity(); }) {
+        return MemoryUsage{container.size() * sizeof(Value), container.capacity() * sizeof(Value)};
+    } else if constexpr (requires { container.bucket_count(); }) {
+        constexpr size_t node_bytes = sizeof(Value) + 2 * sizeof(void*);
+        return MemoryUsage{container.size() * node_bytes, container.size() * node_bytes + container.bucket_count() * sizeof(void*)};
+    } else {
+        return MemoryUsage{container.size() * sizeof(Value), container.size() * sizeof(Value)};
+    }
+}
+
+template<typename T>
+MemoryUsage measure_memory(const T&) {
+    return MemoryUsage{sizeof(T), sizeof(T)};
+}
+
+template<typename Component>
+MemoryUsage measure_memory(const ComponentStore<Component>& store) {
+    MemoryUsage usage{sizeof(store), sizeof(store)};
+    usage += container_memory(store.components_);
+    usage += container_memory(store.entities_);
+    usage += container_memory(store.sparse_);
+    return usage;
+}
+
+template<typename Event>
+MemoryUsage measure_memory(const EventQueue<Event>& queue) {
+    MemoryUsage usage{sizeof(queue), sizeof(queue)};
+    usage += container_memory(queue.front_);
+    usage += container_memory(queue.back_);
+    return usage;
+}
+
+template<typename Resource>
+MemoryUsage measure_memory(const ResourceStore<Resource>& store) {
+    MemoryUsage usage{sizeof(store), sizeof(store)};
+    usage += container_memory(store.resources_);
+    usage += container_memory(store.key_to_handle_);
+    return usage;
+}
+
+inline MemoryUsage measure_memory(const EntityRegistry& registry) {
+    constexpr size_t mapping_bytes = 2 * (sizeof(uint32_t) + 16 + 2 * sizeof(void*));
+    return MemoryUsage{sizeof(registry) + registry.size() * mapping_bytes, sizeof(registry) + registry.size() * mapping_bytes};
+}
+
+struct MemoryEntry {
+    using MeasureFn = MemoryUsage(*)(const void*);
+
+    std::string name;
+    const void* component;
+    MeasureFn measure;
+};
+
+template<typename T>
+MemoryUsage measure_erased(const void* component) {
+    return measure_memory(*static_cast<const T*>(component));
+}
+
+struct MemoryReport {
+    std::vector<MemoryEntry> entries_;
+
+    template<typename T>
+    void track(const char* name, const T* component) {
+        entries_.push_back(MemoryEntry{name, component, measure_erased<T>});
+    }
+
+    void untrack(const void* component) {
+        std::erase_if(entries_, [component](const MemoryEntry& entry) { return entry.component == component; });
+    }
+
+    void forget(const std::string& name) {
+        std::erase_if(entries_, [&name](const MemoryEntry& entry) { return entry.name == name; });
+    }
+
+    MemoryUsage measure(const std::string& name) const {
+        for (auto& entry : entries_) {
+            if (entry.name == name) return entry.measure(entry.component);
+        }
+        return MemoryUsage{};
+    }
+
+    std::vector<std::pair<std::string, MemoryUsage>> snapshot() const {
+        std::vector<std::pair<std::string, MemoryUsage>> rows;
+        rows.reserve(entries_.size());
+        for (auto& entry : entries_) {
+            rows.emplace_back(entry.name, entry.measure(entry.component));
+        }
+        return rows;
+    }
+
+    MemoryUsage total() const {
+        MemoryUsage usage;
+        for (auto& entry : entries_) {
+            usage += entry.measure(entry.component);
+        }
+        return usage;
+    }
+
+    std::string describe() const {
+        std::string text;
+        MemoryUsage sum;
+        for (auto& [name, usage] : snapshot()) {
+            text += name + ": " + std::to_string(usage.used) + " used, " + std::to_string(usage.reserved) + " reserved\n";
+            sum += usage;
+        }
+        text += "total: " + std::to_string(sum.used) + " used, " + std::to_string(sum.reserved) + " reserved\n";
+        return text;
+    }
+};
+
+template<typename T>
+void track_memory(WorldView& world, const char* name, const T* component) {
+    auto* report = world.resolve<MemoryReport>("MemoryReport");
+    if (!report) return;
+    report->track(name, component);
+}
+
+template<typename T>
+void track_memory(WorldHandle handle, const char* name, const T* component) {
+    auto* report = static_cast<MemoryReport*>(world_resolve_component(handle, "MemoryReport"));
+    if (!report) return;
+    report->track(name, component);
+}
+
+inline void untrack_memory(WorldHandle handle, const char* name) {
+    auto* report = static_cast<MemoryReport*>(world_resolve_component(handle, "MemoryReport"));
+    if (!report) return;
+    report->forget(name);
+}
+
+}
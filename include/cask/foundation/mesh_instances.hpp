@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cask/ecs/component_store.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace cask {
+
+struct MeshInstances {
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    ComponentStore<MeshHandle>* meshes_ = nullptr;
+    std::vector<std::vector<uint32_t>> batches_;
+    std::vector<uint32_t> mesh_of_;
+    std::vector<uint32_t> slot_of_;
+    EntityWatch watch_;
+    StoreGenerations* generations_ = nullptr;
+    size_t indexed_ = 0;
+    size_t expected_ = 0;
+    bool dirty_ = true;
+    size_t rebuilds_ = 0;
+
+    MeshInstances& watch(ComponentStore<MeshHandle>* meshes, EntityWatchers& watchers) {
+        meshes_ = meshes;
+        watch_ = EntityWatch(watchers, this, forget_entity, retire_entity);
+        rebuild();
+        return *this;
+    }
+
+    void unwatch() {
+        watch_.reset();
+        untrack();
+    }
+
+    MeshInstances& track(StoreGenerations& generations) {
+        untrack();
+        generations_ = &generations;
+        generations.observe(meshes_, this, written_entity);
+        return *this;
+    }
+
+    void untrack() {
+        if (generations_) generations_->unobserve(meshes_, this);
+        generations_ = nullptr;
+    }
+
+    void invalidate() {
+        dirty_ = true;
+    }
+
+    void assign(uint32_t entity, MeshHandle mesh) {
+        bool tracked = !stale();
+        bool added = !meshes_->has(entity);
+        meshes_->insert(entity, mesh);
+        if (!tracked) return;
+        if (added) ++expected_;
+        if (watch_.retiring(entity)) return;
+        if (indexed(entity)) {
+            if (mesh_of_[entity] == mesh.id) return;
+            unlink(entity);
+        }
+        link(entity, mesh.id);
+    }
+
+    void remove(uint32_t entity) {
+        bool tracked = !stale();
+        bool present = meshes_->has(entity);
+        meshes_->remove(entity);
+        if (!tracked) return;
+        if (present) --expected_;
+        if (indexed(entity)) unlink(entity);
+    }
+
+    std::span<const uint32_t> instances(MeshHandle mesh) {
+        sync();
+        if (mesh.id >= batches_.size()) return {};
+        return batches_[mesh.id];
+    }
+
+    size_t size() {
+        sync();
+        return indexed_;
+    }
+
+    template<typename Fn>
+    void each_batch(Fn&& fn) {
+        sync();
+        for (uint32_t mesh = 0; mesh < batches_.size(); ++mesh) {
+            if (!batches_[mesh].empty()) fn(MeshHandle{mesh}, std::span<const uint32_t>(batches_[mesh]));
+        }
+    }
+
+private:
+    bool stale() const {
+        return dirty_ || meshes_->entities_.size() != expected_;
+    }
+
+    bool indexed(uint32_t entity) const {
+        return entity < mesh_of_.size() && mesh_of_[entity] != none;
+    }
+
+    void sync() {
+        if (stale()) rebuild();
+    }
+
+    void rebuild() {
+        for (auto& batch : batches_) {
+            batch.clear();
+        }
+        std::fill(mesh_of_.begin(), mesh_of_.end(), none);
+        indexed_ = 0;
+        for (size_t index = 0; index < meshes_->entities_.size(); ++index) {
+            if (watch_.retiring(meshes_->entities_[index])) continue;
+            link(meshes_->entities_[index], meshes_->components_[index].id);
+        }
+        expected_ = meshes_->entities_.size();
+        dirty_ = false;
+        ++rebuilds_;
+    }
+
+    void link(uint32_t entity, uint32_t mesh) {
+        if (mesh >= batches_.size()) batches_.resize(size_t(mesh) + 1);
+        if (entity >= mesh_of_.size()) {
+            mesh_of_.resize(size_t(entity) + 1, none);
+            slot_of_.resize(size_t(entity) + 1);
+        }
+        auto& batch = batches_[mesh];
+        mesh_of_[entity] = mesh;
+        slot_of_[entity] = uint32_t(batch.size());
+        batch.push_back(entity);
+        ++indexed_;
+    }
+
+    void unlink(uint32_t entity) {
+        auto& batch = batches_[mesh_of_[entity]];
+        uint32_t slot = slot_of_[entity];
+        uint32_t moved = batch.back();
+        batch[slot] = moved;
+        slot_of_[moved] = slot;
+        batch.pop_back();
+        mesh_of_[entity] = none;
+        --indexed_;
+    }
+
+    void forget(uint32_t entity) {
+        if (dirty_) return;
+        if (!indexed(entity)) {
+            if (meshes_->has(entity)) --expected_;
+            return;
+        }
+        --expected_;
+        unlink(entity);
+    }
+
+    void written(uint32_t entity) {
+        if (dirty_) return;
+        if (entity == StoreGenerations::all_entities || watch_.retiring(entity)) {
+            dirty_ = true;
+            return;
+        }
+        bool present = meshes_->has(entity);
+        if (present && !indexed(entity)) ++expected_;
+        if (!present && indexed(entity)) --expected_;
+        if (!present) {
+            if (indexed(entity)) unlink(entity);
+            return;
+        }
+        uint32_t mesh = meshes_->get(entity).id;
+        if (indexed(entity)) {
+            if (mesh_of_[entity] == mesh) return;
+            unlink(entity);
+        }
+        link(entity, mesh);
+    }
+
+    void retire(uint32_t entity) {
+        if (dirty_ || !indexed(entity)) return;
+        unlink(entity);
+    }
+
+    static void forget_entity(void* instances, uint32_t entity) {
+        static_cast<MeshInstances*>(instances)->forget(entity);
+    }
+
+    static void written_entity(void* instances, uint32_t entity) {
+        static_cast<MeshInstances*>(instances)->written(entity);
+    }
+
+    static void retire_entity(void* instances, uint32_t entity) {
+        static_cast<MeshInstances*>(instances)->retire(entity);
+    }
+};
+
+}
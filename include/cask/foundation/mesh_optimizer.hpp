@@ -0,0 +1,354 @@
+#pragma once
+
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/resource_loader_registry.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cask {
+
+struct MeshBuffers {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    uint32_t stride = 0;
+
+    size_t vertex_count() const {
+        return stride == 0 ? 0 : vertices.size() / stride;
+    }
+};
+
+struct QuantizedMesh {
+    std::vector<uint16_t> vertices;
+    std::vector<uint32_t> indices;
+    uint32_t stride = 0;
+};
+
+struct MeshOptimizationReport {
+    size_t vertices_before = 0;
+    size_t vertices_after = 0;
+    size_t bytes_before = 0;
+    size_t bytes_after = 0;
+    float cache_miss_ratio_before = 0.0f;
+    float cache_miss_ratio_after = 0.0f;
+    bool valid = true;
+};
+
+constexpr uint32_t vertex_cache_size = 32;
+
+inline size_t mesh_bytes(const MeshBuffers& mesh) {
+    return mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(uint32_t);
+}
+
+inline size_t mesh_bytes(const QuantizedMesh& mesh) {
+    return mesh.vertices.size() * sizeof(uint16_t) + mesh.indices.size() * sizeof(uint32_t);
+}
+
+inline bool valid_indices(const MeshBuffers& mesh) {
+    if (mesh.indices.size() % 3 != 0) return false;
+    size_t vertex_count = mesh.vertex_count();
+    for (uint32_t index : mesh.indices) {
+        if (index >= vertex_count) return false;
+    }
+    return true;
+}
+
+inline float average_cache_miss_ratio(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size = vertex_cache_size) {
+    if (indices.size() < 3) return 0.0f;
+    std::vector<size_t> inserted_at(vertex_count, 0);
+    size_t timestamp = cache_size + 1;
+    size_t misses = 0;
+    for (uint32_t vertex : indices) {
+        if (timestamp - inserted_at[vertex] <= cache_size) continue;
+        inserted_at[vertex] = timestamp++;
+        ++misses;
+    }
+    return float(misses) / float(indices.size() / 3);
+}
+
+inline void remap_vertices(MeshBuffers& mesh, const std::vector<uint32_t>& remap, size_t unique_count) {
+    std::vector<float> vertices(unique_count * mesh.stride);
+    size_t vertex_count = mesh.vertex_count();
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        if (remap[vertex] == UINT32_MAX) continue;
+        std::memcpy(&vertices[size_t(remap[vertex]) * mesh.stride],
+                    &mesh.vertices[vertex * mesh.stride],
+                    mesh.stride * sizeof(float));
+    }
+    for (auto& index : mesh.indices) {
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+inline void deduplicate_vertices(MeshBuffers& mesh) {
+    size_t vertex_count = mesh.vertex_count();
+    size_t vertex_bytes = mesh.stride * sizeof(float);
+    const char* base = reinterpret_cast<const char*>(mesh.vertices.data());
+
+    std::unordered_map<std::string_view, uint32_t> unique;
+    unique.reserve(vertex_count);
+    std::vector<uint32_t> remap(vertex_count, UINT32_MAX);
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        std::string_view key(base + vertex * vertex_bytes, vertex_bytes);
+        auto [found, inserted] = unique.try_emplace(key, uint32_t(unique.size()));
+        remap[vertex] = found->second;
+    }
+    size_t unique_count = unique.size();
+    remap_vertices(mesh, remap, unique_count);
+}
+
+inline float forsyth_vertex_score(int32_t cache_position, uint32_t remaining) {
+    if (remaining == 0) return -1.0f;
+    float score = 0.0f;
+    if (cache_position >= 3) {
+        float scaled = 1.0f - float(cache_position - 3) / float(vertex_cache_size - 3);
+        score = std::pow(scaled, 1.5f);
+    }
+    if (cache_position >= 0 && cache_position < 3) {
+        score = 0.75f;
+    }
+    return score + 2.0f / std::sqrt(float(remaining));
+}
+
+inline void optimize_vertex_cache(MeshBuffers& mesh) {
+    size_t vertex_count = mesh.vertex_count();
+    size_t triangle_count = mesh.indices.size() / 3;
+    if (triangle_count == 0) return;
+
+    std::vector<uint32_t> remaining(vertex_count, 0);
+    for (uint32_t vertex : mesh.indices) {
+        ++remaining[vertex];
+    }
+    std::vector<uint32_t> offsets(vertex_count + 1, 0);
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        offsets[vertex + 1] = offsets[vertex] + remaining[vertex];
+    }
+    std::vector<uint32_t> adjacency(mesh.indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t triangle = 0; triangle < triangle_count; ++triangle) {
+        for (size_t corner = 0; corner < 3; ++corner) {
+            adjacency[fill[mesh.indices[triangle * 3 + corner]]++] = uint32_t(triangle);
+        }
+    }
+
+    std::vector<int32_t> cache_position(vertex_count, -1);
+    std::vector<float> vertex_score(vertex_count);
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        vertex_score[vertex] = forsyth_vertex_score(-1, remaining[vertex]);
+    }
+
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<uint32_t> output;
+    output.reserve(mesh.indices.size());
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> next_cache;
+    cache.reserve(vertex_cache_size + 3);
+    next_cache.reserve(vertex_cache_size + 3);
+
+    size_t scan_cursor = 0;
+    int64_t best_triangle = 0;
+    while (best_triangle >= 0) {
+        const uint32_t* corners = &mesh.indices[size_t(best_triangle) * 3];
+        emitted[size_t(best_triangle)] = true;
+
+        next_cache.clear();
+        for (size_t corner = 0; corner < 3; ++corner) {
+            uint32_t vertex = corners[corner];
+            output.push_back(vertex);
+            next_cache.push_back(vertex);
+
+            uint32_t begin = offsets[vertex];
+            uint32_t end = begin + remaining[vertex];
+            for (uint32_t slot = begin; slot < end; ++slot) {
+                if (adjacency[slot] != uint32_t(best_triangle)) continue;
+                std::swap(adjacency[slot], adjacency[end - 1]);
+                break;
+            }
+            --remaining[vertex];
+        }
+        for (uint32_t vertex : cache) {
+            if (vertex == corners[0] || vertex == corners[1] || vertex == corners[2]) continue;
+            next_cache.push_back(vertex);
+        }
+        for (size_t position = vertex_cache_size; position < next_cache.size(); ++position) {
+            cache_position[next_cache[position]] = -1;
+            vertex_score[next_cache[position]] = forsyth_vertex_score(-1, remaining[next_cache[position]]);
+        }
+        if (next_cache.size() > vertex_cache_size) next_cache.resize(vertex_cache_size);
+        std::swap(cache, next_cache);
+
+        for (size_t position = 0; position < cache.size(); ++position) {
+            uint32_t vertex = cache[position];
+            cache_position[vertex] = int32_t(position);
+            vertex_score[vertex] = forsyth_vertex_score(int32_t(position), remaining[vertex]);
+        }
+
+        best_triangle = -1;
+        float best_score = -1.0f;
+        for (uint32_t vertex : cache) {
+            uint32_t begin = offsets[vertex];
+            uint32_t end = begin + remaining[vertex];
+            for (uint32_t slot = begin; slot < end; ++slot) {
+                uint32_t triangle = adjacency[slot];
+                const uint32_t* triangle_corners = &mesh.indices[size_t(triangle) * 3];
+                float score = vertex_score[triangle_corners[0]] + vertex_score[triangle_corners[1]] + vertex_score[triangle_corners[2]];
+                if (score <= best_score) continue;
+                best_score = score;
+                best_triangle = triangle;
+            }
+        }
+        if (best_triangle >= 0) continue;
+
+        while (scan_cursor < triangle_count && emitted[scan_cursor]) {
+            ++scan_cursor;
+        }
+        if (scan_cursor < triangle_count) best_triangle = int64_t(scan_cursor);
+    }
+
+    mesh.indices = std::move(output);
+}
+
+inline void optimize_vertex_fetch(MeshBuffers& mesh) {
+    size_t vertex_count = mesh.vertex_count();
+    std::vector<uint32_t> remap(vertex_count, UINT32_MAX);
+    uint32_t next_vertex = 0;
+    for (uint32_t vertex : mesh.indices) {
+        if (remap[vertex] != UINT32_MAX) continue;
+        remap[vertex] = next_vertex++;
+    }
+    remap_vertices(mesh, remap, next_vertex);
+}
+
+inline uint16_t float_to_half(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+
+    if (exponent == 0xffu) return uint16_t(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+
+    int32_t half_exponent = int32_t(exponent) - 127 + 15;
+    if (half_exponent >= 0x1f) return uint16_t(sign | 0x7c00u);
+    if (half_exponent < -10) return uint16_t(sign);
+
+    if (half_exponent <= 0) {
+        mantissa |= 0x800000u;
+        uint32_t shift = uint32_t(14 - half_exponent);
+        uint32_t half_mantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u))) ++half_mantissa;
+        return uint16_t(sign | half_mantissa);
+    }
+
+    uint32_t half = sign | (uint32_t(half_exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fffu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half;
+    return uint16_t(half);
+}
+
+inline float half_to_float(uint16_t half) {
+    uint32_t sign = uint32_t(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1fu;
+    uint32_t mantissa = half & 0x3ffu;
+    uint32_t bits = sign;
+
+    if (exponent == 0x1fu) bits = sign | 0x7f800000u | (mantissa << 13);
+    if (exponent > 0 && exponent < 0x1fu) bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    if (exponent == 0 && mantissa != 0) {
+        float magnitude = std::ldexp(float(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline QuantizedMesh quantize_half(const MeshBuffers& mesh) {
+    QuantizedMesh quantized;
+    quantized.stride = mesh.stride;
+    quantized.indices = mesh.indices;
+    quantized.vertices.resize(mesh.vertices.size());
+    for (size_t index = 0; index < mesh.vertices.size(); ++index) {
+        quantized.vertices[index] = float_to_half(mesh.vertices[index]);
+    }
+    return quantized;
+}
+
+struct MeshOptimizer;
+
+struct OptimizingMeshLoader {
+    typename ResourceLoaderRegistry<MeshData>::LoaderFn load;
+    MeshOptimizer* optimizer;
+
+    MeshData operator()(const nlohmann::json& entry) const;
+};
+
+struct MeshOptimizer {
+    bool deduplicate = true;
+    bool reorder = true;
+    uint32_t vertex_stride = 0;
+    std::atomic<size_t> meshes_optimized = 0;
+    std::atomic<size_t> meshes_rejected = 0;
+    std::atomic<size_t> bytes_saved = 0;
+
+    MeshOptimizationReport optimize(MeshBuffers& mesh) {
+        MeshOptimizationReport report;
+        report.vertices_before = mesh.vertex_count();
+        report.bytes_before = mesh_bytes(mesh);
+        report.vertices_after = report.vertices_before;
+        report.bytes_after = report.bytes_before;
+        report.valid = mesh.stride > 0 && mesh.vertices.size() % mesh.stride == 0 && valid_indices(mesh);
+        if (!report.valid) {
+            ++meshes_rejected;
+            return report;
+        }
+        report.cache_miss_ratio_before = average_cache_miss_ratio(mesh.indices, mesh.vertex_count());
+
+        if (deduplicate) deduplicate_vertices(mesh);
+        if (reorder) optimize_vertex_cache(mesh);
+        if (reorder) optimize_vertex_fetch(mesh);
+
+        report.vertices_after = mesh.vertex_count();
+        report.bytes_after = mesh_bytes(mesh);
+        report.cache_miss_ratio_after = average_cache_miss_ratio(mesh.indices, mesh.vertex_count());
+
+        ++meshes_optimized;
+        bytes_saved += report.bytes_before - std::min(report.bytes_before, report.bytes_after);
+        return report;
+    }
+
+    MeshOptimizationReport optimize(MeshData& mesh) {
+        MeshBuffers buffers{std::move(mesh.vertices), std::move(mesh.indices), vertex_stride};
+        auto report = optimize(buffers);
+        mesh.vertices = std::move(buffers.vertices);
+        mesh.indices = std::move(buffers.indices);
+        return report;
+    }
+
+    size_t wrap_loaders(ResourceLoaderRegistry<MeshData>& registry) {
+        size_t wrapped = 0;
+        for (auto& [name, load] : registry.loaders_) {
+            if (load.template target<OptimizingMeshLoader>()) continue;
+            load = OptimizingMeshLoader{std::move(load), this};
+            ++wrapped;
+        }
+        return wrapped;
+    }
+};
+
+inline MeshData OptimizingMeshLoader::operator()(const nlohmann::json& entry) const {
+    MeshData mesh = load(entry);
+    if (optimizer->vertex_stride > 0) optimizer->optimize(mesh);
+    return mesh;
+}
+
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/foundation/event_queue_catalog.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cask {
+
+struct Counter {
+    std::atomic<uint64_t> value_{0};
+
+    void add(uint64_t amount = 1) {
+        value_.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+};
+
+struct Gauge {
+    std::atomic<int64_t> value_{0};
+
+    void set(int64_t value) {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void add(int64_t amount) {
+        value_.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    int64_t value() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+};
+
+struct Histogram {
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<double> sum_{0.0};
+
+    explicit Histogram(std::vector<double> bounds)
+        : bounds_(std::move(bounds))
+        , buckets_(new std::atomic<uint64_t>[bounds_.size() + 1]) {
+        for (size_t index = 0; index <= bounds_.size(); ++index) {
+            buckets_[index].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void observe(double value) {
+        size_t bucket = 0;
+        while (bucket < bounds_.size() && value > bounds_[bucket]) ++bucket;
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t bucket(size_t index) const {
+        return buckets_[index].load(std::memory_order_relaxed);
+    }
+
+    uint64_t count() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    double sum() const {
+        return sum_.load(std::memory_order_relaxed);
+    }
+};
+
+enum class MetricType { counter, gauge, histogram };
+
+inline const char* metric_type_name(MetricType type) {
+    switch (type) {
+        case MetricType::counter: return "counter";
+        case MetricType::gauge: return "gauge";
+        case MetricType::histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+inline std::string metric_label(std::string_view key, std::string_view value) {
+    std::string label(key);
+    label += "=\"";
+    for (char character : value) {
+        if (character == '\\' || character == '"') label += '\\';
+        if (character == '\n') {
+            label += "\\n";
+            continue;
+        }
+        label += character;
+    }
+    label += '"';
+    return label;
+}
+
+struct MetricFamily {
+    std::string name;
+    std::string help;
+    MetricType type;
+    std::vector<std::pair<std::string, std::unique_ptr<Counter>>> counters;
+    std::vector<std::pair<std::string, std::unique_ptr<Gauge>>> gauges;
+    std::vector<std::pair<std::string, std::unique_ptr<Histogram>>> histograms;
+};
+
+struct ObservedQueue {
+    void* queue;
+    size_t (*delivered)(void*);
+    Counter* total;
+    Gauge* depth;
+};
+
+struct Metrics {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::unique_ptr<MetricFamily>> families_;
+    std::vector<ObservedQueue> queues_;
+    std::mutex mutex_;
+    std::filesystem::path path_;
+    Clock::duration interval_ = std::chrono::seconds(1);
+    Clock::time_point last_write_{};
+    size_t writes_ = 0;
+
+    Counter& counter(std::string_view name, std::string_view help, std::string_view labels = {}) {
+        std::lock_guard lock(mutex_);
+        return series(family(name, help, MetricType::counter).counters, labels);
+    }
+
+    Gauge& gauge(std::string_view name, std::string_view help, std::string_view labels = {}) {
+        std::lock_guard lock(mutex_);
+        return series(family(name, help, MetricType::gauge).gauges, labels);
+    }
+
+    Histogram& histogram(std::string_view name, std::string_view help, std::vector<double> bounds, std::string_view labels = {}) {
+        std::lock_guard lock(mutex_);
+        auto& histograms = family(name, help, MetricType::histogram).histograms;
+        for (auto& [existing, histogram] : histograms) {
+            if (existing == labels) return *histogram;
+        }
+        histograms.emplace_back(std::string(labels), std::make_unique<Histogram>(std::move(bounds)));
+        return *histograms.back().second;
+    }
+
+    void observe_queue(std::string_view name, void* queue, size_t (*delivered)(void*)) {
+        auto label = metric_label("queue", name);
+        auto& total = counter("cask_events_delivered_total", "Events made visible by a queue swap.", label);
+        auto& depth = gauge("cask_event_queue_depth", "Events readable from a queue this tick.", label);
+        std::lock_guard lock(mutex_);
+        for (auto& observed : queues_) {
+            if (observed.queue == queue) return;
+        }
+        queues_.push_back(ObservedQueue{queue, delivered, &total, &depth});
+    }
+
+    template<typename Event>
+    void observe_queue(std::string_view name, EventQueue<Event>* queue) {
+        observe_queue(name, queue, queue_delivered<Event>);
+    }
+
+    void observe_catalog(const EventQueueCatalog& catalog) {
+        for (auto& entry : catalog.queues_) {
+            observe_queue(entry.name, entry.queue, entry.delivered);
+        }
+    }
+
+    void forget_queue(const void* queue) {
+        std::lock_guard lock(mutex_);
+        for (auto& observed : queues_) {
+            if (observed.queue == queue) observed.depth->set(0);
+        }
+        std::erase_if(queues_, [queue](const ObservedQueue& observed) { return observed.queue == queue; });
+    }
+
+    void sample_queues() {
+        std::lock_guard lock(mutex_);
+        for (auto& observed : queues_) {
+            size_t delivered = observed.delivered(observed.queue);
+            observed.total->add(delivered);
+            observed.depth->set(int64_t(delivered));
+        }
+    }
+
+    void write_prometheus(std::ostream& out) {
+        std::lock_guard lock(mutex_);
+        for (auto& family : families_) {
+            out << "# HELP " << family->name << ' ' << family->help << '\n';
+            out << "# TYPE " << family->name << ' ' << metric_type_name(family->type) << '\n';
+            for (auto& [labels, counter] : family->counters) {
+                write_sample(out, family->name, labels, counter->value());
+            }
+            for (auto& [labels, gauge] : family->gauges) {
+                write_sample(out, family->name, labels, gauge->value());
+            }
+            for (auto& [labels, histogram] : family->histograms) {
+                write_histogram(out, family->name, labels, *histogram);
+            }
+        }
+    }
+
+    bool write_prometheus(const std::filesystem::path& path) {
+        std::ostringstream text;
+        write_prometheus(text);
+        auto staging = path;
+        staging += ".tmp";
+        {
+            std::ofstream out(staging, std::ios::trunc);
+            if (!out) return false;
+            out << text.str();
+            if (!out) return false;
+        }
+        std::error_code error;
+        std::filesystem::rename(staging, path, error);
+        return !error;
+    }
+
+    bool update(Clock::time_point now) {
+        if (path_.empty() || now - last_write_ < interval_) return false;
+        last_write_ = now;
+        if (!write_prometheus(path_)) return false;
+        ++writes_;
+        return true;
+    }
+
+private:
+    MetricFamily& family(std::string_view name, std::string_view help, MetricType type) {
+        for (auto& existing : families_) {
+            if (existing->name == name) return *existing;
+        }
+        auto created = std::make_unique<MetricFamily>();
+        created->name = name;
+        created->help = help;
+        created->type = type;
+        families_.push_back(std::move(created));
+        return *families_.back();
+    }
+
+    template<typename Series>
+    static Series& series(std::vector<std::pair<std::string, std::unique_ptr<Series>>>& all, std::string_view labels) {
+        for (auto& [existing, value] : all) {
+            if (existing == labels) return *value;
+        }
+        all.emplace_back(std::string(labels), std::make_unique<Series>());
+        return *all.back().second;
+    }
+
+    template<typename Value>
+    static void write_sample(std::ostream& out, const std::string& name, const std::string& labels, Value value) {
+        out << name;
+        if (!labels.empty()) out << '{' << labels << '}';
+        out << ' ' << value << '\n';
+    }
+
+    static std::string join_labels(const std::string& labels, const std::string& extra) {
+        if (labels.empty()) return extra;
+        return labels + ',' + extra;
+    }
+
+    static void write_histogram(std::ostream& out, const std::string& name, const std::string& labels, const Histogram& histogram) {
+        uint64_t cumulative = 0;
+        for (size_t index = 0; index < histogram.bounds_.size(); ++index) {
+            cumulative += histogram.bucket(index);
+            std::ostringstream bound;
+            bound << histogram.bounds_[index];
+            write_sample(out, name + "_bucket", join_labels(labels, metric_label("le", bound.str())), cumulative);
+        }
+        cumulative += histogram.bucket(histogram.bounds_.size());
+        write_sample(out, name + "_bucket", join_labels(labels, metric_label("le", "+Inf")), cumulative);
+        write_sample(out, name + "_sum", labels, histogram.sum());
+        write_sample(out, name + "_count", labels, histogram.count());
+    }
+};
+
+inline Metrics* resolve_metrics(WorldHandle handle) {
+    return static_cast<Metrics*>(world_resolve_component(handle, "Metrics"));
+}
+
+template<typename Event>
+void observe_event_queue(WorldView& world, const char* name, EventQueue<Event>* queue) {
+    auto* metrics = world.resolve<Metrics>("Metrics");
+    if (!metrics) return;
+    metrics->observe_queue(name, queue);
+}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cask {
+
+struct MipLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;
+    std::vector<uint8_t> pixels;
+};
+
+inline uint32_t mip_level_count(uint32_t width, uint32_t height) {
+    uint32_t count = 1;
+    uint32_t extent = std::max(width, height);
+    while (extent > 1) {
+        extent /= 2;
+        ++count;
+    }
+    return count;
+}
+
+template<uint32_t Channels>
+void downsample_rows(const MipLevel& source, MipLevel& target) {
+    size_t source_stride = size_t(source.width) * Channels;
+    size_t column_step = source.width > 1 ? Channels : 0;
+    size_t row_step = source.height > 1 ? source_stride : 0;
+    size_t target_stride = size_t(target.width) * Channels;
+
+    for (uint32_t row = 0; row < target.height; ++row) {
+        const uint8_t* top = source.pixels.data() + size_t(row) * 2 * source_stride;
+        const uint8_t* bottom = top + row_step;
+        uint8_t* out = target.pixels.data() + size_t(row) * target_stride;
+        for (uint32_t column = 0; column < target.width; ++column) {
+            size_t left = size_t(column) * 2 * Channels;
+            size_t right = left + column_step;
+            for (uint32_t channel = 0; channel < Channels; ++channel) {
+                uint32_t sum = uint32_t(top[left + channel]) + top[right + channel]
+                    + bottom[left + channel] + bottom[right + channel];
+                out[size_t(column) * Channels + channel] = uint8_t((sum + 2) >> 2);
+            }
+        }
+    }
+}
+
+inline void downsample_rows_generic(const MipLevel& source, MipLevel& target) {
+    uint32_t channels = source.channels;
+    size_t source_stride = size_t(source.width) * channels;
+    size_t column_step = source.width > 1 ? channels : 0;
+    size_t row_step = source.height > 1 ? source_stride : 0;
+    size_t target_stride = size_t(target.width) * channels;
+
+    for (uint32_t row = 0; row < target.height; ++row) {
+        const uint8_t* top = source.pixels.data() + size_t(row) * 2 * source_stride;
+        const uint8_t* bottom = top + row_step;
+        uint8_t* out = target.pixels.data() + size_t(row) * target_stride;
+        for (uint32_t column = 0; column < target.width; ++column) {
+            size_t left = size_t(column) * 2 * channels;
+            size_t right = left + column_step;
+            for (uint32_t channel = 0; channel < channels; ++channel) {
+                uint32_t sum = uint32_t(top[left + channel]) + top[right + channel]
+                    + bottom[left + channel] + bottom[right + channel];
+                out[size_t(column) * channels + channel] = uint8_t((sum + 2) >> 2);
+            }
+        }
+    }
+}
+
+inline MipLevel downsample(const MipLevel& source) {
+    MipLevel target;
+    target.width = std::max(source.width / 2, 1u);
+    target.height = std::max(source.height / 2, 1u);
+    target.channels = source.channels;
+    target.pixels.resize(size_t(target.width) * target.height * target.channels);
+
+    switch (source.channels) {
+        case 1: downsample_rows<1>(source, target); break;
+        case 2: downsample_rows<2>(source, target); break;
+        case 3: downsample_rows<3>(source, target); break;
+        case 4: downsample_rows<4>(source, target); break;
+        default: downsample_rows_generic(source, target); break;
+    }
+    return target;
+}
+
+inline std::vector<MipLevel> build_mip_chain(MipLevel base) {
+    std::vector<MipLevel> chain;
+    chain.reserve(mip_level_count(base.width, base.height));
+    chain.push_back(std::move(base));
+    while (chain.back().width > 1 || chain.back().height > 1) {
+        chain.push_back(downsample(chain.back()));
+    }
+    return chain;
+}
+
+}
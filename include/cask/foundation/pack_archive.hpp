@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CASK_PACK_MMAP 1
+#endif
+
+namespace cask {
+
+constexpr char pack_magic[8] = {'C', 'A', 'S', 'K', 'P', 'A', 'C', 'K'};
+constexpr uint32_t pack_version = 1;
+constexpr uint64_t pack_alignment = 64;
+constexpr const char* default_pack_name = "assets.pack";
+
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_count;
+    uint64_t toc_offset;
+    uint64_t names_offset;
+};
+
+struct PackEntry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t name_offset;
+    uint32_t name_length;
+};
+
+inline uint64_t pack_hash(std::string_view path) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char character : path) {
+        hash ^= uint8_t(character);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline uint64_t pack_align(uint64_t offset) {
+    return (offset + pack_alignment - 1) & ~(pack_alignment - 1);
+}
+
+inline bool write_pack(const std::string& directory, const std::string& output_path) {
+    std::error_code error;
+    std::vector<std::string> paths;
+    for (auto& file : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (!file.is_regular_file()) continue;
+        if (std::filesystem::equivalent(file.path(), output_path, error)) continue;
+        paths.push_back(std::filesystem::relative(file.path(), directory).generic_string());
+    }
+
+    std::vector<PackEntry> entries(paths.size());
+    std::string names;
+    for (size_t index = 0; index < paths.size(); ++index) {
+        entries[index].hash = pack_hash(paths[index]);
+        entries[index].name_offset = uint32_t(names.size());
+        entries[index].name_length = uint32_t(paths[index].size());
+        names += paths[index];
+    }
+
+    std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+    if (!output) return false;
+
+    uint64_t cursor = pack_align(sizeof(PackHeader));
+    std::vector<char> contents;
+    std::vector<char> padding(pack_alignment, 0);
+    output.write(padding.data(), std::streamsize(cursor));
+    for (size_t index = 0; index < paths.size(); ++index) {
+        std::ifstream input(std::filesystem::path(directory) / paths[index], std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        entries[index].offset = cursor;
+        entries[index].size = contents.size();
+        output.write(contents.data(), std::streamsize(contents.size()));
+        uint64_t aligned = pack_align(cursor + contents.size());
+        output.write(padding.data(), std::streamsize(aligned - cursor - contents.size()));
+        cursor = aligned;
+    }
+
+    std::sort(entries.begin(), entries.end(), [&names](const PackEntry& left, const PackEntry& right) {
+        if (left.hash != right.hash) return left.hash < right.hash;
+        return std::string_view(names).substr(left.name_offset, left.name_length)
+            < std::string_view(names).substr(right.name_offset, right.name_length);
+    });
+
+    PackHeader header;
+    std::memcpy(header.magic, pack_magic, sizeof(pack_magic));
+    header.version = pack_version;
+    header.entry_count = uint32_t(entries.size());
+    header.toc_offset = cursor;
+    header.names_offset = cursor + entries.size() * sizeof(PackEntry);
+    output.write(reinterpret_cast<const char*>(entries.data()), std::streamsize(entries.size() * sizeof(PackEntry)));
+    output.write(names.data(), std::streamsize(names.size()));
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return bool(output);
+}
+
+struct PackArchive {
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    const PackEntry* entries_ = nullptr;
+    const char* names_ = nullptr;
+    uint32_t entry_count_ = 0;
+    std::vector<uint8_t> buffer_;
+
+    PackArchive() = default;
+    PackArchive(const PackArchive&) = delete;
+    PackArchive& operator=(const PackArchive&) = delete;
+
+    ~PackArchive() {
+        close();
+    }
+
+    bool is_open() const {
+        return data_ != nullptr;
+    }
+
+    bool open(const std::string& path) {
+        close();
+        if (!map(path)) return false;
+        if (validate()) return true;
+        close();
+        return false;
+    }
+
+    void close() {
+#ifdef CASK_PACK_MMAP
+        if (data_ && buffer_.empty()) munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        entries_ = nullptr;
+        names_ = nullptr;
+        entry_count_ = 0;
+    }
+
+    const PackEntry* find_entry(std::string_view path) const {
+        if (!is_open()) return nullptr;
+        uint64_t hash = pack_hash(path);
+        const PackEntry* end = entries_ + entry_count_;
+        const PackEntry* entry = std::lower_bound(entries_, end, hash, [](const PackEntry& candidate, uint64_t value) {
+            return candidate.hash < value;
+        });
+        for (; entry != end && entry->hash == hash; ++entry) {
+            if (std::string_view(names_ + entry->name_offset, entry->name_length) == path) return entry;
+        }
+        return nullptr;
+    }
+
+    bool contains(std::string_view path) const {
+        return find_entry(path) != nullptr;
+    }
+
+    std::span<const uint8_t> find(std::string_view path) const {
+        const PackEntry* entry = find_entry(path);
+        if (!entry) return {};
+        return std::span<const uint8_t>(data_ + entry->offset, entry->size);
+    }
+
+    size_t entry_count() const {
+        return entry_count_;
+    }
+
+private:
+    bool map(const std::string& path) {
+#ifdef CASK_PACK_MMAP
+        int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0) return false;
+        struct stat status;
+        bool mapped = fstat(descriptor, &status) == 0 && status.st_size > 0;
+        void* address = mapped ? mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+        ::close(descriptor);
+        if (address == MAP_FAILED) return false;
+        data_ = static_cast<const uint8_t*>(address);
+        size_ = size_t(status.st_size);
+        return true;
+#else
+        std::ifstream input(path, std::ios::binary);
+        if (!input) return false;
+        buffer_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        if (buffer_.empty()) return false;
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+#endif
+    }
+
+    bool validate() {
+        if (size_ < sizeof(PackHeader)) return false;
+        PackHeader header;
+        std::memcpy(&header, data_, sizeof(header));
+        if (std::memcmp(header.magic, pack_magic, sizeof(pack_magic)) != 0) return false;
+        if (header.version != pack_version) return false;
+        if (header.toc_offset > size_ || header.toc_offset % alignof(PackEntry) != 0) return false;
+        if (uint64_t(header.entry_count) > (size_ - header.toc_offset) / sizeof(PackEntry)) return false;
+        if (header.names_offset > size_) return false;
+        const auto* entries = reinterpret_cast<const PackEntry*>(data_ + header.toc_offset);
+        const auto* end = entries + header.entry_count;
+        uint64_t names_size = size_ - header.names_offset;
+        bool entries_valid = std::all_of(entries, end, [this, names_size](const PackEntry& entry) {
+            return valid_entry(entry, names_size);
+        });
+        if (!entries_valid) return false;
+        if (!std::is_sorted(entries, end, [](const PackEntry& left, const PackEntry& right) { return left.hash < right.hash; })) return false;
+        entries_ = entries;
+        names_ = reinterpret_cast<const char*>(data_ + header.names_offset);
+        entry_count_ = header.entry_count;
+        return true;
+    }
+
+    bool valid_entry(const PackEntry& entry, uint64_t names_size) const {
+        if (entry.offset > size_ || entry.size > size_ - entry.offset) return false;
+        return uint64_t(entry.name_offset) + entry.name_length <= names_size;
+    }
+};
+
+struct AssetBytes {
+    std::span<const uint8_t> bytes;
+    std::vector<uint8_t> owned;
+    bool from_pack = false;
+
+    AssetBytes() = default;
+    AssetBytes(AssetBytes&&) = default;
+    AssetBytes& operator=(AssetBytes&&) = default;
+    AssetBytes(const AssetBytes&) = delete;
+    AssetBytes& operator=(const AssetBytes&) = delete;
+
+    bool found() const {
+        return bytes.data() != nullptr;
+    }
+};
+
+struct AssetReader {
+    std::string root_;
+    PackArchive archive_;
+
+    AssetBytes read(std::string_view relative_path) const {
+        AssetBytes asset;
+        asset.bytes = archive_.find(relative_path);
+        asset.from_pack = asset.found();
+        if (asset.from_pack) return asset;
+
+        std::error_code error;
+        std::filesystem::path path = std::filesystem::path(root_) / relative_path;
+        if (!std::filesystem::is_regular_file(path, error)) return asset;
+        std::ifstream input(path, std::ios::binary);
+        if (!input) return asset;
+        asset.owned.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        static const uint8_t empty = 0;
+        asset.bytes = asset.owned.empty()
+            ? std::span<const uint8_t>(&empty, 0)
+            : std::span<const uint8_t>(asset.owned.data(), asset.owned.size());
+        return asset;
+    }
+
+    bool exists(std::string_view relative_path) const {
+        if (archive_.contains(relative_path)) return true;
+        std::error_code error;
+        return std::filesystem::is_regular_file(std::filesystem::path(root_) / relative_path, error);
+    }
+};
+
+}
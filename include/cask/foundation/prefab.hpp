@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/identity/entity_registry.hpp>
+#include <cask/identity/uuid.hpp>
+#include <cask/schema/serialization_registry.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct PrefabImage {
+    void* store;
+    std::shared_ptr<const void> value;
+    void (*spawn)(void* store, const void* value, std::span<const uint32_t> entities);
+};
+
+template<typename Values>
+void reserve_geometric(Values& values, size_t extra) {
+    size_t needed = values.size() + extra;
+    if (needed <= values.capacity()) return;
+    values.reserve(std::max(needed, values.capacity() * 2));
+}
+
+template<typename Component>
+void spawn_component(void* store, const void* value, std::span<const uint32_t> entities) {
+    auto* typed = static_cast<ComponentStore<Component>*>(store);
+    const auto& prototype = *static_cast<const Component*>(value);
+    reserve_geometric(typed->components_, entities.size());
+    reserve_geometric(typed->entities_, entities.size());
+    for (uint32_t entity : entities) {
+        typed->insert(entity, prototype);
+    }
+}
+
+struct Prefab {
+    std::vector<PrefabImage> images_;
+    std::vector<std::string> unknown_keys_;
+
+    template<typename Component>
+    Prefab& add(ComponentStore<Component>* store, Component value) {
+        for (auto& image : images_) {
+            if (image.store != store) continue;
+            image.value = std::make_shared<const Component>(std::move(value));
+            return *this;
+        }
+        images_.push_back(PrefabImage{store, std::make_shared<const Component>(std::move(value)), spawn_component<Component>});
+        return *this;
+    }
+
+    size_t size() const {
+        return images_.size();
+    }
+
+    void touch(StoreGenerations& generations, std::span<const uint32_t> entities) const {
+        for (auto& image : images_) {
+            generations.touch(image.store, entities);
+        }
+    }
+
+    void instantiate(EntityTable& table, size_t count, std::vector<uint32_t>& created, EntityRegistry* registry = nullptr) const {
+        size_t first = created.size();
+        reserve_geometric(created, count);
+        if (registry) {
+            for (size_t index = 0; index < count; ++index) {
+                created.push_back(registry->resolve(generate_uuid(), table));
+            }
+        } else {
+            for (size_t index = 0; index < count; ++index) {
+                created.push_back(table.create());
+            }
+        }
+        std::span<const uint32_t> entities(created.data() + first, count);
+        for (auto& image : images_) {
+            image.spawn(image.store, image.value.get(), entities);
+        }
+    }
+
+    std::vector<uint32_t> instantiate(EntityTable& table, size_t count, EntityRegistry* registry = nullptr) const {
+        std::vector<uint32_t> created;
+        instantiate(table, count, created, registry);
+        return created;
+    }
+};
+
+struct PrefabStore {
+    void* store;
+    RegistryEntry value_entry;
+    void (*compile)(Prefab& prefab, void* store, const RegistryEntry& value_entry, const nlohmann::json& value);
+};
+
+template<typename Component>
+void compile_component(Prefab& prefab, void* store, const RegistryEntry& value_entry, const nlohmann::json& value) {
+    Component component{};
+    value_entry.deserialize(value, &component, nlohmann::json{});
+    prefab.add(static_cast<ComponentStore<Component>*>(store), std::move(component));
+}
+
+struct Prefabs {
+    std::vector<std::pair<std::string, PrefabStore>> stores_;
+    std::unordered_map<std::string, Prefab> prefabs_;
+    StoreGenerations* generations_ = nullptr;
+
+    template<typename Component>
+    void add_store(const std::string& name, ComponentStore<Component>* store, const RegistryEntry& value_entry) {
+        for (auto& [store_name, entry] : stores_) {
+            if (store_name != name) continue;
+            entry = PrefabStore{store, value_entry, compile_component<Component>};
+            return;
+        }
+        stores_.emplace_back(name, PrefabStore{store, value_entry, compile_component<Component>});
+    }
+
+    void remove_store(const std::string& name) {
+        std::erase_if(stores_, [&name](const std::pair<std::string, PrefabStore>& entry) { return entry.first == name; });
+    }
+
+    size_t store_count() const {
+        return stores_.size();
+    }
+
+    Prefab& compile(const std::string& name, const nlohmann::json& entity) {
+        Prefab prefab;
+        for (auto& [store_name, store] : stores_) {
+            if (!entity.contains(store_name)) continue;
+            store.compile(prefab, store.store, store.value_entry, entity.at(store_name));
+        }
+        if (entity.is_object()) {
+            for (const auto& item : entity.items()) {
+                if (!find_store(item.key())) prefab.unknown_keys_.push_back(item.key());
+            }
+        }
+        auto& compiled = prefabs_[name];
+        compiled = std::move(prefab);
+        return compiled;
+    }
+
+    const PrefabStore* find_store(const std::string& name) const {
+        for (auto& [store_name, store] : stores_) {
+            if (store_name == name) return &store;
+        }
+        return nullptr;
+    }
+
+    Prefab* find(const std::string& name) {
+        auto found = prefabs_.find(name);
+        if (found == prefabs_.end()) return nullptr;
+        return &found->second;
+    }
+
+    bool instantiate(const std::string& name, EntityTable& table, size_t count, std::vector<uint32_t>& created, EntityRegistry* registry = nullptr) {
+        auto* prefab = find(name);
+        if (!prefab) return false;
+        size_t first = created.size();
+        prefab->instantiate(table, count, created, registry);
+        if (generations_) prefab->touch(*generations_, std::span<const uint32_t>(created).subspan(first));
+        return true;
+    }
+};
+
+}
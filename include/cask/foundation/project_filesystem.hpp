@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cask/foundation/file_watcher.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define CASK_PROJECT_FILESYSTEM_POSIX 1
+#endif
+
+namespace cask {
+
+struct PathHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view path) const {
+        return std::hash<std::string_view>{}(path);
+    }
+};
+
+struct ProjectFile {
+    uint64_t size = 0;
+    int64_t modified = 0;
+    int descriptor = -1;
+    std::list<std::string>::iterator opened;
+};
+
+struct ProjectFilesystem {
+    using Clock = std::chrono::steady_clock;
+    using FileIndex = std::unordered_map<std::string, ProjectFile, PathHash, std::equal_to<>>;
+    using DirectoryIndex = std::unordered_map<std::string, int64_t, PathHash, std::equal_to<>>;
+
+    std::string root_;
+    FileIndex files_;
+    DirectoryIndex directories_;
+    bool indexed_ = false;
+    FileWatcher watcher_;
+    std::vector<std::string> changed_;
+    std::list<std::string> open_order_;
+    size_t max_open_descriptors_ = 64;
+    bool sweep_ = false;
+    Clock::duration refresh_interval_ = std::chrono::milliseconds(500);
+    Clock::time_point last_refresh_;
+    size_t files_refreshed_ = 0;
+
+    ProjectFilesystem() {
+        watcher_.structure_events_ = true;
+    }
+
+    ProjectFilesystem(const ProjectFilesystem&) = delete;
+    ProjectFilesystem& operator=(const ProjectFilesystem&) = delete;
+
+    ~ProjectFilesystem() {
+        close_all();
+    }
+
+    void index(const std::string& root) {
+        close_all();
+        files_.clear();
+        for (auto& [directory, modified] : directories_) {
+            watcher_.forget(directory);
+        }
+        directories_.clear();
+        root_ = root;
+        indexed_ = false;
+        sweep_ = !watcher_.available();
+    }
+
+    void sync() {
+        if (indexed_) return;
+        indexed_ = true;
+        scan_directory(std::string());
+    }
+
+    size_t size() {
+        sync();
+        return files_.size();
+    }
+
+    bool exists(std::string_view relative_path) {
+        sync();
+        return files_.find(relative_path) != files_.end();
+    }
+
+    const ProjectFile* find(std::string_view relative_path) {
+        sync();
+        auto file = files_.find(relative_path);
+        if (file == files_.end()) return nullptr;
+        return &file->second;
+    }
+
+    std::string absolute(std::string_view relative_path) const {
+        std::string path = root_;
+        path += '/';
+        path += relative_path;
+        return path;
+    }
+
+    int open(std::string_view relative_path) {
+        sync();
+        auto file = files_.find(relative_path);
+        if (file == files_.end()) return -1;
+        if (file->second.descriptor >= 0) {
+            open_order_.splice(open_order_.end(), open_order_, file->second.opened);
+            return file->second.descriptor;
+        }
+#ifdef CASK_PROJECT_FILESYSTEM_POSIX
+        file->second.descriptor = ::open(absolute(relative_path).c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+        if (file->second.descriptor < 0) return -1;
+        while (open_order_.size() >= std::max<size_t>(max_open_descriptors_, 1)) {
+            close_descriptor(files_.find(open_order_.front())->second);
+        }
+        file->second.opened = open_order_.insert(open_order_.end(), file->first);
+        return file->second.descriptor;
+    }
+
+    size_t open_descriptors() const {
+        return open_order_.size();
+    }
+
+    bool refresh_file(std::string_view relative_path) {
+        if (!indexed_) return false;
+        std::error_code error;
+        std::filesystem::path path = absolute(relative_path);
+        auto file = files_.find(relative_path);
+        if (!std::filesystem::is_regular_file(path, error)) {
+            if (file == files_.end()) return false;
+            close_descriptor(file->second);
+            files_.erase(file);
+            return true;
+        }
+
+        ProjectFile updated;
+        updated.size = std::filesystem::file_size(path, error);
+        updated.modified = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        if (file == files_.end()) {
+            files_.emplace(std::string(relative_path), updated);
+            return true;
+        }
+        if (file->second.size == updated.size && file->second.modified == updated.modified) return false;
+        close_descriptor(file->second);
+        file->second = updated;
+        return true;
+    }
+
+    size_t refresh_if_due(Clock::time_point now) {
+        if (!indexed_) return 0;
+        size_t rescanned = 0;
+        if (sweep_ && now - last_refresh_ >= refresh_interval_) {
+            last_refresh_ = now;
+            rescanned += sweep();
+        }
+        return rescanned + apply_changes();
+    }
+
+    size_t refresh() {
+        if (!indexed_) return 0;
+        size_t rescanned = sweep_ ? sweep() : 0;
+        return rescanned + apply_changes();
+    }
+
+private:
+    size_t apply_changes() {
+        size_t rescanned = 0;
+        changed_.clear();
+        watcher_.poll(changed_);
+        for (auto& path : changed_) {
+            std::error_code error;
+            auto status = std::filesystem::symlink_status(absolute(path), error);
+            bool directory = std::filesystem::is_directory(status);
+            if (directories_.count(path) > 0 && !directory) {
+                forget_tree(path);
+                ++rescanned;
+                continue;
+            }
+            if (directory) {
+                if (directories_.count(path) > 0) continue;
+                scan_directory(path);
+                ++rescanned;
+                continue;
+            }
+            if (refresh_file(path)) ++files_refreshed_;
+        }
+        if (watcher_.overflowed_) {
+            watcher_.overflowed_ = false;
+            rescanned += sweep();
+        }
+        return rescanned;
+    }
+
+    size_t sweep() {
+        std::vector<std::string> stale;
+        std::vector<std::string> removed;
+        std::error_code error;
+        for (auto& [directory, modified] : directories_) {
+            auto current = std::filesystem::last_write_time(absolute(directory), error);
+            if (error) {
+                removed.push_back(directory);
+                continue;
+            }
+            if (current.time_since_epoch().count() != modified) stale.push_back(directory);
+        }
+        for (auto& directory : removed) {
+            forget_directory(directory);
+        }
+        for (auto& directory : stale) {
+            forget_directory(directory);
+            scan_directory(directory);
+        }
+        return stale.size() + removed.size();
+    }
+
+    static std::string join(const std::string& directory, const std::string& name) {
+        if (directory.empty()) return name;
+        return directory + "/" + name;
+    }
+
+    void close_descriptor(ProjectFile& file) {
+        if (file.descriptor < 0) return;
+#ifdef CASK_PROJECT_FILESYSTEM_POSIX
+        ::close(file.descriptor);
+#endif
+        open_order_.erase(file.opened);
+        file.descriptor = -1;
+    }
+
+    void close_all() {
+        for (auto& [path, file] : files_) {
+            close_descriptor(file);
+        }
+    }
+
+    static bool directly_inside(std::string_view path, std::string_view directory) {
+        if (directory.empty()) return path.find('/') == std::string_view::npos;
+        if (path.size() <= directory.size() + 1) return false;
+        if (path.substr(0, directory.size()) != directory || path[directory.size()] != '/') return false;
+        return path.find('/', directory.size() + 1) == std::string_view::npos;
+    }
+
+    void forget_directory(const std::string& directory) {
+        for (auto file = files_.begin(); file != files_.end();) {
+            if (!directly_inside(file->first, directory)) {
+                ++file;
+                continue;
+            }
+            close_descriptor(file->second);
+            file = files_.erase(file);
+        }
+        directories_.erase(directory);
+        watcher_.forget(directory);
+    }
+
+    void forget_tree(const std::string& directory) {
+        std::vector<std::string> nested;
+        for (auto& [path, modified] : directories_) {
+            if (path == directory || (path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/')) {
+                nested.push_back(path);
+            }
+        }
+        for (auto& path : nested) {
+            forget_directory(path);
+        }
+    }
+
+    void scan_directory(const std::string& directory) {
+        std::error_code error;
+        std::filesystem::path path = directory.empty() ? std::filesystem::path(root_) : std::filesystem::path(absolute(directory));
+        auto modified = std::filesystem::last_write_time(path, error);
+        if (error) return;
+        directories_[directory] = modified.time_since_epoch().count();
+        if (!watcher_.watch(root_, directory)) sweep_ = true;
+
+        for (auto& entry : std::filesystem::directory_iterator(path, error)) {
+            std::string relative = join(directory, entry.path().filename().string());
+            std::error_code entry_error;
+            if (entry.is_directory(entry_error)) {
+                bool linked = entry.is_symlink(entry_error);
+                if (!linked && directories_.count(relative) == 0) scan_directory(relative);
+                continue;
+            }
+            if (!entry.is_regular_file(entry_error)) continue;
+            ProjectFile file;
+            file.size = entry.file_size(entry_error);
+            file.modified = entry.last_write_time(entry_error).time_since_epoch().count();
+            files_.insert_or_assign(relative, file);
+        }
+    }
+};
+
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cask/ecs/component_store.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/foundation/worker_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct QueryExclusion {
+    const void* store;
+    bool (*has)(const void*, uint32_t);
+    size_t (*size)(const void*);
+};
+
+template<typename Component>
+bool store_has(const void* store, uint32_t entity) {
+    return static_cast<const ComponentStore<Component>*>(store)->has(entity);
+}
+
+template<typename Component>
+size_t store_size(const void* store) {
+    return static_cast<const ComponentStore<Component>*>(store)->entities_.size();
+}
+
+template<typename... Components>
+struct Query {
+    static_assert(sizeof...(Components) > 0);
+    static constexpr size_t lookahead = 8;
+
+    std::tuple<ComponentStore<Components>*...> stores_;
+    std::vector<QueryExclusion> excluded_;
+    std::vector<uint32_t> matches_;
+    std::unordered_map<uint32_t, size_t> match_index_;
+    std::array<size_t, sizeof...(Components)> included_sizes_{};
+    std::vector<size_t> excluded_sizes_;
+    StoreGenerations* generations_ = nullptr;
+    std::vector<const WriteGeneration*> written_;
+    std::vector<uint64_t> seen_;
+    EntityWatch watch_;
+    std::unique_ptr<WorkerPool> pool_;
+    bool dirty_ = true;
+    size_t rebuilds_ = 0;
+
+    explicit Query(ComponentStore<Components>*... stores)
+        : stores_(stores...) {}
+
+    Query(const Query&) = delete;
+    Query& operator=(const Query&) = delete;
+
+    template<typename Component>
+    Query& without(const ComponentStore<Component>* store) {
+        excluded_.push_back(QueryExclusion{store, store_has<Component>, store_size<Component>});
+        if (generations_) written_.push_back(generations_->track(store));
+        dirty_ = true;
+        return *this;
+    }
+
+    Query& watch(EntityWatchers& watchers) {
+        watch_ = EntityWatch(watchers, this, forget_entity, retire_entity);
+        dirty_ = true;
+        return *this;
+    }
+
+    void unwatch() {
+        watch_.reset();
+    }
+
+    Query& track(StoreGenerations& generations) {
+        generations_ = &generations;
+        written_.clear();
+        std::apply([this](auto*... stores) { (written_.push_back(generations_->track(stores)), ...); }, stores_);
+        for (auto& exclusion : excluded_) {
+            written_.push_back(generations_->track(exclusion.store));
+        }
+        dirty_ = true;
+        return *this;
+    }
+
+    void invalidate() {
+        dirty_ = true;
+    }
+
+    const std::vector<uint32_t>& entities() {
+        if (dirty_ || stale()) rebuild();
+        return matches_;
+    }
+
+    size_t size() {
+        return entities().size();
+    }
+
+    template<typename Fn>
+    void each(Fn&& fn) {
+        visit(std::span<const uint32_t>(entities()), fn);
+    }
+
+    template<typename Fn>
+    void each_chunk(size_t chunk_size, Fn&& fn) {
+        std::span<const uint32_t> all(entities());
+        for (size_t begin = 0; begin < all.size(); begin += chunk_size) {
+            fn(all.subspan(begin, std::min(chunk_size, all.size() - begin)));
+        }
+    }
+
+    template<typename Fn>
+    void parallel_each(size_t chunk_size, Fn&& fn, size_t workers = std::thread::hardware_concurrency()) {
+        if (!pool_) pool_ = std::make_unique<WorkerPool>();
+        parallel_each(*pool_, chunk_size, fn, workers);
+    }
+
+    template<typename Fn>
+    void parallel_each(WorkerPool& pool, size_t chunk_size, Fn&& fn, size_t workers = std::thread::hardware_concurrency()) {
+        std::span<const uint32_t> all(entities());
+        size_t chunks = (all.size() + chunk_size - 1) / chunk_size;
+        workers = std::max<size_t>(1, std::min(workers, chunks));
+        std::atomic<size_t> next{0};
+        auto work = [&](size_t) {
+            for (size_t chunk = next++; chunk < chunks; chunk = next++) {
+                size_t begin = chunk * chunk_size;
+                visit(all.subspan(begin, std::min(chunk_size, all.size() - begin)), fn);
+            }
+        };
+        if (workers == 1) {
+            work(0);
+            return;
+        }
+        pool.run(workers, work);
+    }
+
+    bool matches(uint32_t entity) const {
+        bool included = std::apply([entity](auto*... stores) { return (stores->has(entity) && ...); }, stores_);
+        if (!included) return false;
+        for (auto& exclusion : excluded_) {
+            if (exclusion.has(exclusion.store, entity)) return false;
+        }
+        return !watch_.retiring(entity);
+    }
+
+private:
+    std::array<size_t, sizeof...(Components)> current_sizes() const {
+        return std::apply([](auto*... stores) { return std::array<size_t, sizeof...(Components)>{stores->entities_.size()...}; }, stores_);
+    }
+
+    bool stale() const {
+        if (current_sizes() != included_sizes_) return true;
+        for (size_t index = 0; index < excluded_.size(); ++index) {
+            if (excluded_[index].size(excluded_[index].store) != excluded_sizes_[index]) return true;
+        }
+        for (size_t index = 0; index < written_.size(); ++index) {
+            if (written_[index]->value_ != seen_[index]) return true;
+        }
+        return false;
+    }
+
+    const std::vector<uint32_t>& smallest_entities() const {
+        const std::vector<uint32_t>* smallest = nullptr;
+        std::apply([&smallest](auto*... stores) {
+            ((smallest = !smallest || stores->entities_.size() < smallest->size() ? &stores->entities_ : smallest), ...);
+        }, stores_);
+        return *smallest;
+    }
+
+    void rebuild() {
+        matches_.clear();
+        match_index_.clear();
+        for (uint32_t entity : smallest_entities()) {
+            if (!matches(entity)) continue;
+            match_index_.emplace(entity, matches_.size());
+            matches_.push_back(entity);
+        }
+        included_sizes_ = current_sizes();
+        excluded_sizes_.clear();
+        for (auto& exclusion : excluded_) {
+            excluded_sizes_.push_back(exclusion.size(exclusion.store));
+        }
+        seen_.clear();
+        for (auto* written : written_) {
+            seen_.push_back(written->value_);
+        }
+        dirty_ = false;
+        ++rebuilds_;
+    }
+
+    std::tuple<Components*...> resolve(uint32_t entity) const {
+        return std::apply([entity](auto*... stores) {
+            std::tuple<Components*...> components{&stores->get(entity)...};
+            std::apply([](auto*... pointers) { (__builtin_prefetch(pointers), ...); }, components);
+            return components;
+        }, stores_);
+    }
+
+    template<typename Fn>
+    void visit(std::span<const uint32_t> entities, Fn& fn) const {
+        std::array<std::tuple<Components*...>, lookahead> ahead;
+        size_t primed = std::min(entities.size(), lookahead);
+        for (size_t index = 0; index < primed; ++index) {
+            ahead[index] = resolve(entities[index]);
+        }
+        for (size_t index = 0; index < entities.size(); ++index) {
+            auto current = ahead[index % lookahead];
+            if (index + lookahead < entities.size()) {
+                ahead[index % lookahead] = resolve(entities[index + lookahead]);
+            }
+            std::apply([&](Components*... components) { fn(entities[index], *components...); }, current);
+        }
+    }
+
+    void forget(uint32_t entity) {
+        if (dirty_) return;
+        size_t store = 0;
+        std::apply([&](auto*... stores) { ((included_sizes_[store++] -= stores->has(entity) ? 1 : 0), ...); }, stores_);
+        for (size_t index = 0; index < excluded_.size(); ++index) {
+            if (excluded_[index].has(excluded_[index].store, entity)) --excluded_sizes_[index];
+        }
+        unmatch(entity);
+    }
+
+    void retire(uint32_t entity) {
+        if (dirty_) return;
+        unmatch(entity);
+    }
+
+    void unmatch(uint32_t entity) {
+        auto found = match_index_.find(entity);
+        if (found == match_index_.end()) return;
+        size_t index = found->second;
+        uint32_t moved = matches_.back();
+        matches_[index] = moved;
+        match_index_[moved] = index;
+        matches_.pop_back();
+        match_index_.erase(entity);
+    }
+
+    static void forget_entity(void* query, uint32_t entity) {
+        static_cast<Query*>(query)->forget(entity);
+    }
+
+    static void retire_entity(void* query, uint32_t entity) {
+        static_cast<Query*>(query)->retire(entity);
+    }
+};
+
+}
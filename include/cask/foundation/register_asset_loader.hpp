@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cask/world.hpp>
+#include <cask/resource/resource_descriptor.hpp>
+#include <cask/resource/resource_loader_registry.hpp>
+#include <cask/foundation/pack_archive.hpp>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace cask {
+
+template<typename Resource>
+using AssetDecodeFn = std::function<Resource(std::span<const uint8_t> bytes, const nlohmann::json& entry)>;
+
+template<typename Resource>
+typename ResourceLoaderRegistry<Resource>::LoaderFn asset_loader(const AssetReader* reader, AssetDecodeFn<Resource> decode, std::string path_field = "path") {
+    return [reader, decode = std::move(decode), path_field = std::move(path_field)](const nlohmann::json& entry) -> Resource {
+        std::string path = entry[path_field].template get<std::string>();
+        auto asset = reader->read(path);
+        if (!asset.found()) throw std::runtime_error("asset not found: " + path);
+        return decode(asset.bytes, entry);
+    };
+}
+
+template<typename Resource>
+bool register_asset_loader(WorldView& world, const std::string& name, AssetDecodeFn<Resource> decode) {
+    auto* reader = world.resolve<AssetReader>("AssetReader");
+    auto* loaders = world.resolve<ResourceLoaderRegistry<Resource>>(ResourceDescriptor<Resource>::loader_registry);
+    if (!reader || !loaders) return false;
+    loaders->add(name, asset_loader<Resource>(reader, std::move(decode)));
+    return true;
+}
+
+}
@@ -3,6 +3,8 @@
 #include <cask/world.hpp>
 #include <cask/ecs/component_store.hpp>
 #include <cask/ecs/entity_compactor.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/store_defragmenter.hpp>
 
 namespace cask {
 
@@ -11,7 +13,16 @@ ComponentStore<Component>* register_component_store(WorldView& world, const char
     auto* store = world.register_component<ComponentStore<Component>>(name);
     auto* compactor = world.resolve<EntityCompactor>("EntityCompactor");
     compactor->add(store, remove_component<Component>);
+    track_memory(world, name, store);
+    if (auto* defragmenter = world.resolve<StoreDefragmenter>("StoreDefragmenter")) defragmenter->add(store);
     return store;
 }
 
+inline void unregister_component_store(WorldHandle handle, const char* name, const void* store) {
+    untrack_memory(handle, name);
+    if (auto* defragmenter = static_cast<StoreDefragmenter*>(world_resolve_component(handle, "StoreDefragmenter"))) {
+        defragmenter->remove(store);
+    }
+}
+
 }
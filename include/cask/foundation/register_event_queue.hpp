@@ -3,6 +3,11 @@
 #include <cask/world.hpp>
 #include <cask/event/event_queue.hpp>
 #include <cask/event/event_swapper.hpp>
+#include <cask/foundation/event_cursor.hpp>
+#include <cask/foundation/event_queue_catalog.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <cask/foundation/rollback.hpp>
 
 namespace cask {
 
@@ -11,7 +16,36 @@ EventQueue<Event>* register_event_queue(WorldView& world, const char* name) {
     auto* queue = world.register_component<EventQueue<Event>>(name);
     auto* swapper = world.resolve<EventSwapper>("EventSwapper");
     swapper->add(queue, swap_queue<Event>);
+    if (auto* generations = world.resolve<EventGenerations>("EventGenerations")) {
+        auto* generation = generations->add(queue);
+        swapper->add(generation, advance_generation);
+        track_rollback(world, generation);
+    }
+    if (auto* catalog = world.resolve<EventQueueCatalog>("EventQueueCatalog")) {
+        catalog->add(name, queue);
+    }
+    track_memory(world, name, queue);
+    track_rollback(world, queue);
+    observe_event_queue(world, name, queue);
     return queue;
 }
 
+inline void unobserve_event_queue(WorldHandle handle, const void* queue) {
+    if (auto* catalog = static_cast<EventQueueCatalog*>(world_resolve_component(handle, "EventQueueCatalog"))) {
+        catalog->remove(queue);
+    }
+    if (auto* metrics = resolve_metrics(handle)) {
+        metrics->forget_queue(queue);
+    }
+    untrack_rollback(handle, queue);
+    if (auto* generations = static_cast<EventGenerations*>(world_resolve_component(handle, "EventGenerations"))) {
+        untrack_rollback(handle, generations->find(queue));
+    }
+}
+
+inline void unregister_event_queue(WorldHandle handle, const char* name, const void* queue) {
+    unobserve_event_queue(handle, queue);
+    untrack_memory(handle, name);
+}
+
 }
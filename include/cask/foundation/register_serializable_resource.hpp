@@ -8,6 +8,11 @@
 #include <cask/schema/serialization_registry.hpp>
 #include <cask/schema/describe_resource_sources.hpp>
 #include <cask/schema/describe_resource_components.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/shared_resources.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <string>
+#include <vector>
 
 namespace cask {
 
@@ -17,8 +22,33 @@ ResourceSources<Resource>* register_serializable_resource(WorldView& world) {
     auto* store = world.resolve<ResourceStore<Resource>>(ResourceDescriptor<Resource>::store);
     auto* loader_registry = world.resolve<ResourceLoaderRegistry<Resource>>(ResourceDescriptor<Resource>::loader_registry);
     auto* sources = world.register_component<ResourceSources<Resource>>(ResourceDescriptor<Resource>::sources);
+    track_memory(world, ResourceDescriptor<Resource>::sources, sources);
 
-    auto sources_entry = describe_resource_sources<Resource>(ResourceDescriptor<Resource>::sources, *store, *loader_registry);
+    auto* view = world.resolve<SharedResourceView<Resource>>(shared_view_name<Resource>().c_str());
+    auto sources_entry = describe_resource_sources<Resource>(ResourceDescriptor<Resource>::sources, view ? view->incoming_ : *store, *loader_registry);
+    if (view) {
+        sources_entry.deserialize = [deserialize = sources_entry.deserialize, view](const nlohmann::json& data, void* target, const nlohmann::json& context) {
+            nlohmann::json result;
+            view->merge([&] {
+                result = deserialize(data, target, context);
+                std::vector<std::string> keys;
+                for (auto& [key, entry] : static_cast<ResourceSources<Resource>*>(target)->entries) {
+                    keys.push_back(key);
+                }
+                return keys;
+            });
+            return result;
+        };
+    }
+    auto* generations = world.resolve<StoreGenerations>("StoreGenerations");
+    if (generations) {
+        generations->track(sources);
+        sources_entry.deserialize = [deserialize = sources_entry.deserialize, generations, sources](const nlohmann::json& data, void* target, const nlohmann::json& context) {
+            auto result = deserialize(data, target, context);
+            generations->touch(sources);
+            return result;
+        };
+    }
     auto components_entry = describe_resource_components<Resource>(ResourceDescriptor<Resource>::components, ResourceDescriptor<Resource>::sources, *store);
 
     registry->add(ResourceDescriptor<Resource>::sources, sources_entry);
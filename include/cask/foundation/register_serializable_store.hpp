@@ -5,6 +5,11 @@
 #include <cask/ecs/entity_compactor.hpp>
 #include <cask/schema/serialization_registry.hpp>
 #include <cask/schema/describe_component_store.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/prefab.hpp>
+#include <cask/foundation/rollback.hpp>
+#include <cask/foundation/store_defragmenter.hpp>
+#include <cask/foundation/store_generations.hpp>
 #include <string>
 
 namespace cask {
@@ -14,15 +19,44 @@ ComponentStore<T>* register_serializable_store(WorldView& world, const char* nam
     auto* compactor = world.resolve<EntityCompactor>("EntityCompactor");
     auto* store = world.register_component<ComponentStore<T>>(name);
     compactor->add(store, remove_component<T>);
+    track_memory(world, name, store);
+    track_rollback(world, store);
+    if (auto* defragmenter = world.resolve<StoreDefragmenter>("StoreDefragmenter")) defragmenter->add(store);
 
     auto store_entry = describe_component_store<T>(name, value_entry);
+    auto* generations = world.resolve<StoreGenerations>("StoreGenerations");
+    if (generations) {
+        generations->track(store);
+        store_entry.deserialize = [deserialize = store_entry.deserialize, generations](const nlohmann::json& data, void* target, const nlohmann::json& context) {
+            auto result = deserialize(data, target, context);
+            generations->touch(target);
+            return result;
+        };
+    }
     auto* registry = world.resolve<SerializationRegistry>("SerializationRegistry");
 
     std::string value_name = value_entry.schema["name"];
     registry->add(value_name, value_entry);
     registry->add(name, store_entry);
 
+    auto* prefabs = world.resolve<Prefabs>("Prefabs");
+    if (prefabs) prefabs->add_store(name, store, value_entry);
+
     return store;
 }
 
+inline void unregister_serializable_store(WorldHandle handle, const char* name, const void* store) {
+    untrack_rollback(handle, store);
+    untrack_memory(handle, name);
+    if (auto* generations = static_cast<StoreGenerations*>(world_resolve_component(handle, "StoreGenerations"))) {
+        generations->untrack(store);
+    }
+    if (auto* prefabs = static_cast<Prefabs*>(world_resolve_component(handle, "Prefabs"))) {
+        prefabs->remove_store(name);
+    }
+    if (auto* defragmenter = static_cast<StoreDefragmenter*>(world_resolve_component(handle, "StoreDefragmenter"))) {
+        defragmenter->remove(store);
+    }
+}
+
 }
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace cask {
+
+struct RollbackTrack {
+    void* target;
+    std::vector<std::shared_ptr<void>> slots;
+    void (*save)(void* slot, const void* target);
+    void (*restore)(void* target, const void* slot);
+    std::shared_ptr<void> (*make_slot)();
+};
+
+template<typename T>
+std::shared_ptr<void> make_rollback_slot() {
+    return std::make_shared<T>();
+}
+
+template<typename T>
+void save_copy(void* slot, const void* target) {
+    *static_cast<T*>(slot) = *static_cast<const T*>(target);
+}
+
+template<typename T>
+void restore_copy(void* target, const void* slot) {
+    *static_cast<T*>(target) = *static_cast<const T*>(slot);
+}
+
+struct Rollback {
+    std::vector<RollbackTrack> tracks_;
+    std::vector<std::optional<uint64_t>> ticks_;
+    size_t saves_ = 0;
+    size_t restores_ = 0;
+    StoreGenerations* generations_ = nullptr;
+
+    explicit Rollback(size_t capacity = 8)
+        : ticks_(std::max<size_t>(capacity, 1)) {}
+
+    size_t capacity() const {
+        return ticks_.size();
+    }
+
+    bool resize(size_t capacity) {
+        if (capacity == 0) return false;
+        ticks_.assign(capacity, std::nullopt);
+        for (auto& track : tracks_) {
+            allocate(track);
+        }
+        return true;
+    }
+
+    size_t tracked() const {
+        return tracks_.size();
+    }
+
+    bool tracks(const void* target) const {
+        return std::any_of(tracks_.begin(), tracks_.end(), [target](const RollbackTrack& track) { return track.target == target; });
+    }
+
+    template<typename T>
+    void track(T* target) {
+        for (auto& track : tracks_) {
+            if (track.target == target) return;
+        }
+        tracks_.push_back(RollbackTrack{target, {}, save_copy<T>, restore_copy<T>, make_rollback_slot<T>});
+        allocate(tracks_.back());
+        std::fill(ticks_.begin(), ticks_.end(), std::nullopt);
+    }
+
+    void untrack(const void* target) {
+        std::erase_if(tracks_, [target](const RollbackTrack& track) { return track.target == target; });
+    }
+
+    void save(uint64_t tick) {
+        size_t slot = tick % ticks_.size();
+        for (auto& track : tracks_) {
+            track.save(track.slots[slot].get(), track.target);
+        }
+        ticks_[slot] = tick;
+        ++saves_;
+    }
+
+    bool has(uint64_t tick) const {
+        return ticks_[tick % ticks_.size()] == tick;
+    }
+
+    bool restore(uint64_t tick) {
+        if (!has(tick)) return false;
+        size_t slot = tick % ticks_.size();
+        for (auto& track : tracks_) {
+            track.restore(track.target, track.slots[slot].get());
+            if (generations_) generations_->touch(track.target);
+        }
+        for (auto& saved : ticks_) {
+            if (saved && *saved > tick) saved.reset();
+        }
+        ++restores_;
+        return true;
+    }
+
+    std::optional<uint64_t> oldest() const {
+        std::optional<uint64_t> found;
+        for (auto& saved : ticks_) {
+            if (saved && (!found || *saved < *found)) found = saved;
+        }
+        return found;
+    }
+
+    std::optional<uint64_t> newest() const {
+        std::optional<uint64_t> found;
+        for (auto& saved : ticks_) {
+            if (saved && (!found || *saved > *found)) found = saved;
+        }
+        return found;
+    }
+
+private:
+    void allocate(RollbackTrack& track) {
+        track.slots.clear();
+        for (size_t slot = 0; slot < ticks_.size(); ++slot) {
+            track.slots.push_back(track.make_slot());
+        }
+    }
+};
+
+template<typename T>
+void track_rollback(WorldView& world, T* component) {
+    auto* rollback = world.resolve<Rollback>("Rollback");
+    if (!rollback) return;
+    if (!rollback->generations_) rollback->generations_ = world.resolve<StoreGenerations>("StoreGenerations");
+    rollback->track(component);
+}
+
+inline void untrack_rollback(WorldHandle handle, const void* component) {
+    auto* rollback = static_cast<Rollback*>(world_resolve_component(handle, "Rollback"));
+    if (!rollback) return;
+    rollback->untrack(component);
+}
+
+}
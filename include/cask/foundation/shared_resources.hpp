@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cask/world.hpp>
+#include <cask/resource/resource_descriptor.hpp>
+#include <cask/resource/resource_store.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+template<typename Resource>
+void write_resource(ResourceStore<Resource>& store, const std::string& key, uint32_t handle, Resource resource) {
+    if (store.resources_.size() <= handle) store.resources_.resize(handle + 1);
+    store.resources_[handle] = std::move(resource);
+    store.key_to_handle_[key] = handle;
+}
+
+template<typename Resource>
+void seed_draft(ResourceStore<Resource>& draft, const ResourceStore<Resource>& from, const std::unordered_map<std::string, uint32_t>& pending) {
+    draft.key_to_handle_ = from.key_to_handle_;
+    draft.key_to_handle_.insert(pending.begin(), pending.end());
+    draft.resources_.clear();
+    draft.resources_.resize(from.resources_.size() + pending.size());
+}
+
+struct SharedResources {
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<void>> stores_;
+    std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> pending_;
+    std::vector<std::function<void()>> staged_;
+
+    template<typename Resource>
+    std::shared_ptr<ResourceStore<Resource>> store() {
+        std::lock_guard lock(mutex_);
+        auto& slot = stores_[ResourceDescriptor<Resource>::store];
+        if (!slot) slot = std::make_shared<ResourceStore<Resource>>();
+        return std::static_pointer_cast<ResourceStore<Resource>>(slot);
+    }
+
+    template<typename Resource, typename LoadFn>
+    uint32_t load(const std::string& key, LoadFn&& load_resource) {
+        auto shared = store<Resource>();
+        std::lock_guard lock(mutex_);
+        auto found = shared->key_to_handle_.find(key);
+        if (found != shared->key_to_handle_.end()) return found->second;
+        auto& pending = pending_[ResourceDescriptor<Resource>::store];
+        auto staged = pending.find(key);
+        if (staged != pending.end()) return staged->second;
+        uint32_t handle = uint32_t(shared->resources_.size() + pending.size());
+        pending.emplace(key, handle);
+        stage_write(shared, key, handle, load_resource());
+        return handle;
+    }
+
+    template<typename Resource>
+    void stage(const std::string& key, Resource resource) {
+        auto shared = store<Resource>();
+        auto staged = std::make_shared<Resource>(std::move(resource));
+        std::lock_guard lock(mutex_);
+        staged_.push_back([shared, key, staged] {
+            auto found = shared->key_to_handle_.find(key);
+            if (found == shared->key_to_handle_.end()) return;
+            shared->resources_[found->second] = std::move(*staged);
+        });
+    }
+
+    template<typename Resource, typename Fill>
+    void merge(ResourceStore<Resource>& draft, Fill&& fill) {
+        auto shared = store<Resource>();
+        std::lock_guard lock(mutex_);
+        auto& pending = pending_[ResourceDescriptor<Resource>::store];
+        seed_draft(draft, *shared, pending);
+        size_t base = draft.resources_.size();
+        for (auto& key : fill()) {
+            auto found = draft.key_to_handle_.find(key);
+            if (found == draft.key_to_handle_.end()) continue;
+            if (found->second >= base) pending.emplace(key, found->second);
+            stage_write(shared, key, found->second, std::move(draft.resources_[found->second]));
+        }
+        draft = ResourceStore<Resource>{};
+    }
+
+    size_t apply_staged() {
+        std::lock_guard lock(mutex_);
+        for (auto& apply : staged_) {
+            apply();
+        }
+        size_t applied = staged_.size();
+        staged_.clear();
+        pending_.clear();
+        return applied;
+    }
+
+    size_t staged() {
+        std::lock_guard lock(mutex_);
+        return staged_.size();
+    }
+
+    template<typename Resource>
+    size_t viewers() {
+        std::lock_guard lock(mutex_);
+        auto found = stores_.find(ResourceDescriptor<Resource>::store);
+        if (found == stores_.end()) return 0;
+        return size_t(found->second.use_count() - 1);
+    }
+
+private:
+    template<typename Resource>
+    void stage_write(std::shared_ptr<ResourceStore<Resource>> shared, const std::string& key, uint32_t handle, Resource resource) {
+        auto staged = std::make_shared<Resource>(std::move(resource));
+        staged_.push_back([shared, key, handle, staged] {
+            write_resource(*shared, key, handle, std::move(*staged));
+        });
+    }
+};
+
+template<typename Resource>
+std::string shared_view_name() {
+    return std::string(ResourceDescriptor<Resource>::store) + "View";
+}
+
+template<typename Resource>
+struct SharedResourceView {
+    SharedResources* cache_ = nullptr;
+    std::shared_ptr<ResourceStore<Resource>> shared_;
+    std::unique_ptr<ResourceStore<Resource>> local_;
+    ResourceStore<Resource> incoming_;
+    uint32_t store_id_ = 0;
+
+    ResourceStore<Resource>* store() const {
+        return local_ ? local_.get() : shared_.get();
+    }
+
+    bool detached() const {
+        return local_ != nullptr;
+    }
+
+    template<typename Fill>
+    void merge(Fill&& fill) {
+        if (!local_) {
+            cache_->template merge<Resource>(incoming_, std::forward<Fill>(fill));
+            return;
+        }
+        seed_draft(incoming_, *local_, {});
+        for (auto& key : fill()) {
+            auto found = incoming_.key_to_handle_.find(key);
+            if (found == incoming_.key_to_handle_.end()) continue;
+            write_resource(*local_, key, found->second, std::move(incoming_.resources_[found->second]));
+        }
+        incoming_ = ResourceStore<Resource>{};
+    }
+};
+
+template<typename Resource>
+ResourceStore<Resource>* register_shared_resource_store(WorldView& world, const char* view_name) {
+    auto* shared = world.resolve<SharedResources>("SharedResources");
+    if (!shared) return world.register_component<ResourceStore<Resource>>(ResourceDescriptor<Resource>::store);
+    auto* view = world.register_component<SharedResourceView<Resource>>(view_name);
+    view->cache_ = shared;
+    view->shared_ = shared->store<Resource>();
+    view->store_id_ = world.register_component(ResourceDescriptor<Resource>::store);
+    world.bind(view->store_id_, view->shared_.get());
+    return view->shared_.get();
+}
+
+template<typename Resource>
+ResourceStore<Resource>* detach_resource_store(WorldView& world, const char* view_name) {
+    auto* view = world.resolve<SharedResourceView<Resource>>(view_name);
+    if (!view) return world.resolve<ResourceStore<Resource>>(ResourceDescriptor<Resource>::store);
+    if (!view->local_) {
+        std::lock_guard lock(view->cache_->mutex_);
+        view->local_ = std::make_unique<ResourceStore<Resource>>(*view->shared_);
+        world.bind(view->store_id_, view->local_.get());
+    }
+    return view->local_.get();
+}
+
+template<typename Resource>
+uint32_t override_resource(WorldView& world, const char* view_name, const std::string& key, Resource resource) {
+    auto* store = detach_resource_store<Resource>(world, view_name);
+    auto found = store->key_to_handle_.find(key);
+    if (found != store->key_to_handle_.end()) {
+        store->resources_[found->second] = std::move(resource);
+        return found->second;
+    }
+    uint32_t handle = uint32_t(store->resources_.size());
+    store->resources_.push_back(std::move(resource));
+    store->key_to_handle_.emplace(key, handle);
+    return handle;
+}
+
+template<typename Resource, typename LoadFn>
+uint32_t load_resource(WorldView& world, const char* view_name, const std::string& key, LoadFn&& load) {
+    auto* view = world.resolve<SharedResourceView<Resource>>(view_name);
+    if (view && !view->detached()) return view->cache_->template load<Resource>(key, std::forward<LoadFn>(load));
+    auto* store = view ? view->local_.get() : world.resolve<ResourceStore<Resource>>(ResourceDescriptor<Resource>::store);
+    auto found = store->key_to_handle_.find(key);
+    if (found != store->key_to_handle_.end()) return found->second;
+    uint32_t handle = uint32_t(store->resources_.size());
+    store->resources_.push_back(load());
+    store->key_to_handle_.emplace(key, handle);
+    return handle;
+}
+
+template<typename Resource>
+bool replace_resource(WorldView& world, const char* view_name, const std::string& key, Resource resource) {
+    auto* view = world.resolve<SharedResourceView<Resource>>(view_name);
+    if (view && !view->detached()) {
+        view->cache_->stage(key, std::move(resource));
+        return true;
+    }
+    auto* store = view ? view->local_.get() : world.resolve<ResourceStore<Resource>>(ResourceDescriptor<Resource>::store);
+    if (!store) return false;
+    auto found = store->key_to_handle_.find(key);
+    if (found == store->key_to_handle_.end()) return false;
+    store->resources_[found->second] = std::move(resource);
+    return true;
+}
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cask/abi.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace cask {
+
+inline int64_t heap_bytes_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return int64_t(mallinfo2().uordblks);
+#else
+    return 0;
+#endif
+}
+
+struct InitSample {
+    std::string plugin;
+    double milliseconds = 0.0;
+    int64_t heap_bytes = 0;
+};
+
+struct StartupProfile {
+    std::vector<InitSample> samples_;
+
+    void record(const char* plugin, double milliseconds, int64_t heap_bytes) {
+        samples_.push_back(InitSample{plugin, milliseconds, heap_bytes});
+    }
+
+    const InitSample* find(const std::string& plugin) const {
+        for (auto& sample : samples_) {
+            if (sample.plugin == plugin) return &sample;
+        }
+        return nullptr;
+    }
+};
+
+struct ScopedInitProfile {
+    using Clock = std::chrono::steady_clock;
+
+    StartupProfile* profile_;
+    const char* plugin_;
+    Clock::time_point start_;
+    int64_t heap_start_ = 0;
+
+    ScopedInitProfile(WorldHandle handle, const char* plugin)
+        : profile_(static_cast<StartupProfile*>(world_resolve_component(handle, "StartupProfile")))
+        , plugin_(plugin) {
+        if (!profile_) return;
+        heap_start_ = heap_bytes_in_use();
+        start_ = Clock::now();
+    }
+
+    ~ScopedInitProfile() {
+        if (!profile_) return;
+        auto elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start_).count();
+        profile_->record(plugin_, elapsed, heap_bytes_in_use() - heap_start_);
+    }
+
+    ScopedInitProfile(const ScopedInitProfile&) = delete;
+    ScopedInitProfile& operator=(const ScopedInitProfile&) = delete;
+};
+
+struct StartupReport {
+    std::vector<std::string> critical_path;
+    double critical_path_milliseconds = 0.0;
+    double total_milliseconds = 0.0;
+    int64_t total_heap_bytes = 0;
+    std::vector<std::vector<std::string>> waves;
+};
+
+inline StartupReport build_startup_report(const StartupProfile& profile, PluginInfo* const* plugins, size_t plugin_count) {
+    std::unordered_map<std::string, size_t> definer;
+    for (size_t plugin = 0; plugin < plugin_count; ++plugin) {
+        for (size_t index = 0; index < plugins[plugin]->defines_count; ++index) {
+            definer[plugins[plugin]->defines_components[index]] = plugin;
+        }
+    }
+
+    std::vector<std::vector<size_t>> dependencies(plugin_count);
+    for (size_t plugin = 0; plugin < plugin_count; ++plugin) {
+        for (size_t index = 0; index < plugins[plugin]->requires_count; ++index) {
+            auto found = definer.find(plugins[plugin]->requires_components[index]);
+            if (found == definer.end() || found->second == plugin) continue;
+            auto& plugin_dependencies = dependencies[plugin];
+            if (std::find(plugin_dependencies.begin(), plugin_dependencies.end(), found->second) != plugin_dependencies.end()) continue;
+            plugin_dependencies.push_back(found->second);
+        }
+    }
+
+    std::vector<double> duration(plugin_count, 0.0);
+    StartupReport report;
+    for (size_t plugin = 0; plugin < plugin_count; ++plugin) {
+        const InitSample* sample = profile.find(plugins[plugin]->name);
+        if (!sample) continue;
+        duration[plugin] = sample->milliseconds;
+        report.total_milliseconds += sample->milliseconds;
+        report.total_heap_bytes += sample->heap_bytes;
+    }
+
+    constexpr size_t unvisited = SIZE_MAX;
+    constexpr size_t visiting = SIZE_MAX - 1;
+    std::vector<size_t> wave(plugin_count, unvisited);
+    std::vector<double> finish(plugin_count, 0.0);
+    std::vector<size_t> predecessor(plugin_count, unvisited);
+
+    auto visit = [&](auto& self, size_t plugin) -> void {
+        if (wave[plugin] != unvisited) return;
+        wave[plugin] = visiting;
+        size_t deepest = 0;
+        double latest = 0.0;
+        for (size_t dependency : dependencies[plugin]) {
+            self(self, dependency);
+            if (wave[dependency] == visiting) continue;
+            deepest = std::max(deepest, wave[dependency] + 1);
+            if (predecessor[plugin] != unvisited && finish[dependency] <= latest) continue;
+            latest = finish[dependency];
+            predecessor[plugin] = dependency;
+        }
+        wave[plugin] = deepest;
+        finish[plugin] = latest + duration[plugin];
+    };
+
+    size_t last = unvisited;
+    for (size_t plugin = 0; plugin < plugin_count; ++plugin) {
+        visit(visit, plugin);
+        if (report.waves.size() <= wave[plugin]) report.waves.resize(wave[plugin] + 1);
+        report.waves[wave[plugin]].push_back(plugins[plugin]->name);
+        if (last != unvisited && finish[plugin] <= finish[last]) continue;
+        last = plugin;
+    }
+
+    for (size_t plugin = last; plugin != unvisited; plugin = predecessor[plugin]) {
+        report.critical_path.insert(report.critical_path.begin(), plugins[plugin]->name);
+    }
+    if (last != unvisited) report.critical_path_milliseconds = finish[last];
+    return report;
+}
+
+inline std::string describe_startup_report(const StartupReport& report) {
+    std::string text = "startup: " + std::to_string(report.total_milliseconds) + " ms serial, "
+        + std::to_string(report.critical_path_milliseconds) + " ms critical path, "
+        + std::to_string(report.total_heap_bytes) + " heap bytes\n";
+    text += "critical path:";
+    for (auto& plugin : report.critical_path) {
+        text += " " + plugin;
+    }
+    text += "\n";
+    for (size_t wave = 0; wave < report.waves.size(); ++wave) {
+        text += "wave " + std::to_string(wave) + ":";
+        for (auto& plugin : report.waves[wave]) {
+            text += " " + plugin;
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+}
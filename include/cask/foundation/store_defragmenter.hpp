@@ -0,0 +1,393 @@
+#pragma once
+
+#include <cask/ecs/component_store.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace cask {
+
+template<typename Key, typename KeyAt>
+struct DefragOrder {
+    using Item = std::pair<Key, uint32_t>;
+    enum class Phase { scan, gather, widen, gather_prefix, sort_runs, merge, emit, done };
+    static constexpr size_t run_length = 64;
+
+    KeyAt key_at_;
+    const std::vector<uint32_t>* entities_;
+    std::vector<Item> items_;
+    std::vector<Item> scratch_;
+    Phase phase_ = Phase::done;
+    Item minimum_{};
+    size_t size_ = 0;
+    size_t cursor_ = 0;
+    size_t prefix_ = 0;
+    size_t from_ = 0;
+    size_t width_ = 0;
+    size_t left_ = 0;
+    size_t lhs_ = 0;
+    size_t rhs_ = 0;
+
+    DefragOrder(KeyAt key_at, const std::vector<uint32_t>* entities)
+        : key_at_(std::move(key_at)), entities_(entities) {}
+
+    Item item_at(size_t position) const {
+        return Item{key_at_(position), (*entities_)[position]};
+    }
+
+    void restart() {
+        phase_ = Phase::scan;
+        size_ = entities_->size();
+        cursor_ = 0;
+        prefix_ = 0;
+        items_.clear();
+    }
+
+    bool advance(std::vector<uint32_t>& target, size_t quota) {
+        for (size_t work = 0; work < quota && phase_ != Phase::done; ++work) {
+            switch (phase_) {
+            case Phase::scan: scan(); break;
+            case Phase::gather: gather(); break;
+            case Phase::widen: widen(); break;
+            case Phase::gather_prefix: gather_prefix(); break;
+            case Phase::sort_runs: sort_run(); work += run_length; break;
+            case Phase::merge: merge(); break;
+            case Phase::emit: emit(target); break;
+            case Phase::done: break;
+            }
+        }
+        return phase_ == Phase::done;
+    }
+
+private:
+    void scan() {
+        if (cursor_ + 1 < size_ && !(item_at(cursor_ + 1) < item_at(cursor_))) {
+            ++cursor_;
+            return;
+        }
+        prefix_ = size_ == 0 ? 0 : cursor_ + 1;
+        from_ = prefix_;
+        cursor_ = prefix_;
+        phase_ = prefix_ >= size_ ? Phase::done : Phase::gather;
+    }
+
+    void gather() {
+        Item item = item_at(cursor_);
+        if (items_.empty() || item < minimum_) minimum_ = item;
+        items_.push_back(std::move(item));
+        if (++cursor_ == size_) phase_ = Phase::widen;
+    }
+
+    void widen() {
+        size_t low = 0;
+        size_t high = prefix_;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (minimum_ < item_at(middle)) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        from_ = low;
+        cursor_ = from_;
+        phase_ = from_ == prefix_ ? Phase::sort_runs : Phase::gather_prefix;
+        left_ = 0;
+    }
+
+    void gather_prefix() {
+        items_.push_back(item_at(cursor_));
+        if (++cursor_ == prefix_) {
+            phase_ = Phase::sort_runs;
+            left_ = 0;
+        }
+    }
+
+    void sort_run() {
+        size_t end = std::min(left_ + run_length, items_.size());
+        std::sort(items_.begin() + left_, items_.begin() + end);
+        left_ = end;
+        if (left_ < items_.size()) return;
+        width_ = run_length;
+        begin_merge_pass();
+    }
+
+    void begin_merge_pass() {
+        if (width_ >= items_.size()) {
+            phase_ = Phase::emit;
+            cursor_ = 0;
+            return;
+        }
+        scratch_.resize(items_.size());
+        phase_ = Phase::merge;
+        left_ = 0;
+        lhs_ = 0;
+        rhs_ = std::min(width_, items_.size());
+    }
+
+    void merge() {
+        size_t middle = std::min(left_ + width_, items_.size());
+        size_t right = std::min(left_ + 2 * width_, items_.size());
+        size_t out = left_ + lhs_ + (rhs_ - (middle - left_));
+        if (out == right) {
+            left_ = right;
+            if (left_ >= items_.size()) {
+                items_.swap(scratch_);
+                width_ *= 2;
+                begin_merge_pass();
+                return;
+            }
+            lhs_ = 0;
+            rhs_ = std::min(left_ + width_, items_.size()) - left_;
+            return;
+        }
+        size_t lhs = left_ + lhs_;
+        size_t rhs = left_ + rhs_;
+        if (rhs >= right || (lhs < middle && !(items_[rhs] < items_[lhs]))) {
+            scratch_[out] = std::move(items_[lhs]);
+            ++lhs_;
+        } else {
+            scratch_[out] = std::move(items_[rhs]);
+            ++rhs_;
+        }
+    }
+
+    void emit(std::vector<uint32_t>& target) {
+        if (cursor_ == 0) target.resize(size_);
+        target[from_ + cursor_] = items_[cursor_].second;
+        if (++cursor_ == items_.size()) phase_ = Phase::done;
+    }
+};
+
+struct DefragStore {
+    void* store;
+    const std::vector<uint32_t>* entities;
+    void (*swap)(void* store, size_t first, size_t second);
+    std::shared_ptr<void> order;
+    void (*restart)(void* order);
+    bool (*advance)(void* order, std::vector<uint32_t>& target, size_t quota);
+    size_t (*from)(void* order);
+    const WriteGeneration* writes = nullptr;
+    size_t settled_size = std::numeric_limits<size_t>::max();
+    uint32_t settled_back = 0;
+    uint64_t settled_writes = 0;
+};
+
+template<typename Component>
+void swap_positions(ComponentStore<Component>& store, size_t first, size_t second) {
+    using std::swap;
+    swap(store.components_[first], store.components_[second]);
+    swap(store.entities_[first], store.entities_[second]);
+    store.sparse_[store.entities_[first]] = first;
+    store.sparse_[store.entities_[second]] = second;
+}
+
+template<typename Component>
+void swap_entities(void* store, size_t first, size_t second) {
+    swap_positions(*static_cast<ComponentStore<Component>*>(store), first, second);
+}
+
+template<typename Order>
+void restart_order(void* order) {
+    static_cast<Order*>(order)->restart();
+}
+
+template<typename Order>
+bool advance_order(void* order, std::vector<uint32_t>& target, size_t quota) {
+    return static_cast<Order*>(order)->advance(target, quota);
+}
+
+template<typename Order>
+size_t order_from(void* order) {
+    return static_cast<Order*>(order)->from_;
+}
+
+struct StoreDefragmenter {
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t none = std::numeric_limits<size_t>::max();
+    static constexpr size_t placements_per_check = 16;
+    static constexpr size_t work_per_check = 256;
+
+    std::vector<DefragStore> stores_;
+    StoreGenerations* generations_ = nullptr;
+    Clock::duration budget_ = std::chrono::microseconds(200);
+    std::vector<uint32_t> target_;
+    std::vector<uint32_t> position_;
+    size_t active_ = none;
+    size_t next_ = 0;
+    size_t cursor_ = 0;
+    size_t pass_size_ = 0;
+    uint64_t pass_writes_ = 0;
+    size_t indexed_ = 0;
+    bool ordered_ = false;
+    size_t moves_ = 0;
+    size_t passes_ = 0;
+    size_t restarts_ = 0;
+
+    template<typename Component>
+    void add(ComponentStore<Component>* store) {
+        add_ordered(store, [](size_t) { return std::monostate{}; });
+    }
+
+    template<typename Component, typename KeyFn>
+    void add(ComponentStore<Component>* store, KeyFn key) {
+        add_ordered(store, [store, key](size_t position) { return key(store->components_[position]); });
+    }
+
+    void remove(const void* store) {
+        std::erase_if(stores_, [store](const DefragStore& defrag) { return defrag.store == store; });
+        active_ = none;
+        next_ = 0;
+    }
+
+    bool tracks(const void* store) const {
+        return std::any_of(stores_.begin(), stores_.end(), [store](const DefragStore& defrag) { return defrag.store == store; });
+    }
+
+    void invalidate() {
+        for (auto& store : stores_) {
+            store.settled_size = none;
+        }
+    }
+
+    void invalidate(const void* store) {
+        for (auto& defrag : stores_) {
+            if (defrag.store == store) defrag.settled_size = none;
+        }
+    }
+
+    bool settled() const {
+        if (active_ != none) return false;
+        for (auto& store : stores_) {
+            if (!settled(store)) return false;
+        }
+        return true;
+    }
+
+    bool step() {
+        return step(budget_);
+    }
+
+    bool step(Clock::duration budget) {
+        auto deadline = Clock::now() + budget;
+        size_t placed = 0;
+        while (true) {
+            if (active_ == none && !begin_next()) return !settled();
+            auto& store = stores_[active_];
+            if (store.entities->size() != pass_size_) {
+                restart(store);
+                continue;
+            }
+            if (!ordered_) {
+                ordered_ = store.advance(store.order.get(), target_, work_per_check);
+                if (ordered_) cursor_ = indexed_ = store.from(store.order.get());
+                if (Clock::now() >= deadline) return true;
+                continue;
+            }
+            if (indexed_ < pass_size_) {
+                index(store);
+                if (Clock::now() >= deadline) return true;
+                continue;
+            }
+            if (cursor_ + 1 >= pass_size_) {
+                settle(store);
+                active_ = none;
+                ++passes_;
+                continue;
+            }
+            if (!tracked(store, target_[cursor_])) {
+                restart(store);
+                continue;
+            }
+            place(store, cursor_);
+            ++cursor_;
+            if (++placed % placements_per_check == 0 && Clock::now() >= deadline) return true;
+        }
+    }
+
+private:
+    template<typename Component, typename KeyAt>
+    void add_ordered(ComponentStore<Component>* store, KeyAt key_at) {
+        using Order = DefragOrder<decltype(key_at(size_t{})), KeyAt>;
+        DefragStore defrag{store, &store->entities_, swap_entities<Component>,
+                           std::make_shared<Order>(std::move(key_at), &store->entities_),
+                           restart_order<Order>, advance_order<Order>, order_from<Order>};
+        if (generations_) defrag.writes = generations_->track(store);
+        for (auto& existing : stores_) {
+            if (existing.store != store) continue;
+            existing = std::move(defrag);
+            active_ = none;
+            return;
+        }
+        stores_.push_back(std::move(defrag));
+    }
+
+    static bool settled(const DefragStore& store) {
+        size_t size = store.entities->size();
+        if (store.settled_size != size) return false;
+        if (size > 0 && store.settled_back != store.entities->back()) return false;
+        return !store.writes || store.writes->value_ == store.settled_writes;
+    }
+
+    void settle(DefragStore& store) const {
+        store.settled_size = store.entities->size();
+        store.settled_back = store.entities->empty() ? 0 : store.entities->back();
+        store.settled_writes = pass_writes_;
+    }
+
+    bool begin_next() {
+        for (size_t visited = 0; visited < stores_.size(); ++visited) {
+            size_t index = next_;
+            next_ = (next_ + 1) % stores_.size();
+            auto& store = stores_[index];
+            if (settled(store)) continue;
+            active_ = index;
+            restart(store);
+            return true;
+        }
+        return false;
+    }
+
+    void restart(DefragStore& store) {
+        if (ordered_) ++restarts_;
+        store.restart(store.order.get());
+        ordered_ = false;
+        pass_size_ = store.entities->size();
+        pass_writes_ = store.writes ? store.writes->value_ : 0;
+    }
+
+    void index(const DefragStore& store) {
+        size_t end = std::min(indexed_ + work_per_check, pass_size_);
+        for (; indexed_ < end; ++indexed_) {
+            uint32_t entity = (*store.entities)[indexed_];
+            if (entity >= position_.size()) position_.resize(size_t(entity) + 1);
+            position_[entity] = uint32_t(indexed_);
+        }
+    }
+
+    bool tracked(const DefragStore& store, uint32_t entity) const {
+        if (entity >= position_.size()) return false;
+        size_t position = position_[entity];
+        return position < pass_size_ && (*store.entities)[position] == entity;
+    }
+
+    void place(DefragStore& store, size_t position) {
+        uint32_t wanted = target_[position];
+        size_t current = position_[wanted];
+        if (current == position) return;
+        uint32_t displaced = (*store.entities)[position];
+        store.swap(store.store, position, current);
+        ++moves_;
+        position_[wanted] = uint32_t(position);
+        position_[displaced] = uint32_t(current);
+    }
+};
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+struct WriteGeneration {
+    uint64_t value_ = 0;
+};
+
+struct StoreGenerations {
+    using WrittenFn = void (*)(void* observer, uint32_t entity);
+    static constexpr uint32_t all_entities = std::numeric_limits<uint32_t>::max();
+
+    std::unordered_map<const void*, std::unique_ptr<WriteGeneration>> generations_;
+    std::unordered_map<const void*, std::vector<std::pair<void*, WrittenFn>>> observers_;
+
+    const WriteGeneration* track(const void* store) {
+        auto& generation = generations_[store];
+        if (!generation) generation = std::make_unique<WriteGeneration>();
+        return generation.get();
+    }
+
+    void untrack(const void* store) {
+        generations_.erase(store);
+        observers_.erase(store);
+    }
+
+    void observe(const void* store, void* observer, WrittenFn written) {
+        track(store);
+        observers_[store].emplace_back(observer, written);
+    }
+
+    void unobserve(const void* store, const void* observer) {
+        auto found = observers_.find(store);
+        if (found == observers_.end()) return;
+        std::erase_if(found->second, [observer](const auto& entry) { return entry.first == observer; });
+        if (found->second.empty()) observers_.erase(found);
+    }
+
+    void touch(const void* store) {
+        auto found = generations_.find(store);
+        if (found == generations_.end()) return;
+        ++found->second->value_;
+        notify(store, all_entities);
+    }
+
+    void touch(const void* store, uint32_t entity) {
+        auto found = generations_.find(store);
+        if (found == generations_.end()) return;
+        ++found->second->value_;
+        notify(store, entity);
+    }
+
+    void touch(const void* store, std::span<const uint32_t> entities) {
+        auto found = generations_.find(store);
+        if (found == generations_.end() || entities.empty()) return;
+        ++found->second->value_;
+        for (uint32_t entity : entities) {
+            notify(store, entity);
+        }
+    }
+
+    uint64_t generation(const void* store) const {
+        auto found = generations_.find(store);
+        return found == generations_.end() ? 0 : found->second->value_;
+    }
+
+private:
+    void notify(const void* store, uint32_t entity) {
+        auto found = observers_.find(store);
+        if (found == observers_.end()) return;
+        for (auto& [observer, written] : found->second) {
+            written(observer, entity);
+        }
+    }
+};
+
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cask/foundation/mip_chain.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cask {
+
+using MipSourceFn = std::function<MipLevel(uint32_t level)>;
+
+struct DownsampledChain {
+    std::function<MipLevel()> decode_;
+    std::vector<MipLevel> levels_;
+    uint64_t decodes_ = 0;
+
+    explicit DownsampledChain(std::function<MipLevel()> decode)
+        : decode_(std::move(decode)) {}
+
+    MipLevel operator()(uint32_t level) {
+        if (levels_.empty()) build();
+        size_t index = std::min<size_t>(level, levels_.size() - 1);
+        if (levels_[index].pixels.empty()) {
+            build();
+            index = std::min<size_t>(level, levels_.size() - 1);
+        }
+        return std::move(levels_[index]);
+    }
+
+    void release() {
+        std::vector<MipLevel>().swap(levels_);
+    }
+
+private:
+    void build() {
+        levels_ = build_mip_chain(decode_());
+        ++decodes_;
+    }
+};
+
+inline std::shared_ptr<DownsampledChain> downsampled_source(std::function<MipLevel()> decode) {
+    return std::make_shared<DownsampledChain>(std::move(decode));
+}
+
+struct TextureStream {
+    MipSourceFn source;
+    std::function<void()> release;
+    std::vector<MipLevel> levels;
+    uint32_t requested_level = 0;
+    uint32_t resident_level = 0;
+    bool holding = false;
+};
+
+struct TextureStreamer {
+    std::unordered_map<uint32_t, TextureStream> streams_;
+    size_t byte_budget_ = 0;
+    uint64_t levels_loaded_ = 0;
+    uint64_t levels_released_ = 0;
+
+    void add(uint32_t texture, uint32_t width, uint32_t height, MipSourceFn source, std::function<void()> release = nullptr) {
+        TextureStream stream;
+        stream.source = std::move(source);
+        stream.release = std::move(release);
+        stream.levels.resize(mip_level_count(width, height));
+        stream.resident_level = uint32_t(stream.levels.size());
+        streams_[texture] = std::move(stream);
+    }
+
+    void add(uint32_t texture, uint32_t width, uint32_t height, std::shared_ptr<DownsampledChain> chain) {
+        add(texture, width, height, [chain](uint32_t level) { return (*chain)(level); }, [chain] { chain->release(); });
+    }
+
+    void remove(uint32_t texture) {
+        streams_.erase(texture);
+    }
+
+    bool request(uint32_t texture, uint32_t level) {
+        auto found = streams_.find(texture);
+        if (found == streams_.end()) return false;
+        found->second.requested_level = level;
+        return true;
+    }
+
+    bool has(uint32_t texture) const {
+        return streams_.count(texture) > 0;
+    }
+
+    const MipLevel* resident(uint32_t texture) const {
+        auto found = streams_.find(texture);
+        if (found == streams_.end() || !staged(found->second)) return nullptr;
+        return &found->second.levels[found->second.resident_level];
+    }
+
+    uint32_t resident_level(uint32_t texture) const {
+        return streams_.at(texture).resident_level;
+    }
+
+    size_t resident_bytes() const {
+        size_t total = 0;
+        for (auto& [texture, stream] : streams_) {
+            for (auto& level : stream.levels) {
+                total += level.pixels.size();
+            }
+        }
+        return total;
+    }
+
+    size_t refine_all() {
+        size_t spent = 0;
+        for (auto& [texture, stream] : streams_) {
+            if (!staged(stream)) {
+                spent += stage(stream);
+                continue;
+            }
+            if (byte_budget_ > 0 && spent >= byte_budget_) continue;
+            spent += refine(stream);
+        }
+        return spent;
+    }
+
+private:
+    static bool staged(const TextureStream& stream) {
+        return stream.resident_level < stream.levels.size();
+    }
+
+    size_t load(TextureStream& stream, uint32_t level) {
+        stream.levels[level] = stream.source(level);
+        stream.holding = true;
+        ++levels_loaded_;
+        return stream.levels[level].pixels.size();
+    }
+
+    size_t stage(TextureStream& stream) {
+        uint32_t coarsest = uint32_t(stream.levels.size()) - 1;
+        stream.resident_level = coarsest;
+        return load(stream, coarsest);
+    }
+
+    static uint32_t target_level(const TextureStream& stream) {
+        uint32_t coarsest = uint32_t(stream.levels.size()) - 1;
+        return std::min(stream.requested_level, coarsest);
+    }
+
+    void release_finer_than(TextureStream& stream, uint32_t level) {
+        for (uint32_t index = 0; index < level; ++index) {
+            if (stream.levels[index].pixels.empty()) continue;
+            std::vector<uint8_t>().swap(stream.levels[index].pixels);
+            ++levels_released_;
+        }
+    }
+
+    size_t refine(TextureStream& stream) {
+        uint32_t target = target_level(stream);
+        if (stream.resident_level > target) {
+            uint32_t next = stream.resident_level - 1;
+            size_t loaded = stream.levels[next].pixels.empty() ? load(stream, next) : 0;
+            stream.resident_level = next;
+            return loaded;
+        }
+
+        stream.resident_level = target;
+        release_finer_than(stream, target);
+        if (stream.holding && stream.release) stream.release();
+        stream.holding = false;
+        return 0;
+    }
+};
+
+}
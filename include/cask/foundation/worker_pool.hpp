@@ -0,0 +1,79 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cask {
+
+struct WorkerPool {
+    std::vector<std::jthread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    void* job_ = nullptr;
+    void (*call_)(void* job, size_t worker) = nullptr;
+    uint64_t round_ = 0;
+    size_t active_ = 0;
+    size_t pending_ = 0;
+    bool stopping_ = false;
+
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        threads_.clear();
+    }
+
+    size_t size() const {
+        return threads_.size();
+    }
+
+    template<typename Fn>
+    void run(size_t workers, Fn& fn) {
+        size_t helpers = workers - 1;
+        while (threads_.size() < helpers) {
+            threads_.emplace_back([this, index = threads_.size(), seen = round_] { serve(index, seen); });
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            call_ = [](void* job, size_t worker) { (*static_cast<Fn*>(job))(worker); };
+            active_ = helpers;
+            pending_ = helpers;
+            ++round_;
+        }
+        wake_.notify_all();
+        fn(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    void serve(size_t index, uint64_t seen) {
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || round_ != seen; });
+            if (stopping_) return;
+            seen = round_;
+            if (index >= active_) continue;
+            void* job = job_;
+            auto* call = call_;
+            lock.unlock();
+            call(job, index + 1);
+            lock.lock();
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+};
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cask/abi.h>
+#include <cask/world/world.hpp>
+#include <cask/world/abi_internal.hpp>
+#include <cask/foundation/worker_pool.hpp>
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace cask {
+
+struct HostedWorld {
+    World world;
+    WorldHandle handle;
+
+    HostedWorld()
+        : handle(handle_from_world(&world)) {}
+};
+
+struct HarnessReport {
+    size_t worlds = 0;
+    size_t threads = 0;
+    size_t ticks = 0;
+    double seconds = 0.0;
+    double world_ticks_per_second = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double p999_us = 0.0;
+    double max_us = 0.0;
+};
+
+inline double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t index = size_t(fraction * double(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+struct WorldHarness {
+    using Clock = std::chrono::steady_clock;
+    using SetupFn = std::function<void(HostedWorld&, size_t)>;
+
+    std::vector<PluginInfo*> plugins_;
+    std::vector<std::unique_ptr<HostedWorld>> worlds_;
+    std::function<void()> between_ticks_;
+    float frame_alpha_ = 1.0f;
+    float frame_delta_ = 1.0f / 60.0f;
+    WorkerPool pool_;
+
+    explicit WorldHarness(std::vector<PluginInfo*> plugins)
+        : plugins_(std::move(plugins)) {}
+
+    WorldHarness(const WorldHarness&) = delete;
+    WorldHarness& operator=(const WorldHarness&) = delete;
+
+    ~WorldHarness() {
+        shutdown();
+    }
+
+    void spawn(size_t count, const SetupFn& setup = nullptr) {
+        worlds_.reserve(worlds_.size() + count);
+        for (size_t index = 0; index < count; ++index) {
+            auto hosted = std::make_unique<HostedWorld>();
+            if (setup) setup(*hosted, worlds_.size());
+            for (auto* plugin : plugins_) {
+                if (plugin->init_fn) plugin->init_fn(hosted->handle);
+            }
+            worlds_.push_back(std::move(hosted));
+        }
+    }
+
+    size_t size() const {
+        return worlds_.size();
+    }
+
+    void tick_world(HostedWorld& hosted) const {
+        for (auto* plugin : plugins_) {
+            if (plugin->tick_fn) plugin->tick_fn(hosted.handle);
+        }
+        for (auto* plugin : plugins_) {
+            if (plugin->frame_fn) plugin->frame_fn(hosted.handle, frame_alpha_, frame_delta_);
+        }
+    }
+
+    HarnessReport step(size_t ticks, size_t threads = std::thread::hardware_concurrency()) {
+        threads = std::max<size_t>(1, std::min(threads, worlds_.size()));
+        std::vector<std::vector<double>> samples(threads);
+        auto synchronize = [this]() noexcept {
+            if (between_ticks_) between_ticks_();
+        };
+        std::barrier tick_done{std::ptrdiff_t(threads), synchronize};
+        auto work = [&](size_t worker) {
+            samples[worker].reserve(ticks * (worlds_.size() / threads + 1));
+            for (size_t tick = 0; tick < ticks; ++tick) {
+                for (size_t index = worker; index < worlds_.size(); index += threads) {
+                    auto start = Clock::now();
+                    tick_world(*worlds_[index]);
+                    samples[worker].push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                }
+                tick_done.arrive_and_wait();
+            }
+        };
+        auto start = Clock::now();
+        pool_.run(threads, work);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<double> latencies;
+        for (auto& worker : samples) {
+            latencies.insert(latencies.end(), worker.begin(), worker.end());
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        HarnessReport report;
+        report.worlds = worlds_.size();
+        report.threads = threads;
+        report.ticks = ticks;
+        report.seconds = seconds;
+        report.world_ticks_per_second = seconds > 0.0 ? double(latencies.size()) / seconds : 0.0;
+        report.p50_us = percentile(latencies, 0.50);
+        report.p99_us = percentile(latencies, 0.99);
+        report.p999_us = percentile(latencies, 0.999);
+        report.max_us = latencies.empty() ? 0.0 : latencies.back();
+        return report;
+    }
+
+    std::vector<HarnessReport> scaling(size_t ticks, size_t max_threads = std::thread::hardware_concurrency()) {
+        max_threads = std::max<size_t>(1, max_threads);
+        std::vector<HarnessReport> reports;
+        for (size_t threads = 1; threads < max_threads; threads *= 2) {
+            reports.push_back(step(ticks, threads));
+        }
+        reports.push_back(step(ticks, max_threads));
+        return reports;
+    }
+
+    void shutdown() {
+        for (auto& hosted : worlds_) {
+            for (auto plugin = plugins_.rbegin(); plugin != plugins_.rend(); ++plugin) {
+                if ((*plugin)->shutdown_fn) (*plugin)->shutdown_fn(hosted->handle);
+                for (size_t component = 0; component < (*plugin)->defines_count; ++component) {
+                    hosted->world.destroy((*plugin)->defines_components[component]);
+                }
+            }
+        }
+        worlds_.clear();
+    }
+};
+
+}
@@ -0,0 +1,39 @@
+#include <cask/abi.h>
+#include <cstddef>
+
+extern "C" PluginInfo* cask_event_plugin_info();
+extern "C" PluginInfo* cask_interpolation_plugin_info();
+extern "C" PluginInfo* cask_profiler_plugin_info();
+extern "C" PluginInfo* cask_project_plugin_info();
+extern "C" PluginInfo* cask_metrics_plugin_info();
+extern "C" PluginInfo* cask_pack_plugin_info();
+extern "C" PluginInfo* cask_entity_plugin_info();
+extern "C" PluginInfo* cask_identity_plugin_info();
+extern "C" PluginInfo* cask_serialization_plugin_info();
+extern "C" PluginInfo* cask_mesh_plugin_info();
+extern "C" PluginInfo* cask_texture_plugin_info();
+extern "C" PluginInfo* cask_spatial_plugin_info();
+extern "C" PluginInfo* cask_draw_plugin_info();
+extern "C" PluginInfo* cask_reload_plugin_info();
+
+static PluginInfo* bundled_plugins[] = {
+    cask_event_plugin_info(),
+    cask_interpolation_plugin_info(),
+    cask_profiler_plugin_info(),
+    cask_project_plugin_info(),
+    cask_metrics_plugin_info(),
+    cask_pack_plugin_info(),
+    cask_entity_plugin_info(),
+    cask_identity_plugin_info(),
+    cask_serialization_plugin_info(),
+    cask_mesh_plugin_info(),
+    cask_texture_plugin_info(),
+    cask_spatial_plugin_info(),
+    cask_draw_plugin_info(),
+    cask_reload_plugin_info()
+};
+
+extern "C" __attribute__((visibility("default"))) PluginInfo** get_plugin_infos(size_t* count) {
+    *count = sizeof(bundled_plugins) / sizeof(bundled_plugins[0]);
+    return bundled_plugins;
+}
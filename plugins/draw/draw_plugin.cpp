@@ -0,0 +1,61 @@
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/resource/resource_descriptor.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/texture_data.hpp>
+#include <cask/foundation/draw_keys.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/memory_report.hpp>
+
+struct DrawPluginState {
+    cask::DrawKeys* keys;
+    cask::ProfilerBinding profiler;
+};
+
+static void draw_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "draw");
+    cask::WorldView world(handle);
+    auto* state = world.register_component<DrawPluginState>("DrawPluginState");
+    state->keys = world.register_component<cask::DrawKeys>("DrawKeys");
+    state->keys->meshes_ = world.resolve<ComponentStore<MeshHandle>>(ResourceDescriptor<MeshData>::components);
+    state->keys->textures_ = world.resolve<ComponentStore<TextureHandle>>(ResourceDescriptor<TextureData>::components);
+    state->keys->watch(*world.resolve<cask::EntityWatchers>("EntityWatchers"));
+    state->keys->track(*world.resolve<cask::StoreGenerations>("StoreGenerations"));
+    cask::track_memory(world, "DrawKeys", state->keys);
+}
+
+static void draw_frame(WorldHandle handle, float, float) {
+    auto* state = static_cast<DrawPluginState*>(world_resolve_component(handle, "DrawPluginState"));
+    if (!state || !state->keys) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "draw_frame");
+    state->keys->build();
+}
+
+static void draw_shutdown(WorldHandle handle) {
+    auto* keys = static_cast<cask::DrawKeys*>(world_resolve_component(handle, "DrawKeys"));
+    if (keys) keys->unwatch();
+    cask::untrack_memory(handle, "DrawKeys");
+}
+
+static const char* defined_components[] = {"DrawKeys", "DrawPluginState"};
+static const char* required_components[] = {"MeshComponents", "TextureComponents", "EntityWatchers", "StoreGenerations"};
+
+static PluginInfo plugin_info = {
+    "draw",
+    defined_components,
+    required_components,
+    2,
+    4,
+    draw_init,
+    nullptr,
+    draw_frame,
+    draw_shutdown
+};
+
+extern "C" PluginInfo* get_plugin_info() {
+    return &plugin_info;
+}
@@ -4,40 +4,100 @@
 #include <cask/ecs/entity_compactor.hpp>
 #include <cask/ecs/entity_events.hpp>
 #include <cask/foundation/register_event_queue.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <cask/foundation/command_buffer.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <cask/foundation/rollback.hpp>
+#include <cask/foundation/store_defragmenter.hpp>
 
 struct EntityPluginState {
     EntityCompactor* compactor;
+    cask::AmortizedCompactor* amortized;
     EventQueue<DestroyEntity>* destroy_queue;
+    cask::CommandBuffers* commands;
+    cask::StoreDefragmenter* defragmenter;
+    cask::StoreGenerations* generations;
+    cask::Counter* compacted = nullptr;
+    cask::Histogram* compacted_per_tick = nullptr;
+    cask::Gauge* pending = nullptr;
+    bool metrics_bound = false;
+    cask::ProfilerBinding profiler;
 };
 
+static void bind_metrics(WorldHandle handle, EntityPluginState& state) {
+    state.metrics_bound = true;
+    auto* metrics = cask::resolve_metrics(handle);
+    if (!metrics) return;
+    state.compacted = &metrics->counter("cask_entities_compacted_total", "Entities removed by the compactor.");
+    state.compacted_per_tick = &metrics->histogram("cask_entities_compacted_per_tick", "Entities removed by the compactor in one tick.", {0, 1, 4, 16, 64, 256, 1024});
+    state.pending = &metrics->gauge("cask_entities_pending_compaction", "Destroyed entities whose components are still waiting for the compactor.");
+}
+
 static void entity_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "entity");
     cask::WorldView world(handle);
     auto* state = world.register_component<EntityPluginState>("EntityPluginState");
     auto* table = world.register_component<EntityTable>("EntityTable");
     state->compactor = world.register_component<EntityCompactor>("EntityCompactor");
     state->compactor->table_ = table;
+    auto* watchers = world.register_component<cask::EntityWatchers>("EntityWatchers");
+    watchers->attach(*state->compactor);
+    state->generations = world.register_component<cask::StoreGenerations>("StoreGenerations");
+    state->amortized = world.register_component<cask::AmortizedCompactor>("AmortizedCompactor");
+    watchers->attach(*state->amortized);
+    cask::track_rollback(world, state->amortized);
+    cask::track_memory(world, "EntityTable", table);
+    cask::track_rollback(world, table);
     state->destroy_queue = cask::register_event_queue<DestroyEntity>(world, "DestroyEntityQueue");
+    state->commands = world.register_component<cask::CommandBuffers>("CommandBuffers");
+    cask::track_rollback(world, state->commands);
+    state->defragmenter = world.register_component<cask::StoreDefragmenter>("StoreDefragmenter");
+    state->defragmenter->generations_ = state->generations;
 }
 
 static void entity_tick(WorldHandle handle) {
     auto* state = static_cast<EntityPluginState*>(world_resolve_component(handle, "EntityPluginState"));
-    if (!state || !state->compactor || !state->destroy_queue) return;
-    state->compactor->compact(*state->destroy_queue);
+    if (!state || !state->compactor || !state->amortized || !state->destroy_queue) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "entity_tick");
+    if (!state->metrics_bound) bind_metrics(handle, *state);
+    if (state->commands) state->commands->play(*state->compactor->table_, *state->destroy_queue, state->generations);
+    size_t destroyed = state->amortized->compact(*state->compactor, *state->destroy_queue);
+    if (state->defragmenter) state->defragmenter->step();
+    if (!state->compacted) return;
+    state->compacted->add(destroyed);
+    state->compacted_per_tick->observe(double(destroyed));
+    state->pending->set(int64_t(state->amortized->pending()));
+}
+
+static void entity_shutdown(WorldHandle handle) {
+    auto* state = static_cast<EntityPluginState*>(world_resolve_component(handle, "EntityPluginState"));
+    if (state && state->destroy_queue) cask::unregister_event_queue(handle, "DestroyEntityQueue", state->destroy_queue);
+    if (state) {
+        cask::untrack_rollback(handle, state->compactor->table_);
+        cask::untrack_rollback(handle, state->amortized);
+        cask::untrack_rollback(handle, state->commands);
+    }
+    cask::untrack_memory(handle, "EntityTable");
 }
 
-static const char* defined_components[] = {"EntityTable", "EntityCompactor", "DestroyEntityQueue", "EntityPluginState"};
+static const char* defined_components[] = {"EntityTable", "EntityCompactor", "EntityWatchers", "StoreGenerations", "DestroyEntityQueue", "CommandBuffers", "StoreDefragmenter", "AmortizedCompactor", "EntityPluginState"};
 static const char* required_components[] = {"EventSwapper"};
 
 static PluginInfo plugin_info = {
     "entity",
     defined_components,
     required_components,
-    4,
+    9,
     1,
     entity_init,
     entity_tick,
     nullptr,
-    nullptr
+    entity_shutdown
 };
 
 extern "C" PluginInfo* get_plugin_info() {
@@ -1,30 +1,39 @@
 #include <cask/abi.h>
 #include <cask/world.hpp>
 #include <cask/event/event_swapper.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/event_cursor.hpp>
+#include <cask/foundation/event_queue_catalog.hpp>
 
 struct EventPluginState {
     EventSwapper* swapper;
+    cask::ProfilerBinding profiler;
 };
 
 static void event_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "event");
     cask::WorldView world(handle);
     auto* state = world.register_component<EventPluginState>("EventPluginState");
     state->swapper = world.register_component<EventSwapper>("EventSwapper");
+    world.register_component<cask::EventGenerations>("EventGenerations");
+    world.register_component<cask::EventQueueCatalog>("EventQueueCatalog");
 }
 
 static void event_tick(WorldHandle handle) {
     auto* state = static_cast<EventPluginState*>(world_resolve_component(handle, "EventPluginState"));
     if (!state || !state->swapper) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "event_tick");
     state->swapper->swap_all();
 }
 
-static const char* defined_components[] = {"EventSwapper", "EventPluginState"};
+static const char* defined_components[] = {"EventSwapper", "EventGenerations", "EventQueueCatalog", "EventPluginState"};
 
 static PluginInfo plugin_info = {
     "event",
     defined_components,
     nullptr,
-    2,
+    4,
     0,
     event_init,
     event_tick,
@@ -3,40 +3,78 @@
 #include <cask/identity/entity_registry.hpp>
 #include <cask/ecs/entity_events.hpp>
 #include <cask/event/event_queue.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <cask/foundation/event_cursor.hpp>
+#include <cask/foundation/prefab.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/foundation/rollback.hpp>
 
 struct IdentityPluginState {
     EntityRegistry* registry;
     EventQueue<DestroyEntity>* destroy_queue;
+    cask::EventCursor<DestroyEntity> destroy_events;
+    cask::Counter* removals = nullptr;
+    bool metrics_bound = false;
+    cask::ProfilerBinding profiler;
 };
 
+static void bind_metrics(WorldHandle handle, IdentityPluginState& state) {
+    state.metrics_bound = true;
+    auto* metrics = cask::resolve_metrics(handle);
+    if (!metrics) return;
+    state.removals = &metrics->counter("cask_identity_removals_total", "Entities removed from the identity registry.");
+}
+
 static void identity_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "identity");
     cask::WorldView world(handle);
     auto* state = world.register_component<IdentityPluginState>("IdentityPluginState");
     state->registry = world.register_component<EntityRegistry>("EntityRegistry");
+    cask::track_memory(world, "EntityRegistry", state->registry);
+    cask::track_rollback(world, state->registry);
+    auto* prefabs = world.register_component<cask::Prefabs>("Prefabs");
+    prefabs->generations_ = world.resolve<cask::StoreGenerations>("StoreGenerations");
     state->destroy_queue = world.resolve<EventQueue<DestroyEntity>>("DestroyEntityQueue");
+    state->destroy_events = cask::event_cursor(world, state->destroy_queue);
+    cask::track_rollback(world, &state->destroy_events);
 }
 
 static void identity_tick(WorldHandle handle) {
     auto* state = static_cast<IdentityPluginState*>(world_resolve_component(handle, "IdentityPluginState"));
     if (!state || !state->registry || !state->destroy_queue) return;
-    for (auto& event : state->destroy_queue->poll()) {
+    cask::TraceScope trace(state->profiler.resolve(handle), "identity_tick");
+    if (!state->metrics_bound) bind_metrics(handle, *state);
+    auto events = state->destroy_events.read();
+    for (auto& event : events) {
         state->registry->remove(event.entity);
     }
+    if (state->removals) state->removals->add(events.size());
+}
+
+static void identity_shutdown(WorldHandle handle) {
+    cask::untrack_memory(handle, "EntityRegistry");
+    auto* state = static_cast<IdentityPluginState*>(world_resolve_component(handle, "IdentityPluginState"));
+    if (!state) return;
+    cask::untrack_rollback(handle, state->registry);
+    cask::untrack_rollback(handle, &state->destroy_events);
 }
 
-static const char* defined_components[] = {"EntityRegistry", "IdentityPluginState"};
+static const char* defined_components[] = {"EntityRegistry", "Prefabs", "IdentityPluginState"};
 static const char* required_components[] = {"EntityTable", "DestroyEntityQueue", "EventSwapper"};
 
 static PluginInfo plugin_info = {
     "identity",
     defined_components,
     required_components,
-    2,
+    3,
     3,
     identity_init,
     identity_tick,
     nullptr,
-    nullptr
+    identity_shutdown
 };
 
 extern "C" PluginInfo* get_plugin_info() {
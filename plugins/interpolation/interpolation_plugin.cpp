@@ -1,12 +1,16 @@
 #include <cask/abi.h>
 #include <cask/world.hpp>
 #include <cask/ecs/frame_advancer.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/frame_profiler.hpp>
 
 struct InterpolationPluginState {
     FrameAdvancer* advancer;
+    cask::ProfilerBinding profiler;
 };
 
 static void interpolation_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "interpolation");
     cask::WorldView world(handle);
     auto* state = world.register_component<InterpolationPluginState>("InterpolationPluginState");
     state->advancer = world.register_component<FrameAdvancer>("FrameAdvancer");
@@ -15,6 +19,7 @@ static void interpolation_init(WorldHandle handle) {
 static void interpolation_tick(WorldHandle handle) {
     auto* state = static_cast<InterpolationPluginState*>(world_resolve_component(handle, "InterpolationPluginState"));
     if (!state || !state->advancer) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "interpolation_tick");
     state->advancer->advance_all();
 }
 
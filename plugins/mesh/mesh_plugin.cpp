@@ -5,31 +5,60 @@
 #include <cask/resource/mesh_data.hpp>
 #include <cask/resource/resource_loader_registry.hpp>
 #include <cask/foundation/register_component_store.hpp>
+#include <cask/foundation/mesh_optimizer.hpp>
+#include <cask/foundation/mesh_instances.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/shared_resources.hpp>
 
 static void mesh_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "mesh");
     cask::WorldView world(handle);
-    world.register_component<ResourceStore<MeshData>>(ResourceDescriptor<MeshData>::store);
-    cask::register_component_store<MeshHandle>(world, ResourceDescriptor<MeshData>::components);
-    world.register_component<cask::ResourceLoaderRegistry<MeshData>>(ResourceDescriptor<MeshData>::loader_registry);
+    auto* store = cask::register_shared_resource_store<MeshData>(world, "MeshStoreView");
+    cask::track_memory(world, ResourceDescriptor<MeshData>::store, store);
+    auto* meshes = cask::register_component_store<MeshHandle>(world, ResourceDescriptor<MeshData>::components);
+    auto* instances = world.register_component<cask::MeshInstances>("MeshInstances");
+    instances->watch(meshes, *world.resolve<cask::EntityWatchers>("EntityWatchers"));
+    instances->track(*world.resolve<cask::StoreGenerations>("StoreGenerations"));
+    auto* loaders = world.register_component<cask::ResourceLoaderRegistry<MeshData>>(ResourceDescriptor<MeshData>::loader_registry);
+    auto* optimizer = world.register_component<cask::MeshOptimizer>("MeshOptimizer");
+    optimizer->wrap_loaders(*loaders);
+}
+
+static void mesh_tick(WorldHandle handle) {
+    auto* loaders = static_cast<cask::ResourceLoaderRegistry<MeshData>*>(world_resolve_component(handle, ResourceDescriptor<MeshData>::loader_registry));
+    auto* optimizer = static_cast<cask::MeshOptimizer*>(world_resolve_component(handle, "MeshOptimizer"));
+    if (!loaders || !optimizer) return;
+    optimizer->wrap_loaders(*loaders);
+}
+
+static void mesh_shutdown(WorldHandle handle) {
+    auto* instances = static_cast<cask::MeshInstances*>(world_resolve_component(handle, "MeshInstances"));
+    if (instances) instances->unwatch();
+    cask::untrack_memory(handle, ResourceDescriptor<MeshData>::store);
+    cask::unregister_component_store(handle, ResourceDescriptor<MeshData>::components, world_resolve_component(handle, ResourceDescriptor<MeshData>::components));
 }
 
 static const char* defined_components[] = {
     ResourceDescriptor<MeshData>::store,
     ResourceDescriptor<MeshData>::components,
-    ResourceDescriptor<MeshData>::loader_registry
+    ResourceDescriptor<MeshData>::loader_registry,
+    "MeshOptimizer",
+    "MeshStoreView",
+    "MeshInstances"
 };
-static const char* required_components[] = {"EntityCompactor"};
+static const char* required_components[] = {"EntityCompactor", "EntityWatchers", "StoreGenerations"};
 
 static PluginInfo plugin_info = {
     "mesh",
     defined_components,
     required_components,
+    6,
     3,
-    1,
     mesh_init,
+    mesh_tick,
     nullptr,
-    nullptr,
-    nullptr
+    mesh_shutdown
 };
 
 extern "C" PluginInfo* get_plugin_info() {
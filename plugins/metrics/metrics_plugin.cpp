@@ -0,0 +1,64 @@
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/resource/project_root.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <cask/foundation/event_queue_catalog.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <chrono>
+#include <cstdlib>
+
+struct MetricsPluginState {
+    cask::Metrics* metrics;
+    cask::ProfilerBinding profiler;
+};
+
+static void metrics_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "metrics");
+    cask::WorldView world(handle);
+    auto* state = world.register_component<MetricsPluginState>("MetricsPluginState");
+    auto* metrics = world.register_component<cask::Metrics>("Metrics");
+    state->metrics = metrics;
+    if (auto* catalog = world.resolve<cask::EventQueueCatalog>("EventQueueCatalog")) {
+        metrics->observe_catalog(*catalog);
+    }
+    const char* file = std::getenv("CASK_METRICS_FILE");
+    auto* root = world.resolve<ProjectRoot>("ProjectRoot");
+    metrics->path_ = std::filesystem::path(root->path) / (file ? file : "metrics.prom");
+    if (const char* interval = std::getenv("CASK_METRICS_INTERVAL_MS")) {
+        metrics->interval_ = std::chrono::milliseconds(std::atoll(interval));
+    }
+}
+
+static void metrics_tick(WorldHandle handle) {
+    auto* state = static_cast<MetricsPluginState*>(world_resolve_component(handle, "MetricsPluginState"));
+    if (!state || !state->metrics) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "metrics_tick");
+    state->metrics->sample_queues();
+    state->metrics->update(cask::Metrics::Clock::now());
+}
+
+static void metrics_shutdown(WorldHandle handle) {
+    auto* metrics = cask::resolve_metrics(handle);
+    if (!metrics || metrics->path_.empty()) return;
+    metrics->write_prometheus(metrics->path_);
+}
+
+static const char* defined_components[] = {"Metrics", "MetricsPluginState"};
+static const char* required_components[] = {"ProjectRoot", "EventSwapper"};
+
+static PluginInfo plugin_info = {
+    "metrics",
+    defined_components,
+    required_components,
+    2,
+    2,
+    metrics_init,
+    metrics_tick,
+    nullptr,
+    metrics_shutdown
+};
+
+extern "C" PluginInfo* get_plugin_info() {
+    return &plugin_info;
+}
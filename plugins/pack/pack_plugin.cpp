@@ -0,0 +1,33 @@
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/resource/project_root.hpp>
+#include <cask/foundation/pack_archive.hpp>
+#include <cask/foundation/startup_profile.hpp>
+
+static void pack_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "pack");
+    cask::WorldView world(handle);
+    auto* root = world.resolve<ProjectRoot>("ProjectRoot");
+    auto* reader = world.register_component<cask::AssetReader>("AssetReader");
+    reader->root_ = root->path;
+    reader->archive_.open(root->path + "/" + cask::default_pack_name);
+}
+
+static const char* defined_components[] = {"AssetReader"};
+static const char* required_components[] = {"ProjectRoot"};
+
+static PluginInfo plugin_info = {
+    "pack",
+    defined_components,
+    required_components,
+    1,
+    1,
+    pack_init,
+    nullptr,
+    nullptr,
+    nullptr
+};
+
+extern "C" PluginInfo* get_plugin_info() {
+    return &plugin_info;
+}
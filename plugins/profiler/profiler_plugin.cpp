@@ -0,0 +1,31 @@
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cstdlib>
+
+static void profiler_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "profiler");
+    cask::WorldView world(handle);
+    auto* profiler = world.register_component<cask::FrameProfiler>("FrameProfiler");
+    const char* enabled = std::getenv("CASK_FRAME_PROFILER");
+    profiler->set_enabled(enabled != nullptr && enabled[0] != '\0' && enabled[0] != '0');
+}
+
+static const char* defined_components[] = {"FrameProfiler"};
+
+static PluginInfo plugin_info = {
+    "profiler",
+    defined_components,
+    nullptr,
+    1,
+    0,
+    profiler_init,
+    nullptr,
+    nullptr,
+    nullptr
+};
+
+extern "C" PluginInfo* get_plugin_info() {
+    return &plugin_info;
+}
@@ -2,11 +2,11 @@
 #include <cask/world.hpp>
 #include <cask/resource/project_root.hpp>
 #include <cask/platform/executable_path.hpp>
+#include <cask/foundation/project_filesystem.hpp>
+#include <cask/foundation/startup_profile.hpp>
 #include <cstdlib>
 
-static void project_init(WorldHandle handle) {
-    cask::WorldView world(handle);
-
+static ProjectRoot* resolve_project_root(WorldHandle handle, cask::WorldView& world) {
     const char* env_value = std::getenv("CASK_PROJECT_ROOT");
     bool has_env = (env_value != nullptr && env_value[0] != '\0');
 
@@ -14,30 +14,45 @@ static void project_init(WorldHandle handle) {
 
     if (has_env && existing) {
         existing->path = env_value;
-        return;
+        return existing;
     }
     if (has_env) {
         auto* root = world.register_component<ProjectRoot>("ProjectRoot");
         root->path = env_value;
-        return;
+        return root;
     }
     if (existing) {
-        return;
+        return existing;
     }
     auto* root = world.register_component<ProjectRoot>("ProjectRoot");
     root->path = cask::executable_directory();
+    return root;
+}
+
+static void project_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "project");
+    cask::WorldView world(handle);
+    auto* root = resolve_project_root(handle, world);
+    auto* filesystem = world.register_component<cask::ProjectFilesystem>("ProjectFilesystem");
+    filesystem->index(root->path);
 }
 
-static const char* defined_components[] = {"ProjectRoot"};
+static void project_tick(WorldHandle handle) {
+    auto* filesystem = static_cast<cask::ProjectFilesystem*>(world_resolve_component(handle, "ProjectFilesystem"));
+    if (!filesystem) return;
+    filesystem->refresh_if_due(cask::ProjectFilesystem::Clock::now());
+}
+
+static const char* defined_components[] = {"ProjectRoot", "ProjectFilesystem"};
 
 static PluginInfo plugin_info = {
     "project",
     defined_components,
     nullptr,
-    1,
+    2,
     0,
     project_init,
-    nullptr,
+    project_tick,
     nullptr,
     nullptr
 };
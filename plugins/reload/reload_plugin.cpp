@@ -0,0 +1,97 @@
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/resource/project_root.hpp>
+#include <cask/resource/resource_store.hpp>
+#include <cask/resource/resource_sources.hpp>
+#include <cask/resource/resource_descriptor.hpp>
+#include <cask/resource/resource_loader_registry.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/texture_data.hpp>
+#include <cask/foundation/asset_reloader.hpp>
+#include <cask/foundation/shared_resources.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/metrics.hpp>
+
+struct ReloadPluginState {
+    WorldHandle handle;
+    cask::AssetReloader* reloader;
+    bool tracking_meshes = false;
+    bool tracking_textures = false;
+    cask::Counter* reloads = nullptr;
+    cask::Counter* failures = nullptr;
+    bool metrics_bound = false;
+    cask::ProfilerBinding profiler;
+};
+
+static void bind_metrics(ReloadPluginState& state) {
+    state.metrics_bound = true;
+    auto* metrics = cask::resolve_metrics(state.handle);
+    if (!metrics) return;
+    state.reloads = &metrics->counter("cask_resource_reloads_total", "Resources reloaded in place after a source change.");
+    state.failures = &metrics->counter("cask_resource_reload_failures_total", "Reloads dropped because the loader threw.");
+}
+
+template<typename Resource>
+static bool track_resource(ReloadPluginState& state, const char* view_name) {
+    auto* sources = static_cast<ResourceSources<Resource>*>(
+        world_resolve_component(state.handle, ResourceDescriptor<Resource>::sources));
+    if (!sources) return false;
+    auto* loaders = static_cast<cask::ResourceLoaderRegistry<Resource>*>(
+        world_resolve_component(state.handle, ResourceDescriptor<Resource>::loader_registry));
+    auto* generations = static_cast<cask::StoreGenerations*>(world_resolve_component(state.handle, "StoreGenerations"));
+    const cask::WriteGeneration* generation = generations ? generations->track(sources) : nullptr;
+    WorldHandle handle = state.handle;
+    state.reloader->track(sources, loaders, std::function<void(const std::string&, Resource&)>([handle, view_name](const std::string& key, Resource& resource) {
+        cask::WorldView world(handle);
+        cask::replace_resource<Resource>(world, view_name, key, std::move(resource));
+    }), generation);
+    return true;
+}
+
+static void reload_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "reload");
+    cask::WorldView world(handle);
+    auto* state = world.register_component<ReloadPluginState>("ReloadPluginState");
+    state->handle = handle;
+    state->reloader = world.register_component<cask::AssetReloader>("AssetReloader");
+    state->reloader->root_ = world.resolve<ProjectRoot>("ProjectRoot")->path;
+}
+
+static void reload_tick(WorldHandle handle) {
+    auto* state = static_cast<ReloadPluginState*>(world_resolve_component(handle, "ReloadPluginState"));
+    if (!state || !state->reloader) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "reload_tick");
+    if (!state->tracking_meshes) state->tracking_meshes = track_resource<MeshData>(*state, "MeshStoreView");
+    if (!state->tracking_textures) state->tracking_textures = track_resource<TextureData>(*state, "TextureStoreView");
+    if (!state->metrics_bound) bind_metrics(*state);
+    size_t applied = state->reloader->reloads_applied_;
+    state->reloader->update(cask::AssetReloader::Clock::now());
+    if (state->reloads) state->reloads->add(state->reloader->reloads_applied_ - applied);
+    if (state->failures) state->failures->add(state->reloader->failures_.size());
+}
+
+static const char* defined_components[] = {"AssetReloader", "ReloadPluginState"};
+static const char* required_components[] = {
+    "ProjectRoot",
+    ResourceDescriptor<MeshData>::store,
+    ResourceDescriptor<MeshData>::loader_registry,
+    ResourceDescriptor<TextureData>::store,
+    ResourceDescriptor<TextureData>::loader_registry
+};
+
+static PluginInfo plugin_info = {
+    "reload",
+    defined_components,
+    required_components,
+    2,
+    5,
+    reload_init,
+    reload_tick,
+    nullptr,
+    nullptr
+};
+
+extern "C" PluginInfo* get_plugin_info() {
+    return &plugin_info;
+}
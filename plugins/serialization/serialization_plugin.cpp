@@ -3,22 +3,30 @@
 #include <cask/schema/serialization_registry.hpp>
 #include <cask/schema/describe_entity_registry.hpp>
 #include <cask/ecs/entity_table.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/memory_report.hpp>
 
 struct SerializationPluginState {
     cask::SerializationRegistry* serialization_registry;
 };
 
 static void serialization_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "serialization");
     cask::WorldView world(handle);
 
     auto* state = world.register_component<SerializationPluginState>("SerializationPluginState");
     state->serialization_registry = world.register_component<cask::SerializationRegistry>("SerializationRegistry");
+    cask::track_memory(world, "SerializationRegistry", state->serialization_registry);
 
     auto* entity_table = world.resolve<EntityTable>("EntityTable");
     auto entity_registry_entry = cask::describe_entity_registry("EntityRegistry", *entity_table);
     state->serialization_registry->add("EntityRegistry", std::move(entity_registry_entry));
 }
 
+static void serialization_shutdown(WorldHandle handle) {
+    cask::untrack_memory(handle, "SerializationRegistry");
+}
+
 static const char* defined_components[] = {"SerializationRegistry", "SerializationPluginState"};
 static const char* required_components[] = {"EntityTable", "EntityRegistry"};
 
@@ -31,7 +39,7 @@ static PluginInfo plugin_info = {
     serialization_init,
     nullptr,
     nullptr,
-    nullptr
+    serialization_shutdown
 };
 
 extern "C" PluginInfo* get_plugin_info() {
@@ -0,0 +1,88 @@
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/resource_descriptor.hpp>
+#include <cask/foundation/bvh.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/foundation/register_component_store.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+
+struct SpatialPluginState {
+    ComponentStore<MeshHandle>* meshes;
+    ComponentStore<cask::Aabb>* world_bounds;
+    cask::MeshBounds* mesh_bounds;
+    cask::Bvh* index;
+    const cask::WriteGeneration* mesh_writes = nullptr;
+    size_t placed_meshes = 0;
+    uint64_t placed_writes = 0;
+    uint64_t known_bounds = 0;
+    cask::ProfilerBinding profiler;
+};
+
+static void place_meshes(SpatialPluginState& state) {
+    for (size_t index = 0; index < state.meshes->entities_.size(); ++index) {
+        uint32_t entity = state.meshes->entities_[index];
+        if (state.world_bounds->has(entity)) continue;
+        const cask::Aabb* bounds = state.mesh_bounds->find(state.meshes->components_[index].id);
+        if (bounds) state.world_bounds->insert(entity, *bounds);
+    }
+    state.placed_meshes = state.meshes->entities_.size();
+    state.placed_writes = state.mesh_writes ? state.mesh_writes->value_ : 0;
+    state.known_bounds = state.mesh_bounds->revision_;
+}
+
+static bool meshes_changed(const SpatialPluginState& state) {
+    if (state.meshes->entities_.size() != state.placed_meshes) return true;
+    if (state.mesh_writes && state.mesh_writes->value_ != state.placed_writes) return true;
+    return state.mesh_bounds->revision_ != state.known_bounds;
+}
+
+static void spatial_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "spatial");
+    cask::WorldView world(handle);
+    auto* state = world.register_component<SpatialPluginState>("SpatialPluginState");
+    state->meshes = world.resolve<ComponentStore<MeshHandle>>(ResourceDescriptor<MeshData>::components);
+    state->mesh_bounds = world.register_component<cask::MeshBounds>("MeshBounds");
+    state->world_bounds = cask::register_component_store<cask::Aabb>(world, "WorldBounds");
+    state->index = world.register_component<cask::Bvh>("SpatialIndex");
+    state->index->watch(*world.resolve<cask::EntityWatchers>("EntityWatchers"));
+    auto* generations = world.resolve<cask::StoreGenerations>("StoreGenerations");
+    if (generations && state->meshes) state->mesh_writes = generations->track(state->meshes);
+}
+
+static void spatial_tick(WorldHandle handle) {
+    auto* state = static_cast<SpatialPluginState*>(world_resolve_component(handle, "SpatialPluginState"));
+    if (!state || !state->index || !state->world_bounds) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "spatial_tick");
+    if (state->meshes && meshes_changed(*state)) place_meshes(*state);
+    state->index->sync(*state->world_bounds);
+}
+
+static void spatial_shutdown(WorldHandle handle) {
+    auto* state = static_cast<SpatialPluginState*>(world_resolve_component(handle, "SpatialPluginState"));
+    if (state && state->index) state->index->unwatch();
+    if (state) cask::unregister_component_store(handle, "WorldBounds", state->world_bounds);
+}
+
+static const char* defined_components[] = {"MeshBounds", "WorldBounds", "SpatialIndex", "SpatialPluginState"};
+static const char* required_components[] = {ResourceDescriptor<MeshData>::components, "EntityWatchers", "StoreGenerations"};
+
+static PluginInfo plugin_info = {
+    "spatial",
+    defined_components,
+    required_components,
+    4,
+    3,
+    spatial_init,
+    spatial_tick,
+    nullptr,
+    spatial_shutdown
+};
+
+extern "C" PluginInfo* get_plugin_info() {
+    return &plugin_info;
+}
@@ -5,18 +5,65 @@
 #include <cask/resource/resource_loader_registry.hpp>
 #include <cask/resource/texture_data.hpp>
 #include <cask/foundation/register_component_store.hpp>
+#include <cask/foundation/texture_streamer.hpp>
+#include <cask/foundation/startup_profile.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <cask/foundation/shared_resources.hpp>
+
+struct TexturePluginState {
+    cask::TextureStreamer* streamer;
+    cask::Counter* levels_loaded = nullptr;
+    cask::Counter* levels_evicted = nullptr;
+    bool metrics_bound = false;
+    cask::ProfilerBinding profiler;
+};
+
+static void bind_metrics(WorldHandle handle, TexturePluginState& state) {
+    state.metrics_bound = true;
+    auto* metrics = cask::resolve_metrics(handle);
+    if (!metrics) return;
+    state.levels_loaded = &metrics->counter("cask_texture_levels_loaded_total", "Mip levels built by the texture streamer.");
+    state.levels_evicted = &metrics->counter("cask_texture_levels_evicted_total", "Mip levels released by the texture streamer.");
+}
 
 static void texture_init(WorldHandle handle) {
+    cask::ScopedInitProfile profile(handle, "texture");
     cask::WorldView world(handle);
-    world.register_component<ResourceStore<TextureData>>(ResourceDescriptor<TextureData>::store);
+    auto* store = cask::register_shared_resource_store<TextureData>(world, "TextureStoreView");
+    cask::track_memory(world, ResourceDescriptor<TextureData>::store, store);
     cask::register_component_store<TextureHandle>(world, ResourceDescriptor<TextureData>::components);
     world.register_component<cask::ResourceLoaderRegistry<TextureData>>(ResourceDescriptor<TextureData>::loader_registry);
+    auto* state = world.register_component<TexturePluginState>("TexturePluginState");
+    state->streamer = world.register_component<cask::TextureStreamer>("TextureStreamer");
+}
+
+static void texture_tick(WorldHandle handle) {
+    auto* state = static_cast<TexturePluginState*>(world_resolve_component(handle, "TexturePluginState"));
+    if (!state || !state->streamer) return;
+    cask::TraceScope trace(state->profiler.resolve(handle), "texture_tick");
+    if (!state->metrics_bound) bind_metrics(handle, *state);
+    uint64_t loaded = state->streamer->levels_loaded_;
+    uint64_t released = state->streamer->levels_released_;
+    state->streamer->refine_all();
+    if (!state->levels_loaded) return;
+    state->levels_loaded->add(state->streamer->levels_loaded_ - loaded);
+    state->levels_evicted->add(state->streamer->levels_released_ - released);
+}
+
+static void texture_shutdown(WorldHandle handle) {
+    cask::untrack_memory(handle, ResourceDescriptor<TextureData>::store);
+    cask::unregister_component_store(handle, ResourceDescriptor<TextureData>::components, world_resolve_component(handle, ResourceDescriptor<TextureData>::components));
 }
 
 static const char* defined_components[] = {
     ResourceDescriptor<TextureData>::store,
     ResourceDescriptor<TextureData>::components,
-    ResourceDescriptor<TextureData>::loader_registry
+    ResourceDescriptor<TextureData>::loader_registry,
+    "TextureStreamer",
+    "TextureStoreView",
+    "TexturePluginState"
 };
 static const char* required_components[] = {"EntityCompactor"};
 
@@ -24,12 +71,12 @@ static PluginInfo plugin_info = {
     "texture",
     defined_components,
     required_components,
-    3,
+    6,
     1,
     texture_init,
+    texture_tick,
     nullptr,
-    nullptr,
-    nullptr
+    texture_shutdown
 };
 
 extern "C" PluginInfo* get_plugin_info() {
@@ -0,0 +1,144 @@
+#include "allocation_counter.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+static thread_local AllocationCounts counts;
+
+AllocationCounts thread_allocation_counts() {
+    return counts;
+}
+
+static void count(size_t size) {
+    ++counts.allocations;
+    counts.bytes += size;
+}
+
+static size_t product(size_t count_of, size_t size) {
+    size_t bytes = 0;
+    if (__builtin_mul_overflow(count_of, size, &bytes)) return SIZE_MAX;
+    return bytes;
+}
+
+#if defined(__GLIBC__)
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+
+extern "C" void* malloc(size_t size) {
+    count(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count_of, size_t size) {
+    count(product(count_of, size));
+    return __libc_calloc(count_of, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+    count(size);
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) {
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) {
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** pointer, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    count(size);
+    void* allocated = __libc_memalign(alignment, size);
+    if (!allocated) return ENOMEM;
+    *pointer = allocated;
+    return 0;
+}
+
+static void* counted_allocate(size_t size) {
+    count(size);
+    return __libc_malloc(size == 0 ? 1 : size);
+}
+
+static void* counted_allocate(size_t size, std::align_val_t alignment) {
+    count(size);
+    return __libc_memalign(static_cast<size_t>(alignment), size == 0 ? 1 : size);
+}
+#else
+static void* counted_allocate(size_t size) {
+    count(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* counted_allocate(size_t size, std::align_val_t alignment) {
+    count(size);
+    size_t align = static_cast<size_t>(alignment);
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+#endif
+
+void* operator new(size_t size) {
+    if (void* pointer = counted_allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* pointer = counted_allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return counted_allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* pointer = counted_allocate(size, alignment)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* pointer = counted_allocate(size, alignment)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
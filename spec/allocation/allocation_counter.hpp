@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+struct AllocationCounts {
+    size_t allocations = 0;
+    size_t bytes = 0;
+};
+
+AllocationCounts thread_allocation_counts();
+
+template<typename Fn>
+AllocationCounts count_allocations(Fn&& fn) {
+    AllocationCounts before = thread_allocation_counts();
+    std::forward<Fn>(fn)();
+    AllocationCounts after = thread_allocation_counts();
+    return AllocationCounts{after.allocations - before.allocations, after.bytes - before.bytes};
+}
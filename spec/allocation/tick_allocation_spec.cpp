@@ -0,0 +1,253 @@
+#include <catch2/catch_test_macros.hpp>
+#include "allocation_counter.hpp"
+#include <cask/abi.h>
+#include <cask/world.hpp>
+#include <cask/world/world.hpp>
+#include <cask/world/abi_internal.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/identity/entity_registry.hpp>
+#include <cask/identity/uuid.hpp>
+#include <cask/schema/serialization_registry.hpp>
+#include <cask/foundation/command_buffer.hpp>
+#include <cask/foundation/register_component_store.hpp>
+#include <cask/foundation/register_event_queue.hpp>
+#include <cask/foundation/register_interpolated.hpp>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+extern "C" PluginInfo** get_plugin_infos(size_t* count);
+
+struct SpecEvent {
+    uint32_t value;
+};
+
+struct alignas(128) OverAligned {
+    uint8_t bytes[128];
+};
+
+static PluginInfo* find_plugin(const char* name) {
+    size_t count = 0;
+    PluginInfo** plugins = get_plugin_infos(&count);
+    for (size_t index = 0; index < count; ++index) {
+        if (std::strcmp(plugins[index]->name, name) == 0) return plugins[index];
+    }
+    return nullptr;
+}
+
+struct SteadyWorld {
+    World world;
+    WorldHandle handle;
+    cask::WorldView view;
+    std::vector<PluginInfo*> plugins;
+    EntityTable* table = nullptr;
+    EntityRegistry* registry = nullptr;
+    cask::CommandBuffers* commands = nullptr;
+    EventQueue<SpecEvent>* events = nullptr;
+    Interpolated<float>* position = nullptr;
+    ComponentStore<uint32_t>* values = nullptr;
+    std::deque<uint32_t> live;
+
+    explicit SteadyWorld(std::vector<const char*> names)
+        : handle(handle_from_world(&world))
+        , view(handle) {
+        for (const char* name : names) {
+            plugins.push_back(find_plugin(name));
+        }
+    }
+
+    ~SteadyWorld() {
+        for (auto plugin = plugins.rbegin(); plugin != plugins.rend(); ++plugin) {
+            if ((*plugin)->shutdown_fn) (*plugin)->shutdown_fn(handle);
+            for (size_t component = 0; component < (*plugin)->defines_count; ++component) {
+                world.destroy((*plugin)->defines_components[component]);
+            }
+        }
+    }
+
+    void init() {
+        for (auto* plugin : plugins) {
+            plugin->init_fn(handle);
+        }
+        table = view.resolve<EntityTable>("EntityTable");
+        registry = view.resolve<EntityRegistry>("EntityRegistry");
+        commands = view.resolve<cask::CommandBuffers>("CommandBuffers");
+        events = cask::register_event_queue<SpecEvent>(view, "SpecEventQueue");
+        position = cask::register_interpolated<float>(view, "SpecPosition");
+        values = cask::register_component_store<uint32_t>(view, "SpecValues");
+        for (int count = 0; count < 64; ++count) {
+            uint32_t entity = registry->resolve(cask::generate_uuid(), *table);
+            values->insert(entity, entity);
+            live.push_back(entity);
+        }
+    }
+
+    void record() {
+        for (uint32_t value = 0; value < 8; ++value) {
+            events->emit(SpecEvent{value});
+        }
+        position->current += 1.0f;
+        auto& buffer = commands->at(0);
+        for (int count = 0; count < 4; ++count) {
+            buffer.destroy(live.front());
+            live.pop_front();
+            uint32_t created = buffer.create();
+            buffer.insert(values, created, 7u);
+        }
+    }
+
+    void collect() {
+        for (uint32_t created : commands->created_) {
+            live.push_back(created);
+        }
+    }
+
+    std::vector<AllocationCounts> tick() {
+        std::vector<AllocationCounts> counts(plugins.size());
+        for (size_t index = 0; index < plugins.size(); ++index) {
+            if (!plugins[index]->tick_fn) continue;
+            auto* tick_fn = plugins[index]->tick_fn;
+            counts[index] = count_allocations([&] { tick_fn(handle); });
+        }
+        return counts;
+    }
+};
+
+SCENARIO("allocation counting measures a scoped region", "[allocation]") {
+    GIVEN("a region that allocates a vector") {
+        WHEN("it is counted") {
+            auto counts = count_allocations([] {
+                std::vector<uint64_t> values(100);
+                values[0] = 1;
+            });
+
+            THEN("one allocation of its storage is reported") {
+                REQUIRE(counts.allocations == 1);
+                REQUIRE(counts.bytes == 100 * sizeof(uint64_t));
+            }
+        }
+    }
+
+    GIVEN("a region that makes aligned allocations") {
+        WHEN("it is counted") {
+            auto counts = count_allocations([] {
+                void* aligned = std::aligned_alloc(64, 128);
+                void* posix = nullptr;
+                REQUIRE(posix_memalign(&posix, 64, 256) == 0);
+                auto* over_aligned = new OverAligned;
+                std::free(aligned);
+                std::free(posix);
+                delete over_aligned;
+            });
+
+            THEN("aligned_alloc, posix_memalign and aligned new are each reported once") {
+                REQUIRE(counts.allocations == 3);
+                REQUIRE(counts.bytes == 128 + 256 + sizeof(OverAligned));
+            }
+        }
+    }
+
+#if defined(__GLIBC__)
+    GIVEN("a region that calls memalign") {
+        THEN("the allocation is reported") {
+            auto counts = count_allocations([] { std::free(memalign(32, 96)); });
+            REQUIRE(counts.allocations == 1);
+            REQUIRE(counts.bytes == 96);
+        }
+    }
+#endif
+
+    GIVEN("a calloc whose size overflows") {
+        THEN("it fails and is reported with saturated bytes") {
+            volatile size_t huge = SIZE_MAX / 2;
+            void* pointer = nullptr;
+            auto counts = count_allocations([&] { pointer = std::calloc(huge, 4); });
+            REQUIRE(pointer == nullptr);
+            REQUIRE(counts.allocations == 1);
+            REQUIRE(counts.bytes == SIZE_MAX);
+        }
+    }
+
+    GIVEN("a region that does not allocate") {
+        THEN("nothing is reported") {
+            auto counts = count_allocations([] {});
+            REQUIRE(counts.allocations == 0);
+            REQUIRE(counts.bytes == 0);
+        }
+    }
+}
+
+SCENARIO("core plugin ticks do not allocate once warmed up", "[allocation]") {
+    GIVEN("a world running the event, interpolation, entity and identity plugins with steady churn") {
+        SteadyWorld steady({"event", "interpolation", "entity", "identity"});
+        steady.init();
+        for (int tick = 0; tick < 32; ++tick) {
+            steady.record();
+            steady.tick();
+            steady.collect();
+        }
+
+        WHEN("more ticks run with the same churn") {
+            std::vector<AllocationCounts> totals(steady.plugins.size());
+            for (int tick = 0; tick < 64; ++tick) {
+                steady.record();
+                auto counts = steady.tick();
+                steady.collect();
+                for (size_t index = 0; index < counts.size(); ++index) {
+                    totals[index].allocations += counts[index].allocations;
+                    totals[index].bytes += counts[index].bytes;
+                }
+            }
+
+            THEN("no plugin tick allocates") {
+                for (size_t index = 0; index < steady.plugins.size(); ++index) {
+                    INFO(steady.plugins[index]->name << "_tick allocated " << totals[index].bytes << " bytes");
+                    REQUIRE(totals[index].allocations == 0);
+                }
+            }
+
+            THEN("the churn kept running") {
+                REQUIRE(steady.live.size() == 64);
+                for (uint32_t entity : steady.live) {
+                    REQUIRE(steady.table->alive(entity));
+                    REQUIRE(steady.values->has(entity));
+                }
+                REQUIRE(steady.events->poll().size() == 8);
+            }
+        }
+    }
+}
+
+SCENARIO("plugin init and serialization allocations are reported", "[allocation]") {
+    GIVEN("the core plugins and the serialization plugin") {
+        SteadyWorld steady({"event", "interpolation", "entity", "identity", "serialization"});
+
+        WHEN("each plugin is initialized") {
+            for (auto* plugin : steady.plugins) {
+                auto counts = count_allocations([&] { plugin->init_fn(steady.handle); });
+                WARN(plugin->name << "_init: " << counts.allocations << " allocations, " << counts.bytes << " bytes");
+                REQUIRE(counts.allocations > 0);
+            }
+
+            THEN("serializing the entity registry is reported") {
+                auto* table = steady.view.resolve<EntityTable>("EntityTable");
+                auto* registry = steady.view.resolve<EntityRegistry>("EntityRegistry");
+                for (int count = 0; count < 1000; ++count) {
+                    registry->resolve(cask::generate_uuid(), *table);
+                }
+                auto& entry = steady.view.resolve<cask::SerializationRegistry>("SerializationRegistry")->get("EntityRegistry");
+                size_t serialized = 0;
+                auto counts = count_allocations([&] { serialized = entry.serialize(registry).size(); });
+                WARN("EntityRegistry serialize of " << serialized << " entities: " << counts.allocations << " allocations, " << counts.bytes << " bytes");
+                REQUIRE(serialized == 1000);
+            }
+        }
+    }
+}
@@ -0,0 +1,240 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cask/abi.h>
+#include <cask/world/world.hpp>
+#include <cask/world/abi_internal.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_compactor.hpp>
+#include <cask/ecs/entity_events.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/identity/entity_registry.hpp>
+#include <cask/identity/uuid.hpp>
+#include <cstring>
+#include <dlfcn.h>
+#include <set>
+#include <string>
+#include <vector>
+
+extern "C" PluginInfo** get_plugin_infos(size_t* count);
+
+static PluginInfo* find_plugin(PluginInfo** plugins, size_t count, const char* name) {
+    for (size_t index = 0; index < count; ++index) {
+        if (std::strcmp(plugins[index]->name, name) == 0) return plugins[index];
+    }
+    return nullptr;
+}
+
+SCENARIO("foundation bundle exposes every foundation plugin", "[bundle]") {
+    GIVEN("the bundled plugin table") {
+        size_t count = 0;
+        PluginInfo** plugins = get_plugin_infos(&count);
+
+        THEN("it holds one entry per foundation plugin") {
+            REQUIRE(count == 14);
+            for (const char* name : {"event", "interpolation", "profiler", "project", "metrics", "pack",
+                                     "entity", "identity", "serialization", "mesh", "texture", "spatial", "draw", "reload"}) {
+                REQUIRE(find_plugin(plugins, count, name) != nullptr);
+            }
+        }
+
+        THEN("each plugin keeps its own metadata") {
+            PluginInfo* entity = find_plugin(plugins, count, "entity");
+            REQUIRE(entity->defines_count == 9);
+            REQUIRE(std::strcmp(entity->defines_components[0], "EntityTable") == 0);
+            REQUIRE(entity->requires_count == 1);
+            REQUIRE(std::strcmp(entity->requires_components[0], "EventSwapper") == 0);
+            REQUIRE(entity->tick_fn != nullptr);
+        }
+
+        THEN("no component is defined by two plugins") {
+            std::set<std::string> defined;
+            for (size_t index = 0; index < count; ++index) {
+                for (size_t component = 0; component < plugins[index]->defines_count; ++component) {
+                    REQUIRE(defined.insert(plugins[index]->defines_components[component]).second);
+                }
+            }
+        }
+
+        THEN("every required component is defined by an earlier plugin") {
+            std::set<std::string> defined;
+            for (size_t index = 0; index < count; ++index) {
+                for (size_t component = 0; component < plugins[index]->requires_count; ++component) {
+                    REQUIRE(defined.count(plugins[index]->requires_components[component]) == 1);
+                }
+                for (size_t component = 0; component < plugins[index]->defines_count; ++component) {
+                    defined.insert(plugins[index]->defines_components[component]);
+                }
+            }
+        }
+    }
+}
+
+static std::vector<PluginInfo*> core_plugins() {
+    size_t count = 0;
+    PluginInfo** plugins = get_plugin_infos(&count);
+    std::vector<PluginInfo*> core;
+    for (const char* name : {"event", "interpolation", "entity", "identity"}) {
+        core.push_back(find_plugin(plugins, count, name));
+    }
+    return core;
+}
+
+static size_t churn_world(const std::vector<PluginInfo*>& plugins) {
+    World world;
+    WorldHandle handle = handle_from_world(&world);
+    for (auto* plugin : plugins) plugin->init_fn(handle);
+    for (auto* plugin : plugins) plugin->tick_fn(handle);
+    for (auto plugin = plugins.rbegin(); plugin != plugins.rend(); ++plugin) {
+        if ((*plugin)->shutdown_fn) (*plugin)->shutdown_fn(handle);
+        for (size_t component = 0; component < (*plugin)->defines_count; ++component) {
+            world.destroy((*plugin)->defines_components[component]);
+        }
+    }
+    return plugins.size();
+}
+
+struct SplitPlugins {
+    std::vector<void*> libraries_;
+    std::vector<PluginInfo*> plugins_;
+
+    SplitPlugins() {
+        for (const char* name : {"event", "interpolation", "entity", "identity"}) {
+            auto path = std::string(CASK_SPLIT_PLUGIN_DIR) + "/" + name + "_plugin" + CASK_PLUGIN_SUFFIX;
+            void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (!library) continue;
+            libraries_.push_back(library);
+            auto entry = reinterpret_cast<PluginInfo* (*)()>(dlsym(library, "get_plugin_info"));
+            if (entry) plugins_.push_back(entry());
+        }
+    }
+
+    ~SplitPlugins() {
+        for (auto library = libraries_.rbegin(); library != libraries_.rend(); ++library) {
+            dlclose(*library);
+        }
+    }
+
+    SplitPlugins(const SplitPlugins&) = delete;
+    SplitPlugins& operator=(const SplitPlugins&) = delete;
+};
+
+struct RunningWorld {
+    std::vector<PluginInfo*> plugins_;
+    World world_;
+    WorldHandle handle_;
+
+    explicit RunningWorld(std::vector<PluginInfo*> plugins)
+        : plugins_(std::move(plugins))
+        , handle_(handle_from_world(&world_)) {
+        for (auto* plugin : plugins_) plugin->init_fn(handle_);
+        auto* table = static_cast<EntityTable*>(world_.resolve("EntityTable"));
+        auto* registry = static_cast<EntityRegistry*>(world_.resolve("EntityRegistry"));
+        for (int count = 0; count < 1000; ++count) {
+            registry->resolve(cask::generate_uuid(), *table);
+        }
+    }
+
+    ~RunningWorld() {
+        for (auto plugin = plugins_.rbegin(); plugin != plugins_.rend(); ++plugin) {
+            if ((*plugin)->shutdown_fn) (*plugin)->shutdown_fn(handle_);
+            for (size_t component = 0; component < (*plugin)->defines_count; ++component) {
+                world_.destroy((*plugin)->defines_components[component]);
+            }
+        }
+    }
+
+    void tick() {
+        for (auto* plugin : plugins_) plugin->tick_fn(handle_);
+    }
+};
+
+SCENARIO("split and bundled core plugins are compared", "[.][bundle][benchmark]") {
+    GIVEN("the core plugins loaded from their split libraries") {
+        BENCHMARK("dlopen and dlclose the split core plugins") {
+            SplitPlugins split;
+            return split.plugins_.size();
+        };
+
+        SplitPlugins split;
+        REQUIRE(split.plugins_.size() == 4);
+
+        BENCHMARK("create and destroy a world with the split plugins") {
+            return churn_world(split.plugins_);
+        };
+
+        BENCHMARK("create and destroy a world with the bundled plugins") {
+            return churn_world(core_plugins());
+        };
+
+        RunningWorld split_world(split.plugins_);
+        RunningWorld bundled_world(core_plugins());
+
+        BENCHMARK("tick a world through the split plugins") {
+            split_world.tick();
+        };
+
+        BENCHMARK("tick a world through the bundled plugins") {
+            bundled_world.tick();
+        };
+    }
+}
+
+SCENARIO("bundled core plugins retire a destroy burst under a compaction budget", "[bundle]") {
+    GIVEN("a world running the core plugins with a hundred identified entities") {
+        auto plugins = core_plugins();
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        for (auto* plugin : plugins) plugin->init_fn(handle);
+        auto* table = static_cast<EntityTable*>(world.resolve("EntityTable"));
+        auto* registry = static_cast<EntityRegistry*>(world.resolve("EntityRegistry"));
+        auto* amortized = static_cast<cask::AmortizedCompactor*>(world.resolve("AmortizedCompactor"));
+        auto* destroy_queue = static_cast<EventQueue<DestroyEntity>*>(world.resolve("DestroyEntityQueue"));
+        ComponentStore<uint32_t> values;
+        static_cast<EntityCompactor*>(world.resolve("EntityCompactor"))->add(&values, remove_component<uint32_t>);
+        std::vector<uint32_t> entities;
+        for (int count = 0; count < 100; ++count) {
+            uint32_t entity = registry->resolve(cask::generate_uuid(), *table);
+            values.insert(entity, entity);
+            entities.push_back(entity);
+        }
+        amortized->entity_budget_ = 30;
+        auto tick = [&] {
+            for (auto* plugin : plugins) plugin->tick_fn(handle);
+        };
+
+        WHEN("every entity is destroyed in one tick") {
+            for (uint32_t entity : entities) {
+                destroy_queue->emit(DestroyEntity{entity});
+            }
+            tick();
+
+            THEN("identity drops every entity at once while components are removed within the budget") {
+                REQUIRE(registry->size() == 0);
+                REQUIRE(values.size() == 70);
+                REQUIRE(amortized->pending() == 70);
+                REQUIRE(amortized->retiring(entities.back()));
+            }
+
+            THEN("later ticks finish the burst") {
+                for (int count = 0; count < 3; ++count) {
+                    tick();
+                }
+                REQUIRE(values.size() == 0);
+                REQUIRE(amortized->pending() == 0);
+                for (uint32_t entity : entities) {
+                    REQUIRE_FALSE(table->alive(entity));
+                    REQUIRE_FALSE(amortized->retiring(entity));
+                }
+            }
+        }
+
+        for (auto plugin = plugins.rbegin(); plugin != plugins.rend(); ++plugin) {
+            if ((*plugin)->shutdown_fn) (*plugin)->shutdown_fn(handle);
+            for (size_t component = 0; component < (*plugin)->defines_count; ++component) {
+                world.destroy((*plugin)->defines_components[component]);
+            }
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../plugin_test_context.hpp"
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/texture_data.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/foundation/draw_keys.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cstring>
+#include <vector>
+
+struct DrawTestContext : PluginTestContext {
+    ComponentStore<MeshHandle> meshes;
+    ComponentStore<TextureHandle> textures;
+    cask::EntityWatchers watchers;
+    cask::StoreGenerations generations;
+
+    DrawTestContext() {
+        uint32_t meshes_id = world.register_component("MeshComponents");
+        world.bind(meshes_id, &meshes);
+        uint32_t textures_id = world.register_component("TextureComponents");
+        world.bind(textures_id, &textures);
+        uint32_t watchers_id = world.register_component("EntityWatchers");
+        world.bind(watchers_id, &watchers);
+        uint32_t generations_id = world.register_component("StoreGenerations");
+        world.bind(generations_id, &generations);
+    }
+
+    void frame() { info->frame_fn(handle, 0.0f, 1.0f); }
+
+    cask::DrawKeys* draw_keys() {
+        return static_cast<cask::DrawKeys*>(world.resolve("DrawKeys"));
+    }
+};
+
+SCENARIO("draw plugin reports its metadata", "[draw]") {
+    GIVEN("the draw plugin") {
+        PluginInfo* info = get_plugin_info();
+
+        THEN("the plugin name is draw") {
+            REQUIRE(info->name != nullptr);
+            REQUIRE(std::strcmp(info->name, "draw") == 0);
+        }
+
+        THEN("it defines DrawKeys and DrawPluginState") {
+            REQUIRE(info->defines_count == 2);
+            REQUIRE(std::strcmp(info->defines_components[0], "DrawKeys") == 0);
+            REQUIRE(std::strcmp(info->defines_components[1], "DrawPluginState") == 0);
+        }
+
+        THEN("it requires MeshComponents, TextureComponents, EntityWatchers and StoreGenerations") {
+            REQUIRE(info->requires_count == 4);
+            REQUIRE(std::strcmp(info->requires_components[0], "MeshComponents") == 0);
+            REQUIRE(std::strcmp(info->requires_components[1], "TextureComponents") == 0);
+            REQUIRE(std::strcmp(info->requires_components[2], "EntityWatchers") == 0);
+            REQUIRE(std::strcmp(info->requires_components[3], "StoreGenerations") == 0);
+        }
+
+        THEN("it provides init and frame functions") {
+            REQUIRE(info->init_fn != nullptr);
+            REQUIRE(info->frame_fn != nullptr);
+        }
+
+        THEN("it provides a shutdown function but no tick function") {
+            REQUIRE(info->tick_fn == nullptr);
+            REQUIRE(info->shutdown_fn != nullptr);
+        }
+    }
+}
+
+SCENARIO("draw plugin sorts draw keys each frame", "[draw]") {
+    GIVEN("an initialized draw plugin and entities with meshes and textures") {
+        DrawTestContext context;
+        context.init();
+        context.meshes.insert(0, MeshHandle{2});
+        context.textures.insert(0, TextureHandle{1});
+        context.meshes.insert(1, MeshHandle{1});
+        context.textures.insert(1, TextureHandle{0});
+        context.meshes.insert(2, MeshHandle{0});
+
+        WHEN("a frame runs") {
+            context.frame();
+
+            THEN("DrawKeys holds one key per meshed entity ordered by texture then mesh") {
+                auto* keys = context.draw_keys();
+                REQUIRE(keys != nullptr);
+                auto sorted = keys->keys();
+                REQUIRE(sorted.size() == 3);
+                REQUIRE(sorted[0].entity == 1);
+                REQUIRE(sorted[1].entity == 0);
+                REQUIRE(sorted[2].entity == 2);
+                REQUIRE(cask::draw_key_texture(sorted[2].key) == cask::DrawKeys::untextured);
+            }
+        }
+
+        WHEN("a texture changes between frames") {
+            context.frame();
+            context.textures.insert(0, TextureHandle{0});
+            context.generations.touch(&context.textures, 0);
+            context.frame();
+
+            THEN("the changed entry moves into place") {
+                auto sorted = context.draw_keys()->keys();
+                REQUIRE(sorted.size() == 3);
+                REQUIRE(sorted[0].entity == 1);
+                REQUIRE(sorted[1].entity == 0);
+                REQUIRE(sorted[2].entity == 2);
+            }
+        }
+
+        WHEN("a texture is rewritten in place without recording the write") {
+            context.frame();
+            size_t scans = context.draw_keys()->scans_;
+            context.textures.get(0) = TextureHandle{0};
+            context.frame();
+
+            THEN("the frame skips the scan") {
+                REQUIRE(context.draw_keys()->scans_ == scans);
+                REQUIRE(context.draw_keys()->keys()[1].entity == 0);
+                REQUIRE(cask::draw_key_texture(context.draw_keys()->keys()[1].key) == 1);
+            }
+        }
+
+        WHEN("frames run without any writes") {
+            context.frame();
+            size_t scans = context.draw_keys()->scans_;
+            context.frame();
+            context.frame();
+
+            THEN("the keys are not rescanned") {
+                REQUIRE(context.draw_keys()->scans_ == scans);
+                REQUIRE(context.draw_keys()->keys().size() == 3);
+            }
+        }
+
+        WHEN("an entity is retiring under the amortized compactor") {
+            context.frame();
+            EntityTable table;
+            uint32_t entity = table.create();
+            cask::AmortizedCompactor amortized;
+            context.watchers.attach(amortized);
+            amortized.retire(table, std::vector<DestroyEntity>{DestroyEntity{entity}});
+            context.frame();
+
+            THEN("its key is dropped while its mesh handle remains") {
+                auto sorted = context.draw_keys()->keys();
+                REQUIRE(context.meshes.has(0));
+                REQUIRE(sorted.size() == 2);
+                REQUIRE(sorted[0].entity == 1);
+                REQUIRE(sorted[1].entity == 2);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("draw plugin shutdown leaves EntityWatchers", "[draw]") {
+    GIVEN("an initialized draw plugin") {
+        DrawTestContext context;
+        context.init();
+        REQUIRE(context.watchers.size() == 1);
+
+        WHEN("shutdown is called") {
+            context.shutdown();
+
+            THEN("DrawKeys no longer watches retired or compacted entities") {
+                REQUIRE(context.watchers.size() == 0);
+            }
+        }
+    }
+}
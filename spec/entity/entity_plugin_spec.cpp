@@ -6,7 +6,18 @@
 #include <cask/ecs/component_store.hpp>
 #include <cask/event/event_swapper.hpp>
 #include <cask/event/event_queue.hpp>
+#include <cask/foundation/frame_profiler.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <cask/foundation/memory_report.hpp>
+#include <cask/foundation/rollback.hpp>
+#include <cask/foundation/command_buffer.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/foundation/store_defragmenter.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <algorithm>
 #include <cstring>
+#include <sstream>
+#include <vector>
 
 struct EntityTestContext : PluginTestContext {
     EventSwapper swapper;
@@ -27,6 +38,10 @@ struct EntityTestContext : PluginTestContext {
     EventQueue<DestroyEntity>* destroy_entity_queue() {
         return static_cast<EventQueue<DestroyEntity>*>(world.resolve("DestroyEntityQueue"));
     }
+
+    cask::CommandBuffers* command_buffers() {
+        return static_cast<cask::CommandBuffers*>(world.resolve("CommandBuffers"));
+    }
 };
 
 SCENARIO("entity plugin reports its metadata", "[entity]") {
@@ -38,13 +53,18 @@ SCENARIO("entity plugin reports its metadata", "[entity]") {
             REQUIRE(std::strcmp(info->name, "entity") == 0);
         }
 
-        THEN("it defines EntityTable EntityCompactor DestroyEntityQueue and EntityPluginState") {
-            REQUIRE(info->defines_count == 4);
+        THEN("it defines EntityTable EntityCompactor EntityWatchers StoreGenerations DestroyEntityQueue CommandBuffers StoreDefragmenter AmortizedCompactor and EntityPluginState") {
+            REQUIRE(info->defines_count == 9);
             REQUIRE(info->defines_components != nullptr);
             REQUIRE(std::strcmp(info->defines_components[0], "EntityTable") == 0);
             REQUIRE(std::strcmp(info->defines_components[1], "EntityCompactor") == 0);
-            REQUIRE(std::strcmp(info->defines_components[2], "DestroyEntityQueue") == 0);
-            REQUIRE(std::strcmp(info->defines_components[3], "EntityPluginState") == 0);
+            REQUIRE(std::strcmp(info->defines_components[2], "EntityWatchers") == 0);
+            REQUIRE(std::strcmp(info->defines_components[3], "StoreGenerations") == 0);
+            REQUIRE(std::strcmp(info->defines_components[4], "DestroyEntityQueue") == 0);
+            REQUIRE(std::strcmp(info->defines_components[5], "CommandBuffers") == 0);
+            REQUIRE(std::strcmp(info->defines_components[6], "StoreDefragmenter") == 0);
+            REQUIRE(std::strcmp(info->defines_components[7], "AmortizedCompactor") == 0);
+            REQUIRE(std::strcmp(info->defines_components[8], "EntityPluginState") == 0);
         }
 
         THEN("it requires the EventSwapper component") {
@@ -61,8 +81,8 @@ SCENARIO("entity plugin reports its metadata", "[entity]") {
             REQUIRE(info->tick_fn != nullptr);
         }
 
-        THEN("it does not provide a shutdown function") {
-            REQUIRE(info->shutdown_fn == nullptr);
+        THEN("it provides a shutdown function") {
+            REQUIRE(info->shutdown_fn != nullptr);
         }
 
         THEN("it does not provide a frame function") {
@@ -201,3 +221,293 @@ SCENARIO("entity plugin shutdown allows reinit on fresh world", "[entity]") {
         }
     }
 }
+
+SCENARIO("entity plugin tick is traced when a FrameProfiler is present", "[entity]") {
+    GIVEN("an initialized entity plugin and a bound FrameProfiler") {
+        EntityTestContext context;
+        cask::FrameProfiler profiler;
+        uint32_t profiler_id = context.world.register_component("FrameProfiler");
+        context.world.bind(profiler_id, &profiler);
+        context.init();
+
+        WHEN("tick is called") {
+            context.tick();
+
+            THEN("an entity_tick event is recorded") {
+                std::ostringstream output;
+                profiler.write_chrome_trace(output);
+                REQUIRE(output.str().find("entity_tick") != std::string::npos);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("entity plugin tick counts compacted entities when Metrics is present", "[entity]") {
+    GIVEN("an initialized entity plugin and a bound Metrics") {
+        EntityTestContext context;
+        cask::Metrics metrics;
+        uint32_t metrics_id = context.world.register_component("Metrics");
+        context.world.bind(metrics_id, &metrics);
+        context.init();
+
+        uint32_t first = context.entity_table()->create();
+        uint32_t second = context.entity_table()->create();
+
+        WHEN("two entities are destroyed and tick is called") {
+            context.destroy_entity_queue()->emit(DestroyEntity{first});
+            context.destroy_entity_queue()->emit(DestroyEntity{second});
+            context.swapper.swap_all();
+            context.tick();
+
+            THEN("the compaction counter and histogram record them") {
+                REQUIRE(metrics.counter("cask_entities_compacted_total", "").value() == 2);
+                REQUIRE(metrics.histogram("cask_entities_compacted_per_tick", "", {}).count() == 1);
+            }
+
+            THEN("DestroyEntityQueue is observed") {
+                REQUIRE(metrics.queues_.size() == 1);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("entity plugin tick spreads a destroy burst over the compaction budget", "[entity]") {
+    GIVEN("an initialized entity plugin with fifty entities and a budget of twenty per tick") {
+        EntityTestContext context;
+        cask::Metrics metrics;
+        uint32_t metrics_id = context.world.register_component("Metrics");
+        context.world.bind(metrics_id, &metrics);
+        context.init();
+        ComponentStore<uint32_t> values;
+        context.compactor()->add(&values, remove_component<uint32_t>);
+        std::vector<uint32_t> entities;
+        for (int count = 0; count < 50; ++count) {
+            entities.push_back(context.entity_table()->create());
+            values.insert(entities.back(), 0);
+        }
+        auto* amortized = static_cast<cask::AmortizedCompactor*>(context.world.resolve("AmortizedCompactor"));
+        amortized->entity_budget_ = 20;
+
+        WHEN("every entity is destroyed and tick is called") {
+            for (uint32_t entity : entities) {
+                context.destroy_entity_queue()->emit(DestroyEntity{entity});
+            }
+            context.swapper.swap_all();
+            context.tick();
+
+            THEN("twenty entities are compacted and thirty are pending") {
+                REQUIRE(values.size() == 30);
+                REQUIRE(amortized->pending() == 30);
+                REQUIRE(metrics.counter("cask_entities_compacted_total", "").value() == 20);
+                REQUIRE(metrics.gauge("cask_entities_pending_compaction", "").value() == 30);
+            }
+
+            THEN("two more ticks compact the rest") {
+                context.swapper.swap_all();
+                context.tick();
+                context.tick();
+                REQUIRE(values.size() == 0);
+                REQUIRE(amortized->pending() == 0);
+                REQUIRE(metrics.gauge("cask_entities_pending_compaction", "").value() == 0);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("entity plugin untracks its memory on shutdown", "[entity]") {
+    GIVEN("an initialized entity plugin and a bound MemoryReport") {
+        EntityTestContext context;
+        cask::MemoryReport report;
+        uint32_t report_id = context.world.register_component("MemoryReport");
+        context.world.bind(report_id, &report);
+        context.init();
+
+        THEN("EntityTable and DestroyEntityQueue are tracked") {
+            REQUIRE(report.snapshot().size() == 2);
+        }
+
+        WHEN("the plugin shuts down") {
+            context.shutdown();
+
+            THEN("the report no longer points at its components") {
+                REQUIRE(report.entries_.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("entity plugin tracks EntityTable when Rollback is present", "[entity]") {
+    GIVEN("an initialized entity plugin and a bound Rollback") {
+        EntityTestContext context;
+        cask::Rollback rollback;
+        uint32_t rollback_id = context.world.register_component("Rollback");
+        context.world.bind(rollback_id, &rollback);
+        context.init();
+
+        auto* table = context.entity_table();
+        uint32_t kept = table->create();
+        rollback.save(1);
+
+        WHEN("an entity is created after the save and the tick is restored") {
+            uint32_t later = table->create();
+            REQUIRE(rollback.restore(1));
+
+            THEN("only entities from the saved tick are alive") {
+                REQUIRE(table->alive(kept));
+                REQUIRE_FALSE(table->alive(later));
+            }
+        }
+
+        THEN("the destroy queue and command buffers are tracked too") {
+            REQUIRE(rollback.tracks(context.world.resolve("DestroyEntityQueue")));
+            REQUIRE(rollback.tracks(context.world.resolve("CommandBuffers")));
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("entity plugin untracks its rollback state on shutdown", "[entity]") {
+    GIVEN("an initialized entity plugin and a bound Rollback") {
+        EntityTestContext context;
+        cask::Rollback rollback;
+        uint32_t rollback_id = context.world.register_component("Rollback");
+        context.world.bind(rollback_id, &rollback);
+        context.init();
+        REQUIRE(rollback.tracked() > 0);
+
+        WHEN("the plugin shuts down") {
+            context.shutdown();
+
+            THEN("nothing it tracked is left in the rollback") {
+                REQUIRE(rollback.tracked() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("entity plugin tick plays back deferred commands", "[entity]") {
+    GIVEN("an initialized entity plugin with a component store") {
+        EntityTestContext context;
+        context.init();
+        ComponentStore<uint32_t> values;
+        context.compactor()->add(&values, remove_component<uint32_t>);
+        uint32_t existing = context.entity_table()->create();
+        values.insert(existing, 1);
+
+        WHEN("a worker records a create with an insert and tick is called") {
+            auto& buffer = context.command_buffers()->at(0);
+            uint32_t deferred = buffer.create();
+            buffer.insert(&values, deferred, 7u);
+            context.tick();
+
+            THEN("a live entity holds the inserted component") {
+                REQUIRE(values.size() == 2);
+                uint32_t created = values.entities_[1];
+                REQUIRE(context.entity_table()->alive(created));
+                REQUIRE(values.get(created) == 7u);
+            }
+
+            THEN("the buffer is empty") {
+                REQUIRE(context.command_buffers()->pending() == 0);
+            }
+        }
+
+        WHEN("a worker records a remove") {
+            context.command_buffers()->at(1).remove(&values, existing);
+            context.tick();
+
+            THEN("the component is removed but the entity stays alive") {
+                REQUIRE_FALSE(values.has(existing));
+                REQUIRE(context.entity_table()->alive(existing));
+            }
+        }
+
+        WHEN("a tracked store is written by a played command") {
+            auto* generations = static_cast<cask::StoreGenerations*>(context.world.resolve("StoreGenerations"));
+            generations->track(&values);
+            context.command_buffers()->at(0).insert(&values, existing, 9u);
+            context.tick();
+
+            THEN("its write generation advances") {
+                REQUIRE(generations->generation(&values) == 1);
+            }
+        }
+
+        WHEN("a worker records a destroy") {
+            context.command_buffers()->at(0).destroy(existing);
+            context.tick();
+            context.swapper.swap_all();
+            context.tick();
+
+            THEN("the entity is compacted through DestroyEntityQueue") {
+                REQUIRE_FALSE(context.entity_table()->alive(existing));
+                REQUIRE_FALSE(values.has(existing));
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("entity plugin plays command buffers in slot order", "[entity]") {
+    GIVEN("two slots that insert into the same entity") {
+        EntityTestContext context;
+        context.init();
+        ComponentStore<uint32_t> values;
+        context.compactor()->add(&values, remove_component<uint32_t>);
+        uint32_t entity = context.entity_table()->create();
+
+        WHEN("slot 1 is recorded before slot 0 and tick is called") {
+            context.command_buffers()->at(1).insert(&values, entity, 2u);
+            context.command_buffers()->at(0).insert(&values, entity, 1u);
+            context.tick();
+
+            THEN("the higher slot is applied last") {
+                REQUIRE(values.get(entity) == 2u);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("entity plugin tick defragments registered stores", "[entity]") {
+    GIVEN("a store filled in descending entity order and registered with the defragmenter") {
+        EntityTestContext context;
+        context.init();
+        ComponentStore<uint32_t> values;
+        context.compactor()->add(&values, remove_component<uint32_t>);
+        std::vector<uint32_t> entities;
+        for (int count = 0; count < 64; ++count) {
+            entities.push_back(context.entity_table()->create());
+        }
+        for (auto entity = entities.rbegin(); entity != entities.rend(); ++entity) {
+            values.insert(*entity, *entity);
+        }
+        auto* defragmenter = static_cast<cask::StoreDefragmenter*>(context.world.resolve("StoreDefragmenter"));
+        defragmenter->add(&values);
+
+        WHEN("tick is called until the defragmenter settles") {
+            for (int tick = 0; tick < 64 && !defragmenter->settled(); ++tick) {
+                context.tick();
+            }
+
+            THEN("the store is in ascending entity order with every component kept") {
+                REQUIRE(defragmenter->settled());
+                REQUIRE(std::is_sorted(values.entities_.begin(), values.entities_.end()));
+                for (uint32_t entity : entities) {
+                    REQUIRE(values.get(entity) == entity);
+                }
+            }
+        }
+
+        context.shutdown();
+    }
+}
@@ -2,6 +2,7 @@
 #include "../plugin_test_context.hpp"
 #include <cask/event/event_swapper.hpp>
 #include <cask/event/event_queue.hpp>
+#include <cask/foundation/startup_profile.hpp>
 #include <cstring>
 
 struct TestEvent {
@@ -23,11 +24,13 @@ SCENARIO("event plugin reports its metadata", "[event]") {
             REQUIRE(std::strcmp(info->name, "event") == 0);
         }
 
-        THEN("it defines EventSwapper and EventPluginState components") {
-            REQUIRE(info->defines_count == 2);
+        THEN("it defines EventSwapper EventGenerations EventQueueCatalog and EventPluginState components") {
+            REQUIRE(info->defines_count == 4);
             REQUIRE(info->defines_components != nullptr);
             REQUIRE(std::strcmp(info->defines_components[0], "EventSwapper") == 0);
-            REQUIRE(std::strcmp(info->defines_components[1], "EventPluginState") == 0);
+            REQUIRE(std::strcmp(info->defines_components[1], "EventGenerations") == 0);
+            REQUIRE(std::strcmp(info->defines_components[2], "EventQueueCatalog") == 0);
+            REQUIRE(std::strcmp(info->defines_components[3], "EventPluginState") == 0);
         }
 
         THEN("it requires no components") {
@@ -61,6 +64,10 @@ SCENARIO("event plugin initializes EventSwapper", "[event]") {
                 REQUIRE(context.swapper() != nullptr);
             }
 
+            THEN("EventGenerations is registered and retrievable") {
+                REQUIRE(context.world.resolve("EventGenerations") != nullptr);
+            }
+
             context.shutdown();
         }
     }
@@ -140,3 +147,22 @@ SCENARIO("event plugin shutdown prevents tick from processing events", "[event]"
         }
     }
 }
+
+SCENARIO("event plugin records its init cost when profiling startup", "[event]") {
+    GIVEN("a world with a StartupProfile") {
+        EventTestContext context;
+        cask::StartupProfile profile;
+        uint32_t profile_id = context.world.register_component("StartupProfile");
+        context.world.bind(profile_id, &profile);
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("a sample named event is recorded") {
+                REQUIRE(profile.find("event") != nullptr);
+            }
+
+            context.shutdown();
+        }
+    }
+}
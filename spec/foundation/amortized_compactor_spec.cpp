@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_compactor.hpp>
+#include <cask/ecs/entity_events.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <chrono>
+#include <vector>
+
+struct CompactionFixture {
+    EntityTable table;
+    EntityCompactor compactor;
+    ComponentStore<uint32_t> values;
+    EventQueue<DestroyEntity> queue;
+    std::vector<uint32_t> entities;
+
+    explicit CompactionFixture(uint32_t count) {
+        compactor.table_ = &table;
+        compactor.add(&values, remove_component<uint32_t>);
+        for (uint32_t index = 0; index < count; ++index) {
+            uint32_t entity = table.create();
+            values.insert(entity, index);
+            entities.push_back(entity);
+        }
+    }
+
+    void destroy_all() {
+        for (uint32_t entity : entities) {
+            queue.emit(DestroyEntity{entity});
+        }
+        queue.swap();
+    }
+};
+
+SCENARIO("an amortized compactor without a budget compacts everything at once", "[amortized_compactor]") {
+    GIVEN("a thousand destroyed entities") {
+        CompactionFixture fixture(1000);
+        cask::AmortizedCompactor amortized;
+        fixture.destroy_all();
+
+        WHEN("it compacts") {
+            size_t compacted = amortized.compact(fixture.compactor, fixture.queue);
+
+            THEN("every entity and component is gone") {
+                REQUIRE_FALSE(amortized.budgeted());
+                REQUIRE(compacted == 1000);
+                REQUIRE(fixture.values.size() == 0);
+                REQUIRE(amortized.pending() == 0);
+                for (uint32_t entity : fixture.entities) {
+                    REQUIRE_FALSE(fixture.table.alive(entity));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("an amortized compactor spreads a burst over its entity budget", "[amortized_compactor]") {
+    GIVEN("a thousand destroyed entities and a budget of 300 per tick") {
+        CompactionFixture fixture(1000);
+        cask::AmortizedCompactor amortized;
+        amortized.entity_budget_ = 300;
+        fixture.destroy_all();
+
+        WHEN("it compacts once") {
+            size_t compacted = amortized.compact(fixture.compactor, fixture.queue);
+
+            THEN("only the budget is compacted and the rest is retiring") {
+                REQUIRE(compacted == 300);
+                REQUIRE(fixture.values.size() == 700);
+                REQUIRE(amortized.pending() == 700);
+                REQUIRE_FALSE(fixture.table.alive(fixture.entities.front()));
+                REQUIRE_FALSE(amortized.retiring(fixture.entities.front()));
+                REQUIRE(fixture.table.alive(fixture.entities.back()));
+                REQUIRE(amortized.retiring(fixture.entities.back()));
+            }
+
+            THEN("ids still waiting for compaction are not handed out again") {
+                uint32_t created = fixture.table.create();
+                REQUIRE_FALSE(amortized.retiring(created));
+            }
+        }
+
+        WHEN("the same entities are destroyed again before they are compacted") {
+            amortized.compact(fixture.compactor, fixture.queue);
+            fixture.destroy_all();
+            amortized.compact(fixture.compactor, fixture.queue);
+
+            THEN("each entity is compacted once") {
+                REQUIRE(amortized.pending() == 400);
+                REQUIRE(amortized.compacted_ == 600);
+            }
+        }
+
+        WHEN("it compacts until nothing is pending") {
+            std::vector<size_t> per_tick;
+            per_tick.push_back(amortized.compact(fixture.compactor, fixture.queue));
+            fixture.queue.swap();
+            while (amortized.pending() > 0) {
+                per_tick.push_back(amortized.compact(fixture.compactor, fixture.queue));
+            }
+
+            THEN("the burst takes four ticks") {
+                REQUIRE(per_tick == std::vector<size_t>{300, 300, 300, 100});
+                REQUIRE(fixture.values.size() == 0);
+                REQUIRE(amortized.compacted_ == 1000);
+            }
+        }
+    }
+}
+
+SCENARIO("an amortized compactor stops at its time budget", "[amortized_compactor]") {
+    GIVEN("a thousand destroyed entities and a one nanosecond budget") {
+        CompactionFixture fixture(1000);
+        cask::AmortizedCompactor amortized;
+        amortized.time_budget_ = std::chrono::nanoseconds(1);
+        fixture.destroy_all();
+
+        WHEN("it compacts once") {
+            size_t compacted = amortized.compact(fixture.compactor, fixture.queue);
+
+            THEN("it compacts a single slice") {
+                REQUIRE(amortized.budgeted());
+                REQUIRE(compacted == cask::AmortizedCompactor::entities_per_slice);
+                REQUIRE(amortized.pending() == 1000 - cask::AmortizedCompactor::entities_per_slice);
+            }
+        }
+    }
+}
@@ -0,0 +1,234 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/bvh.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/ecs/entity_compactor.hpp>
+#include <cask/ecs/entity_events.hpp>
+#include <cask/event/event_queue.hpp>
+#include <random>
+#include <set>
+
+static cask::Aabb box(float x, float y, float z, float half) {
+    cask::Aabb bounds;
+    bounds.min[0] = x - half;
+    bounds.min[1] = y - half;
+    bounds.min[2] = z - half;
+    bounds.max[0] = x + half;
+    bounds.max[1] = y + half;
+    bounds.max[2] = z + half;
+    return bounds;
+}
+
+static ComponentStore<cask::Aabb> scattered(uint32_t count) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+    std::uniform_real_distribution<float> half(0.1f, 2.0f);
+    ComponentStore<cask::Aabb> store;
+    for (uint32_t entity = 0; entity < count; ++entity) {
+        store.insert(entity, box(position(random), position(random), position(random), half(random)));
+    }
+    return store;
+}
+
+static cask::Frustum axis_box_frustum(float low, float high) {
+    cask::Frustum frustum;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            auto& plane = frustum.planes[axis * 2 + side];
+            plane.normal[0] = plane.normal[1] = plane.normal[2] = 0.0f;
+            plane.normal[axis] = side == 0 ? 1.0f : -1.0f;
+            plane.distance = side == 0 ? -low : high;
+        }
+    }
+    return frustum;
+}
+
+static std::set<uint32_t> brute_force(const ComponentStore<cask::Aabb>& store, const cask::Aabb& query) {
+    std::set<uint32_t> hits;
+    for (size_t index = 0; index < store.entities_.size(); ++index) {
+        if (store.components_[index].overlaps(query)) hits.insert(store.entities_[index]);
+    }
+    return hits;
+}
+
+static std::set<uint32_t> collect(const cask::Bvh& bvh, const cask::Aabb& query) {
+    std::set<uint32_t> hits;
+    bvh.query(query, [&hits](uint32_t entity) { hits.insert(entity); });
+    return hits;
+}
+
+SCENARIO("bounds are computed from interleaved vertices", "[bvh]") {
+    GIVEN("two vertices with a stride of five floats") {
+        float vertices[] = {1.0f, -2.0f, 3.0f, 9.0f, 9.0f, -1.0f, 4.0f, 0.5f, 9.0f, 9.0f};
+
+        THEN("only positions contribute to the bounds") {
+            auto bounds = cask::compute_bounds(vertices, 2, 5);
+            REQUIRE(bounds.min[0] == -1.0f);
+            REQUIRE(bounds.max[1] == 4.0f);
+            REQUIRE(bounds.max[2] == 3.0f);
+        }
+    }
+}
+
+SCENARIO("a BVH answers box queries like a linear scan", "[bvh]") {
+    GIVEN("a BVH synced from 5000 scattered boxes") {
+        auto store = scattered(5000);
+        cask::Bvh bvh;
+        bvh.sync(store);
+
+        THEN("every entity is indexed") {
+            REQUIRE(bvh.size() == 5000);
+        }
+
+        THEN("box queries match a brute force scan") {
+            for (float corner : {0.0f, 25.0f, 60.0f}) {
+                auto query = box(corner + 10.0f, corner + 10.0f, corner + 10.0f, 10.0f);
+                REQUIRE(collect(bvh, query) == brute_force(store, query));
+            }
+        }
+
+        THEN("frustum queries match a brute force scan") {
+            std::set<uint32_t> hits;
+            bvh.query(axis_box_frustum(20.0f, 50.0f), [&hits](uint32_t entity) { hits.insert(entity); });
+            cask::Aabb region;
+            region.min[0] = region.min[1] = region.min[2] = 20.0f;
+            region.max[0] = region.max[1] = region.max[2] = 50.0f;
+            REQUIRE(hits == brute_force(store, region));
+        }
+    }
+}
+
+SCENARIO("a BVH answers ray queries", "[bvh]") {
+    GIVEN("three boxes along the x axis") {
+        ComponentStore<cask::Aabb> store;
+        store.insert(0, box(5.0f, 0.0f, 0.0f, 1.0f));
+        store.insert(1, box(10.0f, 0.0f, 0.0f, 1.0f));
+        store.insert(2, box(10.0f, 10.0f, 0.0f, 1.0f));
+        cask::Bvh bvh;
+        bvh.sync(store);
+
+        WHEN("a ray is cast along x") {
+            cask::Ray ray{{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 100.0f};
+            std::set<uint32_t> hits;
+            float nearest = 1000.0f;
+            bvh.query(ray, [&](uint32_t entity, float distance) {
+                hits.insert(entity);
+                nearest = std::min(nearest, distance);
+            });
+
+            THEN("boxes on the ray are hit with their entry distance") {
+                REQUIRE(hits == std::set<uint32_t>{0, 1});
+                REQUIRE(nearest == 4.0f);
+            }
+        }
+
+        WHEN("the ray is shorter than the first box") {
+            cask::Ray ray{{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 3.0f};
+            size_t hits = 0;
+            bvh.query(ray, [&hits](uint32_t, float) { ++hits; });
+
+            THEN("nothing is hit") {
+                REQUIRE(hits == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("a BVH refits incrementally", "[bvh]") {
+    GIVEN("a synced BVH") {
+        auto store = scattered(2000);
+        cask::Bvh bvh;
+        bvh.sync(store);
+
+        WHEN("boxes move and the BVH is synced again") {
+            for (uint32_t entity = 0; entity < 2000; entity += 7) {
+                store.insert(entity, box(150.0f, 150.0f, 150.0f, 1.0f));
+            }
+            bvh.sync(store);
+
+            THEN("the tree is refitted rather than rebuilt") {
+                REQUIRE(bvh.builds_ == 1);
+            }
+
+            THEN("queries see the new positions") {
+                auto query = box(150.0f, 150.0f, 150.0f, 2.0f);
+                REQUIRE(collect(bvh, query) == brute_force(store, query));
+                REQUIRE(collect(bvh, query).size() == 286);
+            }
+        }
+
+        WHEN("a few boxes are added") {
+            for (uint32_t entity = 2000; entity < 2010; ++entity) {
+                store.insert(entity, box(-50.0f, -50.0f, -50.0f, 1.0f));
+            }
+            bvh.sync(store);
+
+            THEN("they are found") {
+                REQUIRE(collect(bvh, box(-50.0f, -50.0f, -50.0f, 1.0f)).size() == 10);
+            }
+        }
+
+        WHEN("a box is added among the existing ones") {
+            store.insert(2000, box(50.0f, 50.0f, 50.0f, 0.5f));
+            bvh.sync(store);
+
+            THEN("it lands in a leaf's spare slots without a rebuild") {
+                REQUIRE(bvh.builds_ == 1);
+                REQUIRE(bvh.contains(2000));
+                auto query = box(50.0f, 50.0f, 50.0f, 0.5f);
+                REQUIRE(collect(bvh, query) == brute_force(store, query));
+            }
+        }
+    }
+}
+
+SCENARIO("a watched BVH drops compacted entities", "[bvh]") {
+    GIVEN("a BVH watching the compactor's entity watchers") {
+        EntityTable table;
+        EntityCompactor compactor;
+        compactor.table_ = &table;
+        cask::EntityWatchers watchers;
+        watchers.attach(compactor);
+        EventQueue<DestroyEntity> destroy_queue;
+        ComponentStore<cask::Aabb> store;
+        compactor.add(&store, remove_component<cask::Aabb>);
+        for (int index = 0; index < 20; ++index) {
+            uint32_t entity = table.create();
+            store.insert(entity, box(float(entity), 0.0f, 0.0f, 0.25f));
+        }
+        cask::Bvh bvh;
+        bvh.watch(watchers);
+        bvh.sync(store);
+
+        WHEN("an entity is destroyed") {
+            destroy_queue.emit(DestroyEntity{3});
+            destroy_queue.swap();
+            compactor.compact(destroy_queue);
+            bvh.sync(store);
+
+            THEN("it is no longer returned") {
+                REQUIRE_FALSE(bvh.contains(3));
+                REQUIRE(bvh.size() == 19);
+                REQUIRE(collect(bvh, box(3.0f, 0.0f, 0.0f, 0.5f)) == std::set<uint32_t>{});
+            }
+        }
+    }
+}
+
+SCENARIO("a frustum is extracted from a view-projection matrix", "[bvh]") {
+    GIVEN("an orthographic projection of the unit cube") {
+        float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        auto frustum = cask::Frustum::from_matrix(identity);
+        cask::Bvh bvh;
+        ComponentStore<cask::Aabb> store;
+        store.insert(0, box(0.0f, 0.0f, 0.0f, 0.5f));
+        store.insert(1, box(3.0f, 0.0f, 0.0f, 0.5f));
+        bvh.sync(store);
+
+        THEN("only the box inside the clip volume is visible") {
+            std::set<uint32_t> hits;
+            bvh.query(frustum, [&hits](uint32_t entity) { hits.insert(entity); });
+            REQUIRE(hits == std::set<uint32_t>{0});
+        }
+    }
+}
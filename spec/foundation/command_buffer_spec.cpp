@@ -0,0 +1,211 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/command_buffer.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+SCENARIO("a command buffer resolves deferred entities on playback", "[command_buffer]") {
+    GIVEN("a buffer that creates two entities and names them") {
+        EntityTable table;
+        EventQueue<DestroyEntity> destroy_queue;
+        ComponentStore<std::string> names;
+        cask::CommandBuffer buffer;
+        uint32_t first = buffer.create();
+        uint32_t second = buffer.create();
+        buffer.insert(&names, second, std::string("second entity with a long heap allocated name"));
+        buffer.insert(&names, first, std::string("first"));
+
+        THEN("the recorded handles are deferred") {
+            REQUIRE(cask::is_deferred_entity(first));
+            REQUIRE(cask::is_deferred_entity(second));
+        }
+
+        WHEN("it is played") {
+            std::vector<uint32_t> created;
+            buffer.play(table, destroy_queue, created);
+
+            THEN("entities are created in recording order") {
+                REQUIRE(created.size() == 2);
+                REQUIRE(table.alive(created[0]));
+                REQUIRE(table.alive(created[1]));
+            }
+
+            THEN("inserts target the created entities") {
+                REQUIRE(names.get(created[0]) == "first");
+                REQUIRE(names.get(created[1]) == "second entity with a long heap allocated name");
+            }
+
+            THEN("the buffer is cleared") {
+                REQUIRE(buffer.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("a command buffer rejects deferred entities it did not create this tick", "[command_buffer]") {
+    GIVEN("two recording slots") {
+        EntityTable table;
+        EventQueue<DestroyEntity> destroy_queue;
+        ComponentStore<std::string> names;
+        cask::CommandBuffers buffers;
+        buffers.reserve(2);
+        auto& first = buffers.at(0);
+        auto& second = buffers.at(1);
+
+        WHEN("one slot uses an entity deferred by the other") {
+            uint32_t entity = first.create();
+            second.create();
+            second.insert(&names, entity, std::string("stray"));
+            buffers.play(table, destroy_queue);
+
+            THEN("the command is rejected rather than applied to the other slot's entity") {
+                REQUIRE(names.size() == 0);
+                REQUIRE(buffers.commands_rejected_ == 1);
+            }
+        }
+
+        WHEN("a deferred entity is used after its tick was played") {
+            uint32_t entity = first.create();
+            buffers.play(table, destroy_queue);
+            first.create();
+            first.insert(&names, entity, std::string("stale"));
+            first.destroy(entity);
+            buffers.play(table, destroy_queue);
+            destroy_queue.swap();
+
+            THEN("both commands are rejected") {
+                REQUIRE(names.size() == 0);
+                REQUIRE(destroy_queue.poll().empty());
+                REQUIRE(buffers.commands_rejected_ == 2);
+            }
+        }
+
+        WHEN("a deferred entity was never issued") {
+            first.create();
+            first.insert(&names, cask::deferred_entity(1000), std::string("missing"));
+            buffers.play(table, destroy_queue);
+
+            THEN("the command is rejected") {
+                REQUIRE(names.size() == 0);
+                REQUIRE(first.rejected_ == 1);
+            }
+        }
+
+        WHEN("a command targets an entity that was destroyed") {
+            uint32_t entity = table.create();
+            table.destroy(entity);
+            first.insert(&names, entity, std::string("dead"));
+            first.remove(&names, entity);
+            buffers.play(table, destroy_queue);
+
+            THEN("both commands are rejected") {
+                REQUIRE(names.size() == 0);
+                REQUIRE(buffers.commands_rejected_ == 2);
+            }
+        }
+    }
+
+    GIVEN("more recording slots than a stamp could tell apart") {
+        EntityTable table;
+        EventQueue<DestroyEntity> destroy_queue;
+        ComponentStore<std::string> names;
+        cask::CommandBuffers buffers;
+        buffers.reserve(65);
+
+        WHEN("slot 64 uses an entity deferred by slot 0") {
+            uint32_t entity = buffers.at(0).create();
+            buffers.at(64).create();
+            buffers.at(64).insert(&names, entity, std::string("stray"));
+            buffers.play(table, destroy_queue);
+
+            THEN("the handles do not alias") {
+                REQUIRE(names.size() == 0);
+                REQUIRE(buffers.commands_rejected_ == 1);
+            }
+        }
+
+        WHEN("a handle is replayed forty ticks later") {
+            auto& buffer = buffers.at(0);
+            uint32_t entity = buffer.create();
+            buffers.play(table, destroy_queue);
+            for (int tick = 0; tick < 40; ++tick) {
+                buffer.create();
+                buffers.play(table, destroy_queue);
+            }
+            buffer.create();
+            buffer.insert(&names, entity, std::string("stale"));
+            buffers.play(table, destroy_queue);
+
+            THEN("it is still rejected") {
+                REQUIRE(names.size() == 0);
+                REQUIRE(buffers.commands_rejected_ == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("a command buffer releases unplayed payloads", "[command_buffer]") {
+    GIVEN("a buffer holding a shared pointer payload") {
+        auto tracked = std::make_shared<int>(5);
+        ComponentStore<std::shared_ptr<int>> store;
+
+        WHEN("the buffer is cleared without playback") {
+            cask::CommandBuffer buffer;
+            buffer.insert(&store, 0, tracked);
+            REQUIRE(tracked.use_count() == 2);
+            buffer.clear();
+
+            THEN("the payload is destroyed") {
+                REQUIRE(tracked.use_count() == 1);
+                REQUIRE(store.size() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("command buffers are recorded in parallel and played deterministically", "[command_buffer]") {
+    GIVEN("four workers recording into their own slots") {
+        EntityTable table;
+        EventQueue<DestroyEntity> destroy_queue;
+        ComponentStore<uint32_t> values;
+        cask::CommandBuffers buffers;
+        buffers.reserve(4);
+
+        WHEN("each worker creates 1000 entities and buffers are played") {
+            std::vector<std::thread> workers;
+            for (uint32_t slot = 0; slot < 4; ++slot) {
+                workers.emplace_back([&buffers, &values, slot] {
+                    auto& buffer = buffers.at(slot);
+                    for (uint32_t index = 0; index < 1000; ++index) {
+                        buffer.insert(&values, buffer.create(), slot * 1000 + index);
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            buffers.play(table, destroy_queue);
+
+            THEN("entities are numbered by slot then recording order") {
+                REQUIRE(values.size() == 4000);
+                bool ordered = true;
+                for (uint32_t entity = 0; entity < 4000; ++entity) {
+                    ordered = ordered && values.get(entity) == entity;
+                }
+                REQUIRE(ordered);
+                REQUIRE(buffers.commands_played_ == 8000);
+            }
+        }
+
+        WHEN("a destroy is recorded") {
+            uint32_t entity = table.create();
+            buffers.at(2).destroy(entity);
+            buffers.play(table, destroy_queue);
+            destroy_queue.swap();
+
+            THEN("it is emitted on DestroyEntityQueue") {
+                REQUIRE(destroy_queue.poll().size() == 1);
+                REQUIRE(destroy_queue.poll()[0].entity == entity);
+            }
+        }
+    }
+}
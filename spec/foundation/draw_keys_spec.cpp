@@ -0,0 +1,345 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/texture_data.hpp>
+#include <cask/foundation/draw_keys.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+struct DrawFixture {
+    ComponentStore<MeshHandle> meshes;
+    ComponentStore<TextureHandle> textures;
+    cask::DrawKeys keys;
+
+    explicit DrawFixture(uint32_t count, uint32_t seed = 7) {
+        std::mt19937 random(seed);
+        for (uint32_t entity = 0; entity < count; ++entity) {
+            meshes.insert(entity, MeshHandle{uint32_t(random() % 512)});
+            if (entity % 16 != 0) textures.insert(entity, TextureHandle{uint32_t(random() % 256)});
+        }
+        keys.meshes_ = &meshes;
+        keys.textures_ = &textures;
+        keys.layer_ = [](uint32_t entity) { return uint16_t(entity % 4); };
+    }
+
+    std::vector<uint64_t> expected() const {
+        std::vector<uint64_t> sorted;
+        for (size_t index = 0; index < meshes.entities_.size(); ++index) {
+            sorted.push_back(keys.key_for(meshes.entities_[index], meshes.components_[index]));
+        }
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    }
+
+    std::vector<uint64_t> built() const {
+        std::vector<uint64_t> sorted;
+        for (auto& entry : keys.keys()) {
+            sorted.push_back(entry.key);
+        }
+        return sorted;
+    }
+};
+
+static std::vector<cask::DrawKey> random_keys(size_t count, uint32_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<cask::DrawKey> keys(count);
+    for (size_t index = 0; index < count; ++index) {
+        keys[index] = cask::DrawKey{random(), uint32_t(index)};
+    }
+    return keys;
+}
+
+static bool sorted_like_std(std::vector<cask::DrawKey> keys, size_t workers) {
+    std::vector<cask::DrawKey> expected = keys;
+    std::stable_sort(expected.begin(), expected.end(), [](auto& a, auto& b) { return a.key < b.key; });
+    cask::RadixSorter sorter;
+    sorter.sort(keys, workers);
+    for (size_t index = 0; index < keys.size(); ++index) {
+        if (keys[index].key != expected[index].key || keys[index].entity != expected[index].entity) return false;
+    }
+    return true;
+}
+
+SCENARIO("draw keys pack layer, texture and mesh", "[draw_keys]") {
+    GIVEN("a key for layer 3, texture 9 and mesh 40") {
+        uint64_t key = cask::make_draw_key(3, 9, 40);
+
+        THEN("each field reads back") {
+            REQUIRE(cask::draw_key_layer(key) == 3);
+            REQUIRE(cask::draw_key_texture(key) == 9);
+            REQUIRE(cask::draw_key_mesh(key) == 40);
+        }
+
+        THEN("layer orders before texture and texture before mesh") {
+            REQUIRE(key < cask::make_draw_key(4, 0, 0));
+            REQUIRE(key < cask::make_draw_key(3, 10, 0));
+            REQUIRE(key < cask::make_draw_key(3, 9, 41));
+        }
+    }
+
+    GIVEN("the largest id that fits in 24 bits") {
+        uint64_t key = cask::make_draw_key(3, cask::draw_key_field_mask, cask::draw_key_field_mask);
+
+        THEN("it fills its field without reaching the layer") {
+            REQUIRE(cask::draw_key_texture(key) == cask::draw_key_field_mask);
+            REQUIRE(cask::draw_key_mesh(key) == cask::draw_key_field_mask);
+            REQUIRE(cask::draw_key_layer(key) == 3);
+            REQUIRE(cask::draw_key_fits(cask::draw_key_field_mask));
+            REQUIRE_FALSE(cask::draw_key_fits(1u << 24));
+        }
+    }
+}
+
+SCENARIO("draw keys reject ids that do not fit their field", "[draw_keys]") {
+    GIVEN("an entity using the untextured value as a texture id, an oversized mesh id, an untextured entity and a textured one") {
+        ComponentStore<MeshHandle> meshes;
+        ComponentStore<TextureHandle> textures;
+        meshes.insert(0, MeshHandle{1});
+        textures.insert(0, TextureHandle{cask::DrawKeys::untextured});
+        meshes.insert(1, MeshHandle{1});
+        meshes.insert(2, MeshHandle{1});
+        textures.insert(2, TextureHandle{5});
+        meshes.insert(3, MeshHandle{1u << 24});
+        cask::DrawKeys keys;
+        keys.meshes_ = &meshes;
+        keys.textures_ = &textures;
+
+        WHEN("the keys are built") {
+            keys.build();
+
+            THEN("the oversized entities get no key and are reported") {
+                auto sorted = keys.keys();
+                REQUIRE(sorted.size() == 2);
+                REQUIRE(sorted[0].entity == 2);
+                REQUIRE(sorted[1].entity == 1);
+                REQUIRE(cask::draw_key_texture(sorted[1].key) == cask::DrawKeys::untextured);
+                REQUIRE(keys.rejected_ == std::vector<uint32_t>{0, 3});
+                REQUIRE(keys.rejected_ids_ == 2);
+            }
+        }
+
+        WHEN("the keys are built again without changes") {
+            keys.build();
+            keys.build();
+            keys.build();
+
+            THEN("the rejections are not counted again") {
+                REQUIRE(keys.rejected_.size() == 2);
+                REQUIRE(keys.rejected_ids_ == 2);
+            }
+        }
+
+        WHEN("a rejected id is fixed and later grows again") {
+            keys.build();
+            textures.insert(0, TextureHandle{7});
+            keys.build();
+            REQUIRE(keys.rejected_ == std::vector<uint32_t>{3});
+            REQUIRE(keys.keys().size() == 3);
+            textures.insert(0, TextureHandle{cask::DrawKeys::untextured + 1});
+            keys.build();
+
+            THEN("the new rejection is counted once") {
+                REQUIRE(keys.rejected_ == std::vector<uint32_t>{0, 3});
+                REQUIRE(keys.rejected_ids_ == 3);
+                REQUIRE(keys.keys().size() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("the radix sorter orders keys like a stable sort", "[draw_keys]") {
+    GIVEN("a small set of random keys") {
+        THEN("a single worker matches std::stable_sort") {
+            REQUIRE(sorted_like_std(random_keys(1000, 1), 1));
+        }
+    }
+
+    GIVEN("keys with repeated values") {
+        auto keys = random_keys(1000, 2);
+        for (auto& entry : keys) {
+            entry.key %= 5;
+        }
+
+        THEN("equal keys keep their order") {
+            REQUIRE(sorted_like_std(keys, 1));
+        }
+    }
+
+    GIVEN("enough keys to sort in parallel") {
+        THEN("several workers match std::stable_sort") {
+            REQUIRE(sorted_like_std(random_keys(cask::RadixSorter::parallel_threshold * 2 + 17, 3), 4));
+        }
+
+        THEN("one sorter reuses its worker threads across sorts") {
+            cask::RadixSorter sorter;
+            for (uint32_t round = 0; round < 3; ++round) {
+                auto keys = random_keys(cask::RadixSorter::parallel_threshold + round, round);
+                sorter.sort(keys, 4);
+                REQUIRE(std::is_sorted(keys.begin(), keys.end(), [](auto& a, auto& b) { return a.key < b.key; }));
+                REQUIRE(sorter.pool_->size() == 3);
+            }
+            auto keys = random_keys(cask::RadixSorter::parallel_threshold, 9);
+            sorter.sort(keys, 2);
+            REQUIRE(std::is_sorted(keys.begin(), keys.end(), [](auto& a, auto& b) { return a.key < b.key; }));
+            REQUIRE(sorter.pool_->size() == 3);
+        }
+    }
+}
+
+SCENARIO("draw keys rebuild only what changed", "[draw_keys]") {
+    GIVEN("ten thousand meshed entities after a first build") {
+        DrawFixture fixture(10000);
+        fixture.keys.build();
+
+        THEN("the buffer is fully sorted once") {
+            REQUIRE(fixture.keys.full_sorts_ == 1);
+            REQUIRE(fixture.built() == fixture.expected());
+        }
+
+        WHEN("nothing changes") {
+            fixture.keys.build();
+
+            THEN("no work is done") {
+                REQUIRE(fixture.keys.full_sorts_ == 1);
+                REQUIRE(fixture.keys.patches_ == 0);
+            }
+        }
+
+        WHEN("a few textures, meshes and entities change") {
+            for (uint32_t entity = 0; entity < 100; ++entity) {
+                fixture.textures.insert(entity * 37, TextureHandle{entity});
+            }
+            fixture.meshes.insert(5, MeshHandle{0});
+            fixture.meshes.remove(6);
+            fixture.meshes.insert(20000, MeshHandle{3});
+            fixture.keys.build();
+
+            THEN("the changes are patched in and match a full sort") {
+                REQUIRE(fixture.keys.full_sorts_ == 1);
+                REQUIRE(fixture.keys.patches_ == 1);
+                REQUIRE(fixture.built() == fixture.expected());
+            }
+        }
+
+        WHEN("most entries change") {
+            for (uint32_t entity = 0; entity < 10000; ++entity) {
+                fixture.meshes.insert(entity, MeshHandle{entity % 3});
+            }
+            fixture.keys.build();
+
+            THEN("the buffer is sorted again from scratch") {
+                REQUIRE(fixture.keys.full_sorts_ == 2);
+                REQUIRE(fixture.built() == fixture.expected());
+            }
+        }
+
+        WHEN("it is invalidated") {
+            fixture.keys.invalidate();
+            fixture.keys.build();
+
+            THEN("the next build sorts everything") {
+                REQUIRE(fixture.keys.full_sorts_ == 2);
+                REQUIRE(fixture.built() == fixture.expected());
+            }
+        }
+    }
+}
+
+SCENARIO("draw keys skip the scan while their stores are unchanged", "[draw_keys]") {
+    GIVEN("draw keys tracking both stores in StoreGenerations after a first build") {
+        DrawFixture fixture(1000);
+        cask::StoreGenerations generations;
+        fixture.keys.track(generations);
+        fixture.keys.build();
+        size_t scans = fixture.keys.scans_;
+
+        WHEN("frames run without writes") {
+            fixture.keys.build();
+            fixture.keys.build();
+
+            THEN("the stores are not scanned again") {
+                REQUIRE(fixture.keys.scans_ == scans);
+                REQUIRE(fixture.built() == fixture.expected());
+            }
+        }
+
+        WHEN("a texture is rewritten in place and the write is recorded") {
+            fixture.textures.get(1) = TextureHandle{255};
+            generations.touch(&fixture.textures, 1);
+            fixture.keys.build();
+
+            THEN("the keys are rescanned and patched") {
+                REQUIRE(fixture.keys.scans_ == scans + 1);
+                REQUIRE(fixture.keys.patches_ == 1);
+                REQUIRE(fixture.built() == fixture.expected());
+            }
+        }
+
+        WHEN("an entity gains a mesh") {
+            fixture.meshes.insert(5000, MeshHandle{1});
+            fixture.keys.build();
+
+            THEN("the size change triggers a scan") {
+                REQUIRE(fixture.keys.scans_ == scans + 1);
+                REQUIRE(fixture.built() == fixture.expected());
+            }
+        }
+
+        WHEN("layers change and the keys are invalidated") {
+            fixture.keys.layer_ = [](uint32_t entity) { return uint16_t(entity % 7); };
+            fixture.keys.invalidate();
+            fixture.keys.build();
+
+            THEN("the next build rescans with the new layers") {
+                REQUIRE(fixture.keys.scans_ == scans + 1);
+                REQUIRE(fixture.built() == fixture.expected());
+            }
+        }
+    }
+}
+
+static double milliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+SCENARIO("draw key building is benchmarked", "[.][benchmark][draw_keys]") {
+    for (uint32_t count : {100000u, 1000000u}) {
+        GIVEN(std::to_string(count) + " meshed entities") {
+            using Clock = std::chrono::steady_clock;
+            DrawFixture fixture(count);
+
+            auto start = Clock::now();
+            fixture.keys.build();
+            double full = milliseconds(Clock::now() - start);
+
+            for (uint32_t entity = 0; entity < count; entity += 100) {
+                fixture.textures.insert(entity, TextureHandle{entity % 97});
+            }
+            start = Clock::now();
+            fixture.keys.build();
+            double patched = milliseconds(Clock::now() - start);
+
+            start = Clock::now();
+            fixture.keys.build();
+            double unchanged = milliseconds(Clock::now() - start);
+
+            fixture.keys.invalidate();
+            start = Clock::now();
+            fixture.keys.build();
+            double resorted = milliseconds(Clock::now() - start);
+
+            auto keys = std::vector<cask::DrawKey>(fixture.keys.keys().begin(), fixture.keys.keys().end());
+            std::shuffle(keys.begin(), keys.end(), std::mt19937(count));
+            start = Clock::now();
+            std::sort(keys.begin(), keys.end(), [](auto& a, auto& b) { return a.key < b.key; });
+            double standard = milliseconds(Clock::now() - start);
+
+            WARN(count << " entities: first build " << full << " ms, 1% changed " << patched << " ms, unchanged "
+                       << unchanged << " ms, warm full sort " << resorted << " ms, std::sort alone " << standard << " ms");
+            REQUIRE(fixture.built() == fixture.expected());
+        }
+    }
+}
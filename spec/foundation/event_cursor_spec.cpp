@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/event_cursor.hpp>
+#include <cask/event/event_swapper.hpp>
+
+struct CursorEvent {
+    int value;
+};
+
+struct CursorContext {
+    EventSwapper swapper;
+    EventQueue<CursorEvent> queue;
+    cask::EventGenerations generations;
+
+    CursorContext() {
+        swapper.add(&queue, swap_queue<CursorEvent>);
+        swapper.add(generations.add(&queue), cask::advance_generation);
+    }
+
+    cask::EventCursor<CursorEvent> cursor() {
+        return cask::EventCursor<CursorEvent>(&queue, generations.find(&queue));
+    }
+};
+
+SCENARIO("event cursors share the swapped buffer without copying", "[event_cursor]") {
+    GIVEN("two cursors over one queue") {
+        CursorContext context;
+        auto first = context.cursor();
+        auto second = context.cursor();
+
+        WHEN("events are swapped in") {
+            context.queue.emit(CursorEvent{1});
+            context.queue.emit(CursorEvent{2});
+            context.swapper.swap_all();
+
+            THEN("both cursors see the events") {
+                REQUIRE(first.pending());
+                auto seen_by_first = first.read();
+                auto seen_by_second = second.read();
+                REQUIRE(seen_by_first.size() == 2);
+                REQUIRE(seen_by_second.size() == 2);
+                REQUIRE(seen_by_first[1].value == 2);
+            }
+
+            THEN("the spans point into the queue buffer") {
+                REQUIRE(first.read().data() == context.queue.poll().data());
+            }
+
+            THEN("a cursor reads each swap only once") {
+                REQUIRE(first.read().size() == 2);
+                REQUIRE_FALSE(first.pending());
+                REQUIRE(first.read().empty());
+                REQUIRE(second.read().size() == 2);
+            }
+        }
+
+        WHEN("nothing has been swapped") {
+            THEN("the cursors have nothing to read") {
+                REQUIRE_FALSE(first.pending());
+                REQUIRE(first.read().empty());
+            }
+        }
+    }
+}
+
+SCENARIO("event cursors count swaps they did not read", "[event_cursor]") {
+    GIVEN("a lenient cursor that skips a swap") {
+        CursorContext context;
+        auto cursor = context.cursor();
+        cursor.strict_ = false;
+
+        context.queue.emit(CursorEvent{1});
+        context.swapper.swap_all();
+        context.queue.emit(CursorEvent{2});
+        context.swapper.swap_all();
+
+        WHEN("it reads") {
+            auto events = cursor.read();
+
+            THEN("it sees only the latest swap and records the miss") {
+                REQUIRE(events.size() == 1);
+                REQUIRE(events[0].value == 2);
+                REQUIRE(cursor.missed() == 1);
+            }
+        }
+    }
+
+    GIVEN("a cursor that reads after every swap") {
+        CursorContext context;
+        auto cursor = context.cursor();
+
+        for (int tick = 0; tick < 3; ++tick) {
+            context.queue.emit(CursorEvent{tick});
+            context.swapper.swap_all();
+            cursor.read();
+        }
+
+        THEN("no swap is missed") {
+            REQUIRE(cursor.missed() == 0);
+        }
+    }
+
+    GIVEN("a cursor created after earlier swaps") {
+        CursorContext context;
+        context.swapper.swap_all();
+        context.swapper.swap_all();
+        auto cursor = context.cursor();
+
+        THEN("earlier swaps are not counted as missed") {
+            context.swapper.swap_all();
+            cursor.read();
+            REQUIRE(cursor.missed() == 0);
+        }
+    }
+}
+
+SCENARIO("event cursors without a generation read the queue directly", "[event_cursor]") {
+    GIVEN("a cursor over a queue that is not tracked") {
+        EventQueue<CursorEvent> queue;
+        cask::EventCursor<CursorEvent> cursor(&queue, nullptr);
+        queue.emit(CursorEvent{4});
+        queue.swap();
+
+        THEN("every read returns the current batch") {
+            REQUIRE(cursor.read().size() == 1);
+            REQUIRE(cursor.read().size() == 1);
+            REQUIRE(cursor.missed() == 0);
+        }
+    }
+
+    GIVEN("a default cursor") {
+        cask::EventCursor<CursorEvent> cursor;
+
+        THEN("it reads nothing") {
+            REQUIRE(cursor.read().empty());
+        }
+    }
+}
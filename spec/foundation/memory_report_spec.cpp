@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/world/world.hpp>
+#include <cask/world/abi_internal.hpp>
+#include <cask/world.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/resource/resource_store.hpp>
+#include <cask/foundation/memory_report.hpp>
+
+struct Position {
+    float x;
+    float y;
+};
+
+SCENARIO("memory report measures tracked component stores", "[memory_report]") {
+    GIVEN("a report tracking a store with reserved capacity") {
+        cask::MemoryReport report;
+        ComponentStore<Position> store;
+        for (uint32_t entity = 0; entity < 100; ++entity) {
+            store.insert(entity, Position{1.0f, 2.0f});
+        }
+        report.track("PositionComponents", &store);
+
+        WHEN("the store is measured") {
+            auto usage = report.measure("PositionComponents");
+
+            THEN("used bytes cover every component and entity") {
+                REQUIRE(usage.used >= 100 * (sizeof(Position) + sizeof(uint32_t)));
+            }
+
+            THEN("reserved bytes are at least the used bytes") {
+                REQUIRE(usage.reserved >= usage.used);
+            }
+        }
+
+        WHEN("an entity with a high id is added") {
+            auto before = report.measure("PositionComponents");
+            store.insert(10000, Position{});
+            auto after = report.measure("PositionComponents");
+
+            THEN("the sparse index growth is counted") {
+                REQUIRE(after.used - before.used >= 9900 * sizeof(store.sparse_[0]));
+            }
+        }
+
+        WHEN("entities are removed") {
+            auto before = report.measure("PositionComponents");
+            for (uint32_t entity = 0; entity < 50; ++entity) {
+                store.remove(entity);
+            }
+            auto after = report.measure("PositionComponents");
+
+            THEN("used bytes drop while reserved bytes remain") {
+                REQUIRE(after.used < before.used);
+                REQUIRE(after.reserved == before.reserved);
+            }
+        }
+    }
+}
+
+SCENARIO("memory report measures both event queue buffers", "[memory_report]") {
+    GIVEN("a report tracking a queue") {
+        cask::MemoryReport report;
+        EventQueue<Position> queue;
+        report.track("PositionQueue", &queue);
+        auto empty = report.measure("PositionQueue");
+
+        WHEN("events are emitted but not yet swapped") {
+            for (int count = 0; count < 10; ++count) {
+                queue.emit(Position{});
+            }
+
+            THEN("the pending events are counted") {
+                REQUIRE(report.measure("PositionQueue").used - empty.used >= 10 * sizeof(Position));
+            }
+        }
+
+        WHEN("events are swapped and more are emitted") {
+            for (int count = 0; count < 10; ++count) {
+                queue.emit(Position{});
+            }
+            queue.swap();
+            for (int count = 0; count < 5; ++count) {
+                queue.emit(Position{});
+            }
+
+            THEN("both buffers are counted") {
+                REQUIRE(report.measure("PositionQueue").used - empty.used >= 15 * sizeof(Position));
+            }
+
+            THEN("measuring leaves the queue untouched") {
+                report.measure("PositionQueue");
+                REQUIRE(queue.poll().size() == 10);
+            }
+
+            THEN("the reserved bytes cover both buffers' capacity") {
+                REQUIRE(report.measure("PositionQueue").reserved - empty.reserved >= 15 * sizeof(Position));
+            }
+        }
+    }
+}
+
+SCENARIO("memory report totals and describes every tracked component", "[memory_report]") {
+    GIVEN("a report tracking a store, a queue and a resource store") {
+        cask::MemoryReport report;
+        ComponentStore<Position> store;
+        store.insert(0, Position{});
+        EventQueue<Position> queue;
+        queue.emit(Position{});
+        queue.swap();
+        ResourceStore<Position> resources;
+        report.track("PositionComponents", &store);
+        report.track("PositionQueue", &queue);
+        report.track("PositionStore", &resources);
+
+        WHEN("a snapshot is taken") {
+            auto rows = report.snapshot();
+
+            THEN("every component has a row in registration order") {
+                REQUIRE(rows.size() == 3);
+                REQUIRE(rows[0].first == "PositionComponents");
+                REQUIRE(rows[1].first == "PositionQueue");
+                REQUIRE(rows[2].first == "PositionStore");
+            }
+
+            THEN("the total is the sum of the rows") {
+                size_t used = 0;
+                for (auto& [name, usage] : rows) {
+                    used += usage.used;
+                }
+                REQUIRE(report.total().used == used);
+            }
+
+            THEN("the description lists each component and the total") {
+                auto text = report.describe();
+                REQUIRE(text.find("PositionQueue: ") != std::string::npos);
+                REQUIRE(text.find("total: ") != std::string::npos);
+            }
+        }
+
+        WHEN("a component is untracked") {
+            report.untrack(&queue);
+
+            THEN("it no longer appears") {
+                REQUIRE(report.snapshot().size() == 2);
+            }
+        }
+
+        WHEN("a component is forgotten by name") {
+            report.forget("PositionStore");
+
+            THEN("only that row is removed") {
+                auto rows = report.snapshot();
+                REQUIRE(rows.size() == 2);
+                REQUIRE(rows[1].first == "PositionQueue");
+            }
+        }
+    }
+}
+
+SCENARIO("track_memory records only when the world has a MemoryReport", "[memory_report]") {
+    GIVEN("a world with a MemoryReport") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        cask::MemoryReport report;
+        uint32_t report_id = world.register_component("MemoryReport");
+        world.bind(report_id, &report);
+        ComponentStore<Position> store;
+
+        WHEN("a component is tracked") {
+            cask::track_memory(handle, "PositionComponents", &store);
+
+            THEN("the report lists it") {
+                REQUIRE(report.entries_.size() == 1);
+                REQUIRE(report.entries_[0].name == "PositionComponents");
+            }
+
+            THEN("untrack_memory removes it by name") {
+                cask::untrack_memory(handle, "PositionComponents");
+                REQUIRE(report.entries_.empty());
+            }
+        }
+    }
+
+    GIVEN("a world without a MemoryReport") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        cask::WorldView view(handle);
+        ComponentStore<Position> store;
+
+        THEN("tracking is a no-op") {
+            cask::track_memory(view, "PositionComponents", &store);
+            REQUIRE(view.resolve<cask::MemoryReport>("MemoryReport") == nullptr);
+        }
+    }
+}
@@ -0,0 +1,250 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_compactor.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/foundation/mesh_instances.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/command_buffer.hpp>
+#include <cask/foundation/prefab.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <algorithm>
+#include <vector>
+
+struct InstanceDestroy {
+    uint32_t entity;
+};
+
+struct InstanceFixture {
+    EntityTable table;
+    EntityCompactor compactor;
+    cask::EntityWatchers watchers;
+    ComponentStore<MeshHandle> meshes;
+    cask::MeshInstances instances;
+
+    InstanceFixture() {
+        compactor.table_ = &table;
+        watchers.attach(compactor);
+        compactor.add(&meshes, remove_component<MeshHandle>);
+        instances.watch(&meshes, watchers);
+    }
+
+    void destroy(uint32_t entity) {
+        EventQueue<InstanceDestroy> queue;
+        queue.emit(InstanceDestroy{entity});
+        queue.swap();
+        compactor.compact(queue);
+    }
+};
+
+static std::vector<uint32_t> sorted(std::span<const uint32_t> entities) {
+    std::vector<uint32_t> result(entities.begin(), entities.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+SCENARIO("mesh instances group entities by mesh handle", "[mesh_instances]") {
+    GIVEN("six entities spread over three meshes") {
+        InstanceFixture fixture;
+        std::vector<uint32_t> entities;
+        for (uint32_t index = 0; index < 6; ++index) {
+            entities.push_back(fixture.table.create());
+            fixture.instances.assign(entities.back(), MeshHandle{index % 3});
+        }
+
+        THEN("each batch holds the entities using that mesh") {
+            REQUIRE(sorted(fixture.instances.instances(MeshHandle{0})) == std::vector<uint32_t>{entities[0], entities[3]});
+            REQUIRE(sorted(fixture.instances.instances(MeshHandle{2})) == std::vector<uint32_t>{entities[2], entities[5]});
+            REQUIRE(fixture.instances.instances(MeshHandle{7}).empty());
+            REQUIRE(fixture.instances.size() == 6);
+        }
+
+        THEN("each_batch visits every non-empty mesh once") {
+            size_t batches = 0;
+            size_t total = 0;
+            fixture.instances.each_batch([&](MeshHandle, std::span<const uint32_t> batch) {
+                ++batches;
+                total += batch.size();
+            });
+            REQUIRE(batches == 3);
+            REQUIRE(total == 6);
+        }
+
+        WHEN("an entity is reassigned to another mesh") {
+            size_t rebuilds = fixture.instances.rebuilds_;
+            fixture.instances.assign(entities[0], MeshHandle{1});
+
+            THEN("it moves between batches without a rebuild") {
+                REQUIRE(sorted(fixture.instances.instances(MeshHandle{0})) == std::vector<uint32_t>{entities[3]});
+                REQUIRE(fixture.instances.instances(MeshHandle{1}).size() == 3);
+                REQUIRE(fixture.meshes.get(entities[0]).id == 1);
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+            }
+        }
+
+        WHEN("entities are removed directly and through the compactor") {
+            size_t rebuilds = fixture.instances.rebuilds_;
+            fixture.instances.remove(entities[1]);
+            fixture.destroy(entities[4]);
+
+            THEN("their batch is empty and nothing was rebuilt") {
+                REQUIRE(fixture.instances.instances(MeshHandle{1}).empty());
+                REQUIRE(fixture.instances.size() == 4);
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+                REQUIRE_FALSE(fixture.meshes.has(entities[1]));
+            }
+        }
+
+        WHEN("the store is filled directly") {
+            uint32_t loaded = fixture.table.create();
+            fixture.meshes.insert(loaded, MeshHandle{2});
+
+            THEN("the index rebuilds on the next read") {
+                REQUIRE(fixture.instances.instances(MeshHandle{2}).size() == 3);
+                REQUIRE(fixture.instances.size() == 7);
+            }
+        }
+
+        WHEN("a handle is changed in place and the index is invalidated") {
+            fixture.meshes.get(entities[5]) = MeshHandle{0};
+            fixture.instances.invalidate();
+
+            THEN("the rebuilt batches reflect the change") {
+                REQUIRE(fixture.instances.instances(MeshHandle{0}).size() == 3);
+                REQUIRE(fixture.instances.instances(MeshHandle{2}).size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("mesh instances skip entities retiring under an amortized compactor", "[mesh_instances]") {
+    GIVEN("three entities on one mesh and an amortized compactor limited to one entity per compaction") {
+        InstanceFixture fixture;
+        cask::AmortizedCompactor amortized;
+        amortized.entity_budget_ = 1;
+        fixture.watchers.attach(amortized);
+        std::vector<uint32_t> entities;
+        for (uint32_t index = 0; index < 3; ++index) {
+            entities.push_back(fixture.table.create());
+            fixture.instances.assign(entities.back(), MeshHandle{0});
+        }
+        fixture.instances.size();
+        size_t indexed = fixture.instances.rebuilds_;
+
+        WHEN("two entities are destroyed and only one is compacted") {
+            EventQueue<DestroyEntity> queue;
+            queue.emit(DestroyEntity{entities[0]});
+            queue.emit(DestroyEntity{entities[1]});
+            queue.swap();
+            amortized.compact(fixture.compactor, queue);
+
+            THEN("the retiring entity is left out of its batch while its handle remains") {
+                REQUIRE(fixture.meshes.has(entities[1]));
+                REQUIRE(sorted(fixture.instances.instances(MeshHandle{0})) == std::vector<uint32_t>{entities[2]});
+                REQUIRE(fixture.instances.size() == 1);
+            }
+
+            THEN("only the retired ids leave their batches without a rebuild") {
+                REQUIRE(fixture.instances.size() == 1);
+                REQUIRE(fixture.instances.rebuilds_ == indexed);
+            }
+
+            THEN("compacting the rest keeps the index without another rebuild") {
+                fixture.instances.size();
+                size_t rebuilds = fixture.instances.rebuilds_;
+                queue.swap();
+                amortized.compact(fixture.compactor, queue);
+                REQUIRE_FALSE(fixture.meshes.has(entities[1]));
+                REQUIRE(fixture.instances.size() == 1);
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+            }
+        }
+    }
+}
+
+SCENARIO("mesh instances apply per-entity writes recorded in StoreGenerations", "[mesh_instances]") {
+    GIVEN("indexed entities on two meshes observed through StoreGenerations") {
+        InstanceFixture fixture;
+        cask::StoreGenerations generations;
+        fixture.instances.track(generations);
+        std::vector<uint32_t> entities;
+        for (uint32_t index = 0; index < 4; ++index) {
+            entities.push_back(fixture.table.create());
+            fixture.instances.assign(entities.back(), MeshHandle{index % 2});
+        }
+        fixture.instances.size();
+        size_t rebuilds = fixture.instances.rebuilds_;
+
+        WHEN("a command buffer removes one handle and inserts another in the same playback") {
+            uint32_t spawned = fixture.table.create();
+            EventQueue<DestroyEntity> destroy_queue;
+            cask::CommandBuffer buffer;
+            buffer.remove(&fixture.meshes, entities[0]);
+            buffer.insert(&fixture.meshes, spawned, MeshHandle{1});
+            std::vector<uint32_t> created;
+            buffer.play(fixture.table, destroy_queue, created, &generations);
+
+            THEN("both entities move in the index without a rebuild") {
+                REQUIRE(fixture.meshes.size() == 4);
+                REQUIRE(sorted(fixture.instances.instances(MeshHandle{0})) == std::vector<uint32_t>{entities[2]});
+                REQUIRE(sorted(fixture.instances.instances(MeshHandle{1})) == std::vector<uint32_t>{entities[1], entities[3], spawned});
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+            }
+        }
+
+        WHEN("a prefab spawns entities into the mesh store") {
+            cask::Prefabs prefabs;
+            prefabs.generations_ = &generations;
+            prefabs.prefabs_["rock"].add(&fixture.meshes, MeshHandle{2});
+            std::vector<uint32_t> created;
+            prefabs.instantiate("rock", fixture.table, 3, created);
+
+            THEN("the spawned entities join their batch without a rebuild") {
+                REQUIRE(sorted(fixture.instances.instances(MeshHandle{2})) == sorted(created));
+                REQUIRE(fixture.instances.size() == 7);
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+            }
+        }
+
+        WHEN("a handle is rewritten in place and the entity is touched") {
+            fixture.meshes.get(entities[1]) = MeshHandle{0};
+            generations.touch(&fixture.meshes, entities[1]);
+
+            THEN("the index reflects the new handle without a rebuild") {
+                REQUIRE(fixture.instances.instances(MeshHandle{0}).size() == 3);
+                REQUIRE(sorted(fixture.instances.instances(MeshHandle{1})) == std::vector<uint32_t>{entities[3]});
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+            }
+        }
+
+        WHEN("the whole store is touched") {
+            fixture.meshes.get(entities[1]) = MeshHandle{0};
+            generations.touch(&fixture.meshes);
+
+            THEN("the index is rebuilt on the next read") {
+                REQUIRE(fixture.instances.instances(MeshHandle{0}).size() == 3);
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds + 1);
+            }
+        }
+
+        WHEN("the index stops tracking and the store is touched") {
+            fixture.instances.untrack();
+            generations.touch(&fixture.meshes, entities[1]);
+
+            THEN("it no longer observes the store") {
+                REQUIRE(generations.observers_.empty());
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+            }
+        }
+
+        WHEN("entities are assigned through the index") {
+            fixture.instances.assign(fixture.table.create(), MeshHandle{0});
+
+            THEN("no rebuild is needed") {
+                REQUIRE(fixture.instances.size() == 5);
+                REQUIRE(fixture.instances.rebuilds_ == rebuilds);
+            }
+        }
+    }
+}
@@ -0,0 +1,245 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cask/foundation/mesh_optimizer.hpp>
+#include <algorithm>
+#include <random>
+
+static cask::MeshBuffers unindexed_grid(uint32_t cells) {
+    cask::MeshBuffers mesh;
+    mesh.stride = 3;
+    for (uint32_t row = 0; row < cells; ++row) {
+        for (uint32_t column = 0; column < cells; ++column) {
+            float corners[4][3] = {
+                {float(column), float(row), 0.0f},
+                {float(column + 1), float(row), 0.0f},
+                {float(column), float(row + 1), 0.0f},
+                {float(column + 1), float(row + 1), 0.0f}
+            };
+            int order[6] = {0, 1, 2, 2, 1, 3};
+            for (int corner : order) {
+                mesh.indices.push_back(uint32_t(mesh.vertex_count()));
+                mesh.vertices.insert(mesh.vertices.end(), corners[corner], corners[corner] + 3);
+            }
+        }
+    }
+    return mesh;
+}
+
+static void shuffle_triangles(cask::MeshBuffers& mesh) {
+    size_t triangle_count = mesh.indices.size() / 3;
+    std::vector<size_t> order(triangle_count);
+    for (size_t triangle = 0; triangle < triangle_count; ++triangle) {
+        order[triangle] = triangle;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    std::vector<uint32_t> shuffled;
+    for (size_t triangle : order) {
+        shuffled.insert(shuffled.end(), &mesh.indices[triangle * 3], &mesh.indices[triangle * 3] + 3);
+    }
+    mesh.indices = shuffled;
+}
+
+static std::vector<std::vector<float>> triangle_positions(const cask::MeshBuffers& mesh) {
+    std::vector<std::vector<float>> triangles;
+    for (size_t triangle = 0; triangle < mesh.indices.size() / 3; ++triangle) {
+        std::vector<float> positions;
+        for (size_t corner = 0; corner < 3; ++corner) {
+            const float* vertex = &mesh.vertices[size_t(mesh.indices[triangle * 3 + corner]) * mesh.stride];
+            positions.insert(positions.end(), vertex, vertex + mesh.stride);
+        }
+        triangles.push_back(positions);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+SCENARIO("deduplicating vertices merges bitwise identical vertices", "[mesh_optimizer]") {
+    GIVEN("an unindexed 4x4 grid") {
+        auto mesh = unindexed_grid(4);
+        auto before = triangle_positions(mesh);
+
+        WHEN("vertices are deduplicated") {
+            cask::deduplicate_vertices(mesh);
+
+            THEN("only the 25 grid corners remain") {
+                REQUIRE(mesh.vertex_count() == 25);
+            }
+
+            THEN("every triangle still references the same positions") {
+                REQUIRE(triangle_positions(mesh) == before);
+            }
+        }
+    }
+}
+
+SCENARIO("vertex cache optimization lowers the cache miss ratio", "[mesh_optimizer]") {
+    GIVEN("a deduplicated 64x64 grid with shuffled triangles") {
+        auto mesh = unindexed_grid(64);
+        cask::deduplicate_vertices(mesh);
+        shuffle_triangles(mesh);
+        auto before = triangle_positions(mesh);
+        float ratio_before = cask::average_cache_miss_ratio(mesh.indices, mesh.vertex_count());
+
+        WHEN("indices are reordered for the vertex cache") {
+            cask::optimize_vertex_cache(mesh);
+            float ratio_after = cask::average_cache_miss_ratio(mesh.indices, mesh.vertex_count());
+
+            THEN("the cache miss ratio drops well below the shuffled order") {
+                REQUIRE(ratio_after < ratio_before * 0.5f);
+            }
+
+            THEN("the triangle set is unchanged") {
+                REQUIRE(triangle_positions(mesh) == before);
+            }
+        }
+    }
+}
+
+SCENARIO("vertex fetch optimization orders vertices by first use", "[mesh_optimizer]") {
+    GIVEN("a mesh whose indices reference vertices out of order with one unused vertex") {
+        cask::MeshBuffers mesh;
+        mesh.stride = 1;
+        mesh.vertices = {10.0f, 11.0f, 12.0f, 13.0f};
+        mesh.indices = {3, 1, 0};
+
+        WHEN("vertices are reordered for fetch") {
+            cask::optimize_vertex_fetch(mesh);
+
+            THEN("indices become sequential") {
+                REQUIRE(mesh.indices == std::vector<uint32_t>{0, 1, 2});
+            }
+
+            THEN("vertices follow first use and the unused vertex is dropped") {
+                REQUIRE(mesh.vertices == std::vector<float>{13.0f, 11.0f, 10.0f});
+            }
+        }
+    }
+}
+
+SCENARIO("half precision quantization round-trips representable values", "[mesh_optimizer]") {
+    THEN("exact values survive the round trip") {
+        REQUIRE(cask::half_to_float(cask::float_to_half(1.0f)) == 1.0f);
+        REQUIRE(cask::half_to_float(cask::float_to_half(-2.5f)) == -2.5f);
+        REQUIRE(cask::half_to_float(cask::float_to_half(0.0f)) == 0.0f);
+    }
+
+    THEN("subnormal halves are preserved") {
+        float smallest = std::ldexp(1.0f, -24);
+        REQUIRE(cask::half_to_float(cask::float_to_half(smallest)) == smallest);
+    }
+
+    THEN("values beyond half range saturate to infinity") {
+        REQUIRE(std::isinf(cask::half_to_float(cask::float_to_half(1.0e6f))));
+    }
+
+    THEN("rounding stays within half precision") {
+        float value = 0.1f;
+        REQUIRE(std::fabs(cask::half_to_float(cask::float_to_half(value)) - value) < 0.0001f);
+    }
+}
+
+SCENARIO("mesh optimizer reports memory savings", "[mesh_optimizer]") {
+    GIVEN("an unindexed 32x32 grid") {
+        auto mesh = unindexed_grid(32);
+        cask::MeshOptimizer optimizer;
+
+        WHEN("the mesh is optimized") {
+            auto report = optimizer.optimize(mesh);
+
+            THEN("the vertex count shrinks to the grid corners") {
+                REQUIRE(report.valid);
+                REQUIRE(report.vertices_before == 32 * 32 * 6);
+                REQUIRE(report.vertices_after == 33 * 33);
+            }
+
+            THEN("the optimized size is smaller than the authored size") {
+                REQUIRE(report.bytes_after < report.bytes_before);
+                REQUIRE(report.bytes_after == cask::mesh_bytes(mesh));
+            }
+
+            THEN("the optimizer accumulates the savings") {
+                REQUIRE(optimizer.meshes_optimized == 1);
+                REQUIRE(optimizer.bytes_saved == report.bytes_before - report.bytes_after);
+            }
+
+            THEN("quantizing the optimized mesh halves the vertex payload") {
+                auto quantized = cask::quantize_half(mesh);
+                REQUIRE(quantized.vertices.size() * sizeof(uint16_t) * 2 == mesh.vertices.size() * sizeof(float));
+            }
+        }
+    }
+}
+
+SCENARIO("mesh optimizer rejects meshes with invalid indices", "[mesh_optimizer]") {
+    GIVEN("a mesh whose indices reference a vertex past the end") {
+        cask::MeshBuffers mesh;
+        mesh.stride = 3;
+        mesh.vertices = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+        mesh.indices = {0, 1, 3};
+        cask::MeshOptimizer optimizer;
+
+        WHEN("the mesh is optimized") {
+            auto report = optimizer.optimize(mesh);
+
+            THEN("it is left untouched and counted as rejected") {
+                REQUIRE_FALSE(report.valid);
+                REQUIRE(mesh.indices == std::vector<uint32_t>{0, 1, 3});
+                REQUIRE(mesh.vertices.size() == 9);
+                REQUIRE(optimizer.meshes_rejected == 1);
+                REQUIRE(optimizer.meshes_optimized == 0);
+            }
+        }
+    }
+
+    GIVEN("a mesh with a trailing partial triangle") {
+        cask::MeshBuffers mesh;
+        mesh.stride = 3;
+        mesh.vertices = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+        mesh.indices = {0, 1, 2, 0};
+
+        THEN("its indices are not valid") {
+            REQUIRE_FALSE(cask::valid_indices(mesh));
+        }
+    }
+}
+
+SCENARIO("mesh optimizer rejects meshes with a partial trailing vertex", "[mesh_optimizer]") {
+    GIVEN("a mesh whose vertex floats are not a multiple of the stride") {
+        MeshData mesh;
+        mesh.vertices = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1};
+        mesh.indices = {0, 1, 2};
+        cask::MeshOptimizer optimizer;
+        optimizer.vertex_stride = 3;
+
+        WHEN("the loaded mesh is optimized") {
+            auto report = optimizer.optimize(mesh);
+
+            THEN("it is handed back untouched") {
+                REQUIRE_FALSE(report.valid);
+                REQUIRE(mesh.vertices.size() == 10);
+                REQUIRE(mesh.indices == std::vector<uint32_t>{0, 1, 2});
+                REQUIRE(optimizer.meshes_rejected == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("optimizing a large mesh is benchmarked", "[.][mesh_optimizer][benchmark]") {
+    GIVEN("an unindexed 256x256 grid with shuffled triangles") {
+        auto authored = unindexed_grid(256);
+        shuffle_triangles(authored);
+        cask::MeshOptimizer optimizer;
+
+        BENCHMARK("deduplicate only") {
+            auto mesh = authored;
+            optimizer.reorder = false;
+            return optimizer.optimize(mesh).vertices_after;
+        };
+
+        BENCHMARK("deduplicate and reorder") {
+            auto mesh = authored;
+            optimizer.reorder = true;
+            return optimizer.optimize(mesh).cache_miss_ratio_after;
+        };
+    }
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+SCENARIO("metrics series are shared by name and labels", "[metrics]") {
+    GIVEN("a Metrics registry") {
+        cask::Metrics metrics;
+
+        WHEN("the same counter is requested twice") {
+            auto& first = metrics.counter("cask_hits_total", "Hits.");
+            auto& second = metrics.counter("cask_hits_total", "Hits.");
+
+            THEN("both refer to one series") {
+                REQUIRE(&first == &second);
+            }
+        }
+
+        WHEN("a counter is requested with different labels") {
+            auto& left = metrics.counter("cask_hits_total", "Hits.", cask::metric_label("side", "left"));
+            auto& right = metrics.counter("cask_hits_total", "Hits.", cask::metric_label("side", "right"));
+
+            THEN("each label set has its own series in one family") {
+                REQUIRE(&left != &right);
+                REQUIRE(metrics.families_.size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("counters are safe to increment from many threads", "[metrics]") {
+    GIVEN("a counter shared by four threads") {
+        cask::Metrics metrics;
+        auto& counter = metrics.counter("cask_work_total", "Work.");
+
+        WHEN("each thread adds ten thousand times") {
+            std::vector<std::thread> threads;
+            for (int thread = 0; thread < 4; ++thread) {
+                threads.emplace_back([&counter] {
+                    for (int index = 0; index < 10000; ++index) counter.add();
+                });
+            }
+            for (auto& thread : threads) thread.join();
+
+            THEN("no increment is lost") {
+                REQUIRE(counter.value() == 40000);
+            }
+        }
+    }
+}
+
+SCENARIO("metrics are exported in Prometheus text format", "[metrics]") {
+    GIVEN("a counter, a gauge and a histogram") {
+        cask::Metrics metrics;
+        metrics.counter("cask_loads_total", "Loads.", cask::metric_label("kind", "mesh")).add(5);
+        metrics.gauge("cask_depth", "Depth.").set(-2);
+        auto& histogram = metrics.histogram("cask_batch", "Batch size.", {1, 10});
+        histogram.observe(0);
+        histogram.observe(5);
+        histogram.observe(50);
+
+        WHEN("the registry is written") {
+            std::ostringstream out;
+            metrics.write_prometheus(out);
+            auto text = out.str();
+
+            THEN("each family has HELP and TYPE lines") {
+                REQUIRE(text.find("# HELP cask_loads_total Loads.\n# TYPE cask_loads_total counter\n") != std::string::npos);
+                REQUIRE(text.find("# TYPE cask_depth gauge\n") != std::string::npos);
+                REQUIRE(text.find("# TYPE cask_batch histogram\n") != std::string::npos);
+            }
+
+            THEN("samples carry their labels") {
+                REQUIRE(text.find("cask_loads_total{kind=\"mesh\"} 5\n") != std::string::npos);
+                REQUIRE(text.find("cask_depth -2\n") != std::string::npos);
+            }
+
+            THEN("histogram buckets are cumulative") {
+                REQUIRE(text.find("cask_batch_bucket{le=\"1\"} 1\n") != std::string::npos);
+                REQUIRE(text.find("cask_batch_bucket{le=\"10\"} 2\n") != std::string::npos);
+                REQUIRE(text.find("cask_batch_bucket{le=\"+Inf\"} 3\n") != std::string::npos);
+                REQUIRE(text.find("cask_batch_sum 55\n") != std::string::npos);
+                REQUIRE(text.find("cask_batch_count 3\n") != std::string::npos);
+            }
+        }
+    }
+
+    GIVEN("a label value with quotes and backslashes") {
+        THEN("it is escaped") {
+            REQUIRE(cask::metric_label("path", "a\"b\\c") == "path=\"a\\\"b\\\\c\"");
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/mip_chain.hpp>
+
+static cask::MipLevel gradient_level(uint32_t width, uint32_t height, uint32_t channels) {
+    cask::MipLevel level;
+    level.width = width;
+    level.height = height;
+    level.channels = channels;
+    level.pixels.resize(size_t(width) * height * channels);
+    for (size_t index = 0; index < level.pixels.size(); ++index) {
+        level.pixels[index] = uint8_t(index * 7);
+    }
+    return level;
+}
+
+SCENARIO("mip level count covers every halving down to 1x1", "[mip_chain]") {
+    THEN("a square power of two texture has log2 plus one levels") {
+        REQUIRE(cask::mip_level_count(256, 256) == 9);
+    }
+
+    THEN("a non-square texture follows its larger extent") {
+        REQUIRE(cask::mip_level_count(16, 4) == 5);
+    }
+
+    THEN("a 1x1 texture has a single level") {
+        REQUIRE(cask::mip_level_count(1, 1) == 1);
+    }
+}
+
+SCENARIO("downsampling averages each 2x2 block", "[mip_chain]") {
+    GIVEN("a 2x2 single channel level") {
+        cask::MipLevel level;
+        level.width = 2;
+        level.height = 2;
+        level.channels = 1;
+        level.pixels = {10, 20, 30, 41};
+
+        WHEN("it is downsampled") {
+            auto result = cask::downsample(level);
+
+            THEN("the result is a 1x1 rounded average") {
+                REQUIRE(result.width == 1);
+                REQUIRE(result.height == 1);
+                REQUIRE(result.pixels.size() == 1);
+                REQUIRE(result.pixels[0] == 25);
+            }
+        }
+    }
+
+    GIVEN("a 4x2 four channel level") {
+        auto level = gradient_level(4, 2, 4);
+
+        WHEN("it is downsampled") {
+            auto result = cask::downsample(level);
+
+            THEN("each channel is averaged independently") {
+                REQUIRE(result.width == 2);
+                REQUIRE(result.height == 1);
+                for (uint32_t channel = 0; channel < 4; ++channel) {
+                    uint32_t sum = uint32_t(level.pixels[channel]) + level.pixels[4 + channel]
+                        + level.pixels[16 + channel] + level.pixels[20 + channel];
+                    REQUIRE(result.pixels[channel] == uint8_t((sum + 2) >> 2));
+                }
+            }
+        }
+    }
+
+    GIVEN("a 1x4 level with five channels") {
+        auto level = gradient_level(1, 4, 5);
+
+        WHEN("it is downsampled") {
+            auto result = cask::downsample(level);
+
+            THEN("the single column is reused for both horizontal samples") {
+                REQUIRE(result.width == 1);
+                REQUIRE(result.height == 2);
+                uint32_t sum = 2 * (uint32_t(level.pixels[0]) + level.pixels[5]);
+                REQUIRE(result.pixels[0] == uint8_t((sum + 2) >> 2));
+            }
+        }
+    }
+}
+
+SCENARIO("building a mip chain halves down to 1x1", "[mip_chain]") {
+    GIVEN("a 16x4 texture") {
+        auto base = gradient_level(16, 4, 4);
+
+        WHEN("the chain is built") {
+            auto chain = cask::build_mip_chain(base);
+
+            THEN("it has one level per halving") {
+                REQUIRE(chain.size() == 5);
+            }
+
+            THEN("level zero is the source") {
+                REQUIRE(chain[0].width == 16);
+                REQUIRE(chain[0].pixels == base.pixels);
+            }
+
+            THEN("the last level is 1x1") {
+                REQUIRE(chain.back().width == 1);
+                REQUIRE(chain.back().height == 1);
+                REQUIRE(chain.back().pixels.size() == 4);
+            }
+        }
+    }
+}
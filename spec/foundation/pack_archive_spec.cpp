@@ -0,0 +1,318 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cask/foundation/pack_archive.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+struct PackDirectory {
+    std::string path;
+
+    PackDirectory() {
+        char directory[] = "/tmp/cask_pack_spec_XXXXXX";
+        path = mkdtemp(directory);
+    }
+
+    ~PackDirectory() {
+        std::filesystem::remove_all(path);
+    }
+
+    void write(const std::string& relative_path, const std::string& contents) {
+        std::filesystem::path file = std::filesystem::path(path) / "project" / relative_path;
+        std::filesystem::create_directories(file.parent_path());
+        std::ofstream(file, std::ios::binary) << contents;
+    }
+
+    std::string project() const {
+        return path + "/project";
+    }
+
+    std::string pack() const {
+        return path + "/assets.pack";
+    }
+};
+
+static std::vector<char> read_file(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream(path, std::ios::binary).write(bytes.data(), std::streamsize(bytes.size()));
+}
+
+static cask::PackHeader header_of(const std::vector<char>& bytes) {
+    cask::PackHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    return header;
+}
+
+static void evict_from_page_cache(const std::string& path) {
+#if defined(__linux__)
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) return;
+    ::fdatasync(descriptor);
+    ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(descriptor);
+#endif
+}
+
+static std::string as_string(std::span<const uint8_t> bytes) {
+    return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+SCENARIO("a packed project directory round-trips through the archive", "[pack_archive]") {
+    GIVEN("a project directory with nested files") {
+        PackDirectory directory;
+        directory.write("meshes/crate.obj", "v 0 0 0");
+        directory.write("textures/crate.png", std::string(1000, 'x'));
+        directory.write("empty.txt", "");
+
+        WHEN("it is packed and opened") {
+            REQUIRE(cask::write_pack(directory.project(), directory.pack()));
+            cask::PackArchive archive;
+            REQUIRE(archive.open(directory.pack()));
+
+            THEN("every file is listed in the table of contents") {
+                REQUIRE(archive.entry_count() == 3);
+            }
+
+            THEN("files are found by relative path with their contents") {
+                REQUIRE(as_string(archive.find("meshes/crate.obj")) == "v 0 0 0");
+                REQUIRE(as_string(archive.find("textures/crate.png")) == std::string(1000, 'x'));
+            }
+
+            THEN("empty files are present with zero length") {
+                REQUIRE(archive.contains("empty.txt"));
+                REQUIRE(archive.find("empty.txt").empty());
+            }
+
+            THEN("missing paths are not found") {
+                REQUIRE_FALSE(archive.contains("meshes/missing.obj"));
+                REQUIRE(archive.find("meshes/missing.obj").data() == nullptr);
+            }
+
+            THEN("blobs are aligned") {
+                auto blob = archive.find("textures/crate.png");
+                REQUIRE(uintptr_t(blob.data()) % cask::pack_alignment == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("opening an invalid archive fails cleanly", "[pack_archive]") {
+    GIVEN("a file that is not a pack") {
+        PackDirectory directory;
+        directory.write("bogus.pack", "not a pack file at all, just some text");
+
+        WHEN("it is opened") {
+            cask::PackArchive archive;
+            bool opened = archive.open(directory.project() + "/bogus.pack");
+
+            THEN("the archive stays closed") {
+                REQUIRE_FALSE(opened);
+                REQUIRE_FALSE(archive.is_open());
+                REQUIRE_FALSE(archive.contains("bogus.pack"));
+            }
+        }
+    }
+
+    GIVEN("a path that does not exist") {
+        cask::PackArchive archive;
+
+        THEN("opening it fails") {
+            REQUIRE_FALSE(archive.open("/nonexistent/assets.pack"));
+        }
+    }
+}
+
+SCENARIO("opening a corrupt archive fails instead of reading out of bounds", "[pack_archive]") {
+    GIVEN("a valid pack with two files") {
+        PackDirectory directory;
+        directory.write("meshes/crate.obj", "v 0 0 0");
+        directory.write("textures/crate.png", std::string(1000, 'x'));
+        REQUIRE(cask::write_pack(directory.project(), directory.pack()));
+        auto bytes = read_file(directory.pack());
+        auto header = header_of(bytes);
+        std::string corrupt = directory.path + "/corrupt.pack";
+        cask::PackArchive archive;
+
+        WHEN("the file is truncated inside the table of contents") {
+            bytes.resize(header.toc_offset + sizeof(cask::PackEntry));
+            write_file(corrupt, bytes);
+
+            THEN("it does not open") {
+                REQUIRE_FALSE(archive.open(corrupt));
+            }
+        }
+
+        WHEN("an entry's data runs past the end of the file") {
+            auto* entry = reinterpret_cast<cask::PackEntry*>(bytes.data() + header.toc_offset);
+            entry->size = UINT64_MAX - entry->offset + 1;
+            write_file(corrupt, bytes);
+
+            THEN("it does not open") {
+                REQUIRE_FALSE(archive.open(corrupt));
+            }
+        }
+
+        WHEN("an entry's name runs past the name table") {
+            auto* entry = reinterpret_cast<cask::PackEntry*>(bytes.data() + header.toc_offset);
+            entry->name_offset = UINT32_MAX;
+            write_file(corrupt, bytes);
+
+            THEN("it does not open") {
+                REQUIRE_FALSE(archive.open(corrupt));
+            }
+        }
+
+        WHEN("the entry count would overflow the table bounds") {
+            header.entry_count = UINT32_MAX;
+            header.toc_offset = UINT64_MAX - 8;
+            std::memcpy(bytes.data(), &header, sizeof(header));
+            write_file(corrupt, bytes);
+
+            THEN("it does not open") {
+                REQUIRE_FALSE(archive.open(corrupt));
+            }
+        }
+
+        WHEN("the table of contents is misaligned") {
+            header.toc_offset += 1;
+            std::memcpy(bytes.data(), &header, sizeof(header));
+            write_file(corrupt, bytes);
+
+            THEN("it does not open") {
+                REQUIRE_FALSE(archive.open(corrupt));
+            }
+        }
+
+        WHEN("the table of contents is not sorted by hash") {
+            auto* entries = reinterpret_cast<cask::PackEntry*>(bytes.data() + header.toc_offset);
+            std::swap(entries[0], entries[1]);
+            write_file(corrupt, bytes);
+
+            THEN("it does not open") {
+                REQUIRE_FALSE(archive.open(corrupt));
+            }
+        }
+    }
+}
+
+SCENARIO("asset reader prefers the pack and falls back to loose files", "[pack_archive]") {
+    GIVEN("a packed project with a loose file added afterwards") {
+        PackDirectory directory;
+        directory.write("packed.txt", "from pack");
+        REQUIRE(cask::write_pack(directory.project(), directory.pack()));
+        directory.write("packed.txt", "loose copy");
+        directory.write("loose.txt", "loose only");
+
+        cask::AssetReader reader;
+        reader.root_ = directory.project();
+        REQUIRE(reader.archive_.open(directory.pack()));
+
+        THEN("packed files are served from the archive") {
+            auto asset = reader.read("packed.txt");
+            REQUIRE(asset.from_pack);
+            REQUIRE(as_string(asset.bytes) == "from pack");
+        }
+
+        THEN("files outside the archive are read from disk") {
+            auto asset = reader.read("loose.txt");
+            REQUIRE(asset.found());
+            REQUIRE_FALSE(asset.from_pack);
+            REQUIRE(as_string(asset.bytes) == "loose only");
+        }
+
+        THEN("missing files are reported as not found") {
+            REQUIRE_FALSE(reader.read("missing.txt").found());
+            REQUIRE_FALSE(reader.exists("missing.txt"));
+        }
+    }
+}
+
+SCENARIO("reading many small assets through the pack is benchmarked", "[.][pack_archive][benchmark]") {
+    GIVEN("twenty thousand 512-byte files packed into one archive") {
+        PackDirectory directory;
+        for (int index = 0; index < 20000; ++index) {
+            directory.write("assets/" + std::to_string(index % 100) + "/" + std::to_string(index) + ".bin", std::string(512, char(index)));
+        }
+        REQUIRE(cask::write_pack(directory.project(), directory.pack()));
+        std::vector<std::string> paths;
+        for (int index = 0; index < 20000; ++index) {
+            paths.push_back("assets/" + std::to_string(index % 100) + "/" + std::to_string(index) + ".bin");
+        }
+        cask::AssetReader loose;
+        loose.root_ = directory.project();
+        cask::AssetReader packed;
+        packed.root_ = directory.project();
+        REQUIRE(packed.archive_.open(directory.pack()));
+
+        BENCHMARK("read every file loose") {
+            size_t total = 0;
+            for (auto& path : paths) {
+                total += loose.read(path).bytes.size();
+            }
+            return total;
+        };
+
+        BENCHMARK("read every file through the pack") {
+            size_t total = 0;
+            for (auto& path : paths) {
+                total += packed.read(path).bytes.size();
+            }
+            return total;
+        };
+    }
+}
+
+SCENARIO("reading many small assets after a cold start is benchmarked", "[.][pack_archive][benchmark]") {
+    GIVEN("twenty thousand 512-byte files packed into one archive, evicted from the page cache before each sample") {
+        PackDirectory directory;
+        std::vector<std::string> paths;
+        for (int index = 0; index < 20000; ++index) {
+            paths.push_back("assets/" + std::to_string(index % 100) + "/" + std::to_string(index) + ".bin");
+            directory.write(paths.back(), std::string(512, char(index)));
+        }
+        REQUIRE(cask::write_pack(directory.project(), directory.pack()));
+
+        BENCHMARK_ADVANCED("read every file loose")(Catch::Benchmark::Chronometer meter) {
+            for (auto& path : paths) {
+                evict_from_page_cache(directory.project() + "/" + path);
+            }
+            cask::AssetReader loose;
+            loose.root_ = directory.project();
+            meter.measure([&] {
+                size_t total = 0;
+                for (auto& path : paths) {
+                    total += loose.read(path).bytes.size();
+                }
+                return total;
+            });
+        };
+
+        BENCHMARK_ADVANCED("open the pack and read every file through it")(Catch::Benchmark::Chronometer meter) {
+            evict_from_page_cache(directory.pack());
+            meter.measure([&] {
+                cask::AssetReader packed;
+                packed.root_ = directory.project();
+                packed.archive_.open(directory.pack());
+                size_t total = 0;
+                for (auto& path : paths) {
+                    total += packed.read(path).bytes.size();
+                }
+                return total;
+            });
+        };
+    }
+}
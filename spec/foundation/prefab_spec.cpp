@@ -0,0 +1,211 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/prefab.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+template<typename T>
+static cask::RegistryEntry json_entry() {
+    cask::RegistryEntry entry;
+    entry.serialize = [](void* value) { return nlohmann::json(*static_cast<T*>(value)); };
+    entry.deserialize = [](const nlohmann::json& data, void* target, const nlohmann::json&) {
+        *static_cast<T*>(target) = data.get<T>();
+        return nlohmann::json{};
+    };
+    return entry;
+}
+
+SCENARIO("a prefab copies its compiled values into every instance", "[prefab]") {
+    GIVEN("a prefab with a velocity and a name") {
+        EntityTable table;
+        ComponentStore<float> velocities;
+        ComponentStore<std::string> names;
+        cask::Prefab prefab;
+        prefab.add(&velocities, 40.0f).add(&names, std::string("projectile"));
+
+        WHEN("three copies are instantiated") {
+            auto created = prefab.instantiate(table, 3);
+
+            THEN("three live entities are created") {
+                REQUIRE(created.size() == 3);
+                for (uint32_t entity : created) {
+                    REQUIRE(table.alive(entity));
+                }
+            }
+
+            THEN("every store holds the compiled value for each copy") {
+                REQUIRE(velocities.size() == 3);
+                REQUIRE(names.size() == 3);
+                for (uint32_t entity : created) {
+                    REQUIRE(velocities.get(entity) == 40.0f);
+                    REQUIRE(names.get(entity) == "projectile");
+                }
+            }
+        }
+
+        WHEN("one instance is modified") {
+            auto created = prefab.instantiate(table, 2);
+            velocities.get(created[0]) = 1.0f;
+
+            THEN("the other instance and later instances are unaffected") {
+                REQUIRE(velocities.get(created[1]) == 40.0f);
+                auto later = prefab.instantiate(table, 1);
+                REQUIRE(velocities.get(later[0]) == 40.0f);
+            }
+        }
+    }
+
+    GIVEN("a prefab that sets the same store twice") {
+        ComponentStore<int> lifetimes;
+        cask::Prefab prefab;
+        prefab.add(&lifetimes, 1).add(&lifetimes, 5);
+
+        THEN("the last value wins") {
+            EntityTable table;
+            auto created = prefab.instantiate(table, 1);
+            REQUIRE(prefab.size() == 1);
+            REQUIRE(lifetimes.get(created[0]) == 5);
+        }
+    }
+}
+
+SCENARIO("a prefab appends to an existing list of created entities", "[prefab]") {
+    GIVEN("a list that already holds an entity") {
+        EntityTable table;
+        ComponentStore<int> lifetimes;
+        cask::Prefab prefab;
+        prefab.add(&lifetimes, 3);
+        std::vector<uint32_t> created{table.create()};
+
+        WHEN("two copies are instantiated into it") {
+            prefab.instantiate(table, 2, created);
+
+            THEN("the existing entry is kept and only new entities are filled") {
+                REQUIRE(created.size() == 3);
+                REQUIRE_FALSE(lifetimes.has(created[0]));
+                REQUIRE(lifetimes.get(created[1]) == 3);
+                REQUIRE(lifetimes.get(created[2]) == 3);
+            }
+        }
+
+        WHEN("single copies are instantiated one hundred times") {
+            size_t reallocations = 0;
+            size_t capacity = lifetimes.components_.capacity();
+            for (int batch = 0; batch < 100; ++batch) {
+                prefab.instantiate(table, 1, created);
+                if (lifetimes.components_.capacity() == capacity) continue;
+                capacity = lifetimes.components_.capacity();
+                ++reallocations;
+            }
+
+            THEN("the store grows geometrically") {
+                REQUIRE(lifetimes.size() == 100);
+                REQUIRE(reallocations <= 8);
+            }
+        }
+    }
+}
+
+SCENARIO("a prefab assigns identities through an entity registry", "[prefab]") {
+    GIVEN("a prefab and a registry") {
+        EntityTable table;
+        EntityRegistry registry;
+        ComponentStore<int> lifetimes;
+        cask::Prefab prefab;
+        prefab.add(&lifetimes, 3);
+
+        WHEN("copies are instantiated with the registry") {
+            auto created = prefab.instantiate(table, 4, &registry);
+
+            THEN("each copy is a distinct entity known to the registry") {
+                std::set<uint32_t> distinct(created.begin(), created.end());
+                REQUIRE(distinct.size() == 4);
+                REQUIRE(registry.size() == 4);
+                for (uint32_t entity : created) {
+                    REQUIRE(registry.has(entity));
+                    REQUIRE(lifetimes.get(entity) == 3);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("prefabs compile serialized templates once", "[prefab]") {
+    GIVEN("prefabs with two registered stores") {
+        EntityTable table;
+        ComponentStore<float> velocities;
+        ComponentStore<int> lifetimes;
+        cask::Prefabs prefabs;
+        prefabs.add_store("Velocities", &velocities, json_entry<float>());
+        prefabs.add_store("Lifetimes", &lifetimes, json_entry<int>());
+
+        WHEN("a template naming one store and an unknown key is compiled") {
+            nlohmann::json entity;
+            entity["Lifetimes"] = 7;
+            entity["Unknown"] = 1;
+            auto& prefab = prefabs.compile("projectile", entity);
+
+            THEN("only the registered store is part of the prefab") {
+                REQUIRE(prefab.size() == 1);
+            }
+
+            THEN("the unknown key is reported") {
+                REQUIRE(prefab.unknown_keys_ == std::vector<std::string>{"Unknown"});
+            }
+
+            THEN("instantiating by name fills that store") {
+                std::vector<uint32_t> created;
+                REQUIRE(prefabs.instantiate("projectile", table, 2, created));
+                REQUIRE(created.size() == 2);
+                REQUIRE(lifetimes.get(created[0]) == 7);
+                REQUIRE(lifetimes.get(created[1]) == 7);
+                REQUIRE(velocities.size() == 0);
+            }
+
+            THEN("instantiating advances the write generation of the filled store") {
+                cask::StoreGenerations generations;
+                generations.track(&lifetimes);
+                generations.track(&velocities);
+                prefabs.generations_ = &generations;
+                std::vector<uint32_t> created;
+                prefabs.instantiate("projectile", table, 2, created);
+                REQUIRE(generations.generation(&lifetimes) == 1);
+                REQUIRE(generations.generation(&velocities) == 0);
+            }
+        }
+
+        WHEN("a template is compiled again under the same name") {
+            nlohmann::json first;
+            first["Lifetimes"] = 7;
+            nlohmann::json second;
+            second["Velocities"] = 2.5;
+            prefabs.compile("projectile", first);
+            prefabs.compile("projectile", second);
+
+            THEN("the later template replaces the earlier one") {
+                auto created = prefabs.find("projectile")->instantiate(table, 1);
+                REQUIRE(velocities.get(created[0]) == 2.5f);
+                REQUIRE_FALSE(lifetimes.has(created[0]));
+            }
+        }
+
+        WHEN("a store is registered again under the same name") {
+            prefabs.add_store("Lifetimes", &lifetimes, json_entry<int>());
+
+            THEN("it replaces the earlier registration") {
+                REQUIRE(prefabs.store_count() == 2);
+            }
+        }
+
+        WHEN("an unknown prefab is instantiated") {
+            std::vector<uint32_t> created;
+            bool instantiated = prefabs.instantiate("missing", table, 3, created);
+
+            THEN("nothing is created") {
+                REQUIRE_FALSE(instantiated);
+                REQUIRE(created.empty());
+                REQUIRE(prefabs.find("missing") == nullptr);
+            }
+        }
+    }
+}
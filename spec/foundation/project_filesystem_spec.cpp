@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/project_filesystem.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+struct ProjectDirectory {
+    std::string path;
+
+    ProjectDirectory() {
+        char directory[] = "/tmp/cask_filesystem_spec_XXXXXX";
+        path = mkdtemp(directory);
+    }
+
+    ~ProjectDirectory() {
+        std::filesystem::remove_all(path);
+    }
+
+    void write(const std::string& relative_path, const std::string& contents) {
+        std::filesystem::path file = std::filesystem::path(path) / relative_path;
+        std::filesystem::create_directories(file.parent_path());
+        std::ofstream(file, std::ios::binary) << contents;
+    }
+
+    void touch_directory(const std::string& relative_path) {
+        auto directory = std::filesystem::path(path) / relative_path;
+        auto later = std::filesystem::last_write_time(directory) + std::chrono::seconds(5);
+        std::filesystem::last_write_time(directory, later);
+    }
+};
+
+SCENARIO("project filesystem indexes every file under the root", "[project_filesystem]") {
+    GIVEN("a project tree") {
+        ProjectDirectory directory;
+        directory.write("scene.json", "{}");
+        directory.write("meshes/crate.obj", "v 0 0 0");
+        directory.write("textures/ui/button.png", "png!");
+
+        WHEN("it is indexed") {
+            cask::ProjectFilesystem filesystem;
+            filesystem.index(directory.path);
+
+            THEN("nothing is scanned until the first query") {
+                REQUIRE_FALSE(filesystem.indexed_);
+                REQUIRE(filesystem.files_.empty());
+                REQUIRE(filesystem.refresh() == 0);
+            }
+
+            THEN("files at every depth are found by relative path") {
+                REQUIRE(filesystem.size() == 3);
+                REQUIRE(filesystem.exists("scene.json"));
+                REQUIRE(filesystem.exists("meshes/crate.obj"));
+                REQUIRE(filesystem.exists("textures/ui/button.png"));
+            }
+
+            THEN("sizes are recorded") {
+                REQUIRE(filesystem.find("textures/ui/button.png")->size == 4);
+            }
+
+            THEN("directories are not reported as files") {
+                REQUIRE_FALSE(filesystem.exists("meshes"));
+            }
+
+            THEN("open returns a cached descriptor") {
+                int descriptor = filesystem.open("meshes/crate.obj");
+                REQUIRE(descriptor >= 0);
+                REQUIRE(filesystem.open("meshes/crate.obj") == descriptor);
+                REQUIRE(filesystem.open("meshes/missing.obj") == -1);
+            }
+
+            THEN("open keeps at most max_open_descriptors_ files open, closing the least recently used") {
+                filesystem.max_open_descriptors_ = 2;
+                REQUIRE(filesystem.open("scene.json") >= 0);
+                REQUIRE(filesystem.open("meshes/crate.obj") >= 0);
+                REQUIRE(filesystem.open("scene.json") >= 0);
+                REQUIRE(filesystem.open("textures/ui/button.png") >= 0);
+                REQUIRE(filesystem.open_descriptors() == 2);
+                REQUIRE(filesystem.find("meshes/crate.obj")->descriptor == -1);
+                REQUIRE(filesystem.find("scene.json")->descriptor >= 0);
+                REQUIRE(filesystem.open("meshes/crate.obj") >= 0);
+                REQUIRE(filesystem.open_descriptors() == 2);
+            }
+        }
+    }
+
+    GIVEN("a root that does not exist") {
+        cask::ProjectFilesystem filesystem;
+        filesystem.index("/nonexistent/project");
+
+        THEN("the index is empty") {
+            REQUIRE(filesystem.size() == 0);
+            REQUIRE(filesystem.refresh() == 0);
+        }
+    }
+}
+
+SCENARIO("project filesystem applies watcher events without sweeping directories", "[project_filesystem]") {
+    GIVEN("an indexed project tree") {
+        ProjectDirectory directory;
+        directory.write("meshes/crate.obj", "v 0 0 0");
+        directory.write("textures/crate.png", "png!");
+        cask::ProjectFilesystem filesystem;
+        filesystem.index(directory.path);
+        filesystem.sync();
+
+        WHEN("nothing changed") {
+            THEN("refresh rescans nothing") {
+                REQUIRE(filesystem.refresh() == 0);
+            }
+        }
+
+        WHEN("a file is added to one directory") {
+            directory.write("meshes/barrel.obj", "v 1 1 1");
+            size_t rescanned = filesystem.refresh();
+
+            THEN("the file is indexed without rescanning its directory") {
+                REQUIRE(rescanned == 0);
+                REQUIRE(filesystem.files_refreshed_ == 1);
+            }
+
+            THEN("the new file is indexed alongside the old ones") {
+                REQUIRE(filesystem.exists("meshes/barrel.obj"));
+                REQUIRE(filesystem.exists("meshes/crate.obj"));
+                REQUIRE(filesystem.exists("textures/crate.png"));
+            }
+        }
+
+        WHEN("a directory is created with a file in it") {
+            directory.write("props/box.obj", "v 2 2 2");
+            size_t rescanned = filesystem.refresh();
+
+            THEN("only the new directory is scanned") {
+                REQUIRE(rescanned == 1);
+                REQUIRE(filesystem.exists("props/box.obj"));
+                REQUIRE(filesystem.directories_.count("props") == 1);
+            }
+        }
+
+        WHEN("a directory is removed") {
+            std::filesystem::remove_all(directory.path + "/textures");
+            filesystem.refresh();
+
+            THEN("its files are dropped from the index") {
+                REQUIRE_FALSE(filesystem.exists("textures/crate.png"));
+                REQUIRE(filesystem.exists("meshes/crate.obj"));
+            }
+        }
+
+        WHEN("a file's contents change without touching its directory") {
+            auto directory_time = std::filesystem::last_write_time(directory.path + "/meshes");
+            directory.write("meshes/crate.obj", "v 0 0 0 and more");
+            std::filesystem::last_write_time(directory.path + "/meshes", directory_time);
+            size_t rescanned = filesystem.refresh();
+
+            THEN("the watcher picks the change up without a rescan") {
+                REQUIRE(rescanned == 0);
+                REQUIRE(filesystem.files_refreshed_ == 1);
+                REQUIRE(filesystem.find("meshes/crate.obj")->size == 16);
+            }
+        }
+
+        WHEN("a directory cannot be watched and refresh falls back to sweeping after its interval") {
+            filesystem.watcher_.forget("meshes");
+            filesystem.sweep_ = true;
+            auto start = cask::ProjectFilesystem::Clock::now();
+            filesystem.refresh_if_due(start);
+            directory.write("meshes/barrel.obj", "v 1 1 1");
+            directory.touch_directory("meshes");
+
+            THEN("an early call does nothing and a later one rescans") {
+                REQUIRE(filesystem.refresh_if_due(start + filesystem.refresh_interval_ / 2) == 0);
+                REQUIRE_FALSE(filesystem.files_.count("meshes/barrel.obj"));
+                REQUIRE(filesystem.refresh_if_due(start + filesystem.refresh_interval_) == 1);
+                REQUIRE(filesystem.exists("meshes/barrel.obj"));
+            }
+        }
+
+        WHEN("a single file is rewritten and refreshed") {
+            directory.write("meshes/crate.obj", "v 0 0 0 longer");
+            bool changed = filesystem.refresh_file("meshes/crate.obj");
+
+            THEN("its size is updated") {
+                REQUIRE(changed);
+                REQUIRE(filesystem.find("meshes/crate.obj")->size == 14);
+            }
+        }
+    }
+}
@@ -0,0 +1,335 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/query.hpp>
+#include <cask/foundation/amortized_compactor.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/ecs/entity_compactor.hpp>
+#include <cask/ecs/entity_events.hpp>
+#include <cask/event/event_queue.hpp>
+#include <algorithm>
+#include <atomic>
+#include <set>
+
+struct Position {
+    float x;
+};
+
+struct Velocity {
+    float dx;
+};
+
+struct Frozen {
+    bool value;
+};
+
+struct QueryFixture {
+    EntityTable table;
+    EntityCompactor compactor;
+    cask::EntityWatchers watchers;
+    cask::StoreGenerations generations;
+    EventQueue<DestroyEntity> destroy_queue;
+    ComponentStore<Position> positions;
+    ComponentStore<Velocity> velocities;
+    ComponentStore<Frozen> frozen;
+
+    QueryFixture() {
+        compactor.table_ = &table;
+        watchers.attach(compactor);
+        compactor.add(&positions, remove_component<Position>);
+        compactor.add(&velocities, remove_component<Velocity>);
+        compactor.add(&frozen, remove_component<Frozen>);
+    }
+
+    uint32_t spawn(bool moving, bool is_frozen) {
+        uint32_t entity = table.create();
+        positions.insert(entity, Position{float(entity)});
+        if (moving) velocities.insert(entity, Velocity{1.0f});
+        if (is_frozen) frozen.insert(entity, Frozen{true});
+        return entity;
+    }
+
+    void destroy(uint32_t entity) {
+        destroy_queue.emit(DestroyEntity{entity});
+        destroy_queue.swap();
+        compactor.compact(destroy_queue);
+    }
+};
+
+static std::set<uint32_t> matched(cask::Query<Position, Velocity>& query) {
+    auto& entities = query.entities();
+    return std::set<uint32_t>(entities.begin(), entities.end());
+}
+
+SCENARIO("a query joins stores and honours exclusions", "[query]") {
+    GIVEN("entities with different component sets") {
+        QueryFixture fixture;
+        uint32_t moving = fixture.spawn(true, false);
+        fixture.spawn(false, false);
+        uint32_t frozen = fixture.spawn(true, true);
+
+        WHEN("Position and Velocity are queried") {
+            cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+
+            THEN("only entities with both components match") {
+                REQUIRE(matched(query) == std::set<uint32_t>{moving, frozen});
+            }
+        }
+
+        WHEN("Frozen is excluded") {
+            cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+            query.without(&fixture.frozen);
+
+            THEN("frozen entities no longer match") {
+                REQUIRE(matched(query) == std::set<uint32_t>{moving});
+            }
+        }
+
+        WHEN("each visits the matches") {
+            cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+            query.each([](uint32_t, Position& position, Velocity& velocity) {
+                position.x += velocity.dx;
+            });
+
+            THEN("components are updated in place") {
+                REQUIRE(fixture.positions.get(moving).x == float(moving) + 1.0f);
+                REQUIRE(fixture.positions.get(frozen).x == float(frozen) + 1.0f);
+            }
+        }
+    }
+}
+
+SCENARIO("a query caches its matches until the stores change", "[query]") {
+    GIVEN("a query over a populated world") {
+        QueryFixture fixture;
+        for (int index = 0; index < 10; ++index) {
+            fixture.spawn(index % 2 == 0, false);
+        }
+        cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+        query.entities();
+
+        WHEN("it is iterated again without changes") {
+            query.each([](uint32_t, Position&, Velocity&) {});
+
+            THEN("the matches are not rebuilt") {
+                REQUIRE(query.rebuilds_ == 1);
+            }
+        }
+
+        WHEN("a new matching entity is inserted") {
+            uint32_t added = fixture.spawn(true, false);
+
+            THEN("the query rebuilds and includes it") {
+                REQUIRE(matched(query).count(added) == 1);
+                REQUIRE(query.rebuilds_ == 2);
+            }
+        }
+    }
+
+    GIVEN("a query tracking write generations") {
+        QueryFixture fixture;
+        uint32_t moving = fixture.spawn(true, false);
+        uint32_t resting = fixture.spawn(false, false);
+        cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+        query.track(fixture.generations);
+        query.entities();
+
+        WHEN("a remove and an insert leave the store size unchanged and the store is touched") {
+            fixture.velocities.remove(moving);
+            fixture.velocities.insert(resting, Velocity{1.0f});
+            fixture.generations.touch(&fixture.velocities);
+
+            THEN("the query rebuilds with the new match") {
+                REQUIRE(matched(query) == std::set<uint32_t>{resting});
+                REQUIRE(query.rebuilds_ == 2);
+            }
+        }
+
+        WHEN("an untracked store is touched") {
+            fixture.generations.touch(&fixture.frozen);
+
+            THEN("the matches are kept") {
+                query.entities();
+                REQUIRE(query.rebuilds_ == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("a watched query drops compacted entities incrementally", "[query]") {
+    GIVEN("a query watching the compactor") {
+        QueryFixture fixture;
+        uint32_t first = fixture.spawn(true, false);
+        uint32_t second = fixture.spawn(true, false);
+        uint32_t still = fixture.spawn(false, false);
+        cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+        query.watch(fixture.watchers);
+        query.entities();
+
+        WHEN("a matched entity is destroyed") {
+            fixture.destroy(first);
+
+            THEN("it is removed without a rebuild") {
+                REQUIRE(matched(query) == std::set<uint32_t>{second});
+                REQUIRE(query.rebuilds_ == 1);
+            }
+        }
+
+        WHEN("an unmatched entity is destroyed") {
+            fixture.destroy(still);
+
+            THEN("the matches are kept without a rebuild") {
+                REQUIRE(matched(query) == std::set<uint32_t>{first, second});
+                REQUIRE(query.rebuilds_ == 1);
+            }
+        }
+
+        WHEN("the query unwatches") {
+            query.unwatch();
+
+            THEN("it is removed from the watchers") {
+                REQUIRE(fixture.watchers.size() == 0);
+            }
+        }
+
+        WHEN("a matched entity is destroyed after an insert") {
+            uint32_t added = fixture.spawn(true, false);
+            fixture.destroy(first);
+
+            THEN("the insert is still picked up") {
+                REQUIRE(matched(query) == std::set<uint32_t>{second, added});
+            }
+        }
+    }
+}
+
+SCENARIO("a watched query skips entities retiring under an amortized compactor", "[query]") {
+    GIVEN("a query watching the compactor and an amortized compactor limited to one entity per compaction") {
+        QueryFixture fixture;
+        cask::AmortizedCompactor amortized;
+        amortized.entity_budget_ = 1;
+        fixture.watchers.attach(amortized);
+        uint32_t first = fixture.spawn(true, false);
+        uint32_t second = fixture.spawn(true, false);
+        uint32_t kept = fixture.spawn(true, false);
+        cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+        query.watch(fixture.watchers);
+        query.entities();
+        size_t watched = query.rebuilds_;
+
+        WHEN("both entities are destroyed and only one is compacted") {
+            fixture.destroy_queue.emit(DestroyEntity{first});
+            fixture.destroy_queue.emit(DestroyEntity{second});
+            fixture.destroy_queue.swap();
+            amortized.compact(fixture.compactor, fixture.destroy_queue);
+
+            THEN("the retiring entity is not matched although its components remain") {
+                REQUIRE(amortized.retiring(second));
+                REQUIRE(fixture.positions.has(second));
+                REQUIRE(matched(query) == std::set<uint32_t>{kept});
+            }
+
+            THEN("iteration never visits it") {
+                std::set<uint32_t> visited;
+                query.each([&](uint32_t entity, Position&, Velocity&) { visited.insert(entity); });
+                REQUIRE(visited == std::set<uint32_t>{kept});
+            }
+
+            THEN("only the retired ids leave the matches without a rebuild") {
+                REQUIRE(matched(query) == std::set<uint32_t>{kept});
+                REQUIRE(query.rebuilds_ == watched);
+            }
+
+            THEN("compacting the rest keeps the matches without another rebuild") {
+                query.entities();
+                size_t rebuilds = query.rebuilds_;
+                fixture.destroy_queue.swap();
+                amortized.compact(fixture.compactor, fixture.destroy_queue);
+                REQUIRE_FALSE(fixture.positions.has(second));
+                REQUIRE(matched(query) == std::set<uint32_t>{kept});
+                REQUIRE(query.rebuilds_ == rebuilds);
+            }
+        }
+    }
+}
+
+SCENARIO("a watched query leaves the watchers when destroyed", "[query]") {
+    GIVEN("a query watching the compactor in a nested scope") {
+        QueryFixture fixture;
+        uint32_t entity = fixture.spawn(true, false);
+        {
+            cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+            query.watch(fixture.watchers);
+            REQUIRE(fixture.watchers.size() == 1);
+        }
+
+        WHEN("an entity is compacted after the query is gone") {
+            fixture.destroy(entity);
+
+            THEN("no watcher is left to call") {
+                REQUIRE(fixture.watchers.size() == 0);
+                REQUIRE_FALSE(fixture.positions.has(entity));
+            }
+        }
+    }
+}
+
+SCENARIO("a query iterates in chunks", "[query]") {
+    GIVEN("a query with many matches") {
+        QueryFixture fixture;
+        for (int index = 0; index < 1000; ++index) {
+            fixture.spawn(true, false);
+        }
+        cask::Query<Position, Velocity> query(&fixture.positions, &fixture.velocities);
+
+        WHEN("it is split into chunks of 64") {
+            size_t chunks = 0;
+            size_t visited = 0;
+            query.each_chunk(64, [&](std::span<const uint32_t> entities) {
+                ++chunks;
+                visited += entities.size();
+            });
+
+            THEN("every match is covered once") {
+                REQUIRE(chunks == 16);
+                REQUIRE(visited == 1000);
+            }
+        }
+
+        WHEN("it is iterated in parallel") {
+            std::atomic<size_t> visited{0};
+            query.parallel_each(64, [&](uint32_t, Position& position, Velocity& velocity) {
+                position.x += velocity.dx;
+                ++visited;
+            }, 4);
+
+            THEN("every match is visited exactly once") {
+                REQUIRE(visited == 1000);
+                bool all_moved = true;
+                for (uint32_t entity : query.entities()) {
+                    all_moved = all_moved && fixture.positions.get(entity).x == float(entity) + 1.0f;
+                }
+                REQUIRE(all_moved);
+            }
+
+            THEN("a second pass reuses the query's worker threads") {
+                query.parallel_each(64, [](uint32_t, Position&, Velocity&) {}, 4);
+                REQUIRE(query.pool_->size() == 3);
+            }
+        }
+
+        WHEN("it is iterated in parallel on a caller's pool") {
+            cask::WorkerPool pool;
+            std::atomic<size_t> visited{0};
+            for (int pass = 0; pass < 3; ++pass) {
+                query.parallel_each(pool, 64, [&](uint32_t, Position&, Velocity&) { ++visited; }, 4);
+            }
+
+            THEN("every pass visits every match on the same threads") {
+                REQUIRE(visited == 3000);
+                REQUIRE(pool.size() == 3);
+                REQUIRE(query.pool_ == nullptr);
+            }
+        }
+    }
+}
@@ -0,0 +1,210 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/foundation/rollback.hpp>
+#include <cask/foundation/command_buffer.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_table.hpp>
+#include <cask/identity/entity_registry.hpp>
+#include <cask/identity/uuid.hpp>
+#include <string>
+
+SCENARIO("a rollback restores tracked stores to a saved tick", "[rollback]") {
+    GIVEN("a table and two stores saved at tick 10") {
+        EntityTable table;
+        ComponentStore<float> positions;
+        ComponentStore<std::string> names;
+        cask::Rollback rollback(4);
+        rollback.track(&table);
+        rollback.track(&positions);
+        rollback.track(&names);
+
+        uint32_t first = table.create();
+        uint32_t second = table.create();
+        positions.insert(first, 1.0f);
+        positions.insert(second, 2.0f);
+        names.insert(first, std::string("first"));
+        rollback.save(10);
+
+        WHEN("the simulation changes and tick 10 is restored") {
+            positions.get(first) = 5.0f;
+            positions.remove(second);
+            names.insert(second, std::string("second"));
+            table.destroy(second);
+            uint32_t third = table.create();
+            positions.insert(third, 3.0f);
+            REQUIRE(rollback.restore(10));
+
+            THEN("every store matches the saved tick") {
+                REQUIRE(positions.size() == 2);
+                REQUIRE(positions.get(first) == 1.0f);
+                REQUIRE(positions.get(second) == 2.0f);
+                REQUIRE(positions.entities_ == std::vector<uint32_t>{first, second});
+                REQUIRE(names.size() == 1);
+                REQUIRE(names.get(first) == "first");
+                REQUIRE_FALSE(names.has(second));
+            }
+
+            THEN("the entity table matches the saved tick") {
+                REQUIRE(table.alive(first));
+                REQUIRE(table.alive(second));
+            }
+        }
+
+        WHEN("tick 10 is restored with store generations attached") {
+            cask::StoreGenerations generations;
+            generations.track(&positions);
+            rollback.generations_ = &generations;
+            REQUIRE(rollback.restore(10));
+
+            THEN("every restored store advances its write generation") {
+                REQUIRE(generations.generation(&positions) == 1);
+            }
+        }
+
+        WHEN("a later tick is saved and then tick 10 is restored") {
+            positions.get(first) = 7.0f;
+            rollback.save(11);
+            REQUIRE(rollback.restore(10));
+
+            THEN("snapshots newer than the restored tick are dropped") {
+                REQUIRE(rollback.has(10));
+                REQUIRE_FALSE(rollback.has(11));
+                REQUIRE(rollback.newest() == 10);
+            }
+        }
+    }
+}
+
+SCENARIO("a rollback keeps only the last capacity ticks", "[rollback]") {
+    GIVEN("a rollback of capacity 3 saved for ticks 1 through 5") {
+        ComponentStore<int> counters;
+        cask::Rollback rollback(3);
+        rollback.track(&counters);
+        for (uint64_t tick = 1; tick <= 5; ++tick) {
+            counters.insert(0, int(tick));
+            rollback.save(tick);
+        }
+
+        THEN("only ticks 3 to 5 are available") {
+            REQUIRE_FALSE(rollback.has(2));
+            REQUIRE_FALSE(rollback.restore(2));
+            REQUIRE(rollback.oldest() == 3);
+            REQUIRE(rollback.newest() == 5);
+        }
+
+        THEN("an older tick in the window restores its values") {
+            REQUIRE(rollback.restore(3));
+            REQUIRE(counters.get(0) == 3);
+        }
+    }
+}
+
+SCENARIO("a rollback restores entity identities", "[rollback]") {
+    GIVEN("a registry saved with one identity") {
+        EntityTable table;
+        EntityRegistry registry;
+        cask::Rollback rollback(2);
+        rollback.track(&table);
+        rollback.track(&registry);
+        uint32_t saved = registry.resolve(cask::generate_uuid(), table);
+        rollback.save(0);
+
+        WHEN("another identity is added and tick 0 is restored") {
+            uint32_t added = registry.resolve(cask::generate_uuid(), table);
+            rollback.restore(0);
+
+            THEN("only the saved identity remains") {
+                REQUIRE(registry.has(saved));
+                REQUIRE_FALSE(registry.has(added));
+                REQUIRE(registry.size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("tracking a new component invalidates earlier snapshots", "[rollback]") {
+    GIVEN("a rollback with a saved tick") {
+        ComponentStore<int> first;
+        ComponentStore<int> second;
+        cask::Rollback rollback(2);
+        rollback.track(&first);
+        rollback.save(0);
+
+        WHEN("another store is tracked") {
+            rollback.track(&second);
+
+            THEN("the earlier tick cannot be restored") {
+                REQUIRE_FALSE(rollback.has(0));
+                REQUIRE_FALSE(rollback.oldest().has_value());
+            }
+        }
+
+        WHEN("the same store is tracked again") {
+            rollback.track(&first);
+
+            THEN("the snapshot is kept") {
+                REQUIRE(rollback.tracks_.size() == 1);
+                REQUIRE(rollback.has(0));
+            }
+        }
+    }
+}
+
+SCENARIO("a rollback never has zero slots", "[rollback]") {
+    GIVEN("a rollback constructed with capacity 0") {
+        ComponentStore<int> counters;
+        cask::Rollback rollback(0);
+        rollback.track(&counters);
+
+        THEN("it keeps one slot and can save") {
+            REQUIRE(rollback.capacity() == 1);
+            rollback.save(4);
+            REQUIRE(rollback.has(4));
+        }
+
+        WHEN("it is resized to 0") {
+            bool resized = rollback.resize(0);
+
+            THEN("the resize is rejected") {
+                REQUIRE_FALSE(resized);
+                REQUIRE(rollback.capacity() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("a rollback restores pending commands and destroys", "[rollback]") {
+    GIVEN("command buffers and a destroy queue saved with pending work") {
+        EntityTable table;
+        ComponentStore<std::string> names;
+        EventQueue<DestroyEntity> destroy_queue;
+        cask::CommandBuffers commands;
+        cask::Rollback rollback(2);
+        rollback.track(&commands);
+        rollback.track(&destroy_queue);
+        auto& buffer = commands.at(0);
+        uint32_t spawned = buffer.create();
+        buffer.insert(&names, spawned, std::string("saved with a long heap allocated name"));
+        destroy_queue.emit(DestroyEntity{7});
+        rollback.save(0);
+
+        WHEN("the work is played and tick 0 is restored") {
+            commands.play(table, destroy_queue);
+            destroy_queue.swap();
+            REQUIRE(rollback.restore(0));
+            REQUIRE(commands.pending() == 2);
+            commands.play(table, destroy_queue);
+            destroy_queue.swap();
+
+            THEN("the saved commands play again") {
+                REQUIRE(names.size() == 2);
+                REQUIRE(names.components_[1] == "saved with a long heap allocated name");
+                REQUIRE(commands.commands_rejected_ == 0);
+            }
+
+            THEN("the saved destroy is delivered again") {
+                REQUIRE(destroy_queue.poll().size() == 1);
+                REQUIRE(destroy_queue.poll()[0].entity == 7);
+            }
+        }
+    }
+}
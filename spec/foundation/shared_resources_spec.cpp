@@ -0,0 +1,236 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/world/world.hpp>
+#include <cask/world/abi_internal.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/foundation/shared_resources.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SharedWorld {
+    World world;
+    WorldHandle handle;
+    cask::WorldView view;
+
+    explicit SharedWorld(cask::SharedResources* shared)
+        : handle(handle_from_world(&world))
+        , view(handle) {
+        if (!shared) return;
+        view.bind(view.register_component("SharedResources"), shared);
+    }
+
+    ResourceStore<MeshData>* store() {
+        return view.resolve<ResourceStore<MeshData>>("MeshStore");
+    }
+};
+
+static MeshData triangle() {
+    MeshData mesh;
+    mesh.vertices = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    mesh.indices = {0, 1, 2};
+    return mesh;
+}
+
+SCENARIO("shared resources load each key once", "[shared_resources]") {
+    GIVEN("a process-wide cache") {
+        cask::SharedResources shared;
+        int loads = 0;
+        auto load = [&loads] {
+            ++loads;
+            return triangle();
+        };
+
+        WHEN("the same key is loaded twice") {
+            uint32_t first = shared.load<MeshData>("meshes/triangle", load);
+            uint32_t second = shared.load<MeshData>("meshes/triangle", load);
+
+            THEN("the loader runs once and both calls return the same handle") {
+                REQUIRE(loads == 1);
+                REQUIRE(first == second);
+            }
+
+            THEN("the store only changes when the host applies staged writes") {
+                REQUIRE(shared.store<MeshData>()->resources_.empty());
+                REQUIRE(shared.apply_staged() == 1);
+                REQUIRE(shared.store<MeshData>()->resources_.size() == 1);
+                REQUIRE(shared.load<MeshData>("meshes/triangle", load) == first);
+                REQUIRE(loads == 1);
+            }
+        }
+
+        WHEN("two new keys are loaded before the host applies them") {
+            uint32_t first = shared.load<MeshData>("meshes/first", triangle);
+            uint32_t second = shared.load<MeshData>("meshes/second", triangle);
+            shared.apply_staged();
+
+            THEN("each key keeps the handle it was given") {
+                auto store = shared.store<MeshData>();
+                REQUIRE(first != second);
+                REQUIRE(store->key_to_handle_.at("meshes/first") == first);
+                REQUIRE(store->key_to_handle_.at("meshes/second") == second);
+                REQUIRE(store->resources_.size() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("worlds view shared resource stores", "[shared_resources]") {
+    GIVEN("a cache holding one mesh and two worlds bound to it") {
+        cask::SharedResources shared;
+        uint32_t handle = shared.load<MeshData>("meshes/triangle", triangle);
+        shared.apply_staged();
+        SharedWorld first(&shared);
+        SharedWorld second(&shared);
+        auto* first_store = cask::register_shared_resource_store<MeshData>(first.view, "MeshStoreView");
+        auto* second_store = cask::register_shared_resource_store<MeshData>(second.view, "MeshStoreView");
+
+        THEN("both worlds resolve the cache's store without copying it") {
+            REQUIRE(first_store == second_store);
+            REQUIRE(first.store() == first_store);
+            REQUIRE(second.store()->resources_[handle].indices.size() == 3);
+            REQUIRE(shared.viewers<MeshData>() == 2);
+        }
+
+        WHEN("one world overrides a resource") {
+            MeshData quad = triangle();
+            quad.indices = {0, 1, 2, 2, 1, 3};
+            uint32_t overridden = cask::override_resource<MeshData>(first.view, "MeshStoreView", "meshes/triangle", quad);
+
+            THEN("only that world sees the override") {
+                REQUIRE(overridden == handle);
+                REQUIRE(first.store() != second.store());
+                REQUIRE(first.store()->resources_[handle].indices.size() == 6);
+                REQUIRE(second.store()->resources_[handle].indices.size() == 3);
+                REQUIRE(shared.store<MeshData>()->resources_[handle].indices.size() == 3);
+            }
+
+            THEN("the overriding world has detached from the cache") {
+                REQUIRE(first.view.resolve<cask::SharedResourceView<MeshData>>("MeshStoreView")->detached());
+                REQUIRE_FALSE(second.view.resolve<cask::SharedResourceView<MeshData>>("MeshStoreView")->detached());
+            }
+        }
+
+        WHEN("one world adds a resource of its own") {
+            uint32_t added = cask::override_resource<MeshData>(second.view, "MeshStoreView", "meshes/local", triangle());
+
+            THEN("it is appended to that world's copy only") {
+                REQUIRE(added == 1);
+                REQUIRE(second.store()->key_to_handle_.count("meshes/local") == 1);
+                REQUIRE(first.store()->key_to_handle_.count("meshes/local") == 0);
+            }
+        }
+    }
+
+    GIVEN("a world without SharedResources") {
+        SharedWorld world(nullptr);
+
+        WHEN("its resource store is registered") {
+            auto* store = cask::register_shared_resource_store<MeshData>(world.view, "MeshStoreView");
+
+            THEN("the world gets a store of its own") {
+                REQUIRE(store != nullptr);
+                REQUIRE(world.store() == store);
+            }
+
+            THEN("overrides write to that store directly") {
+                cask::override_resource<MeshData>(world.view, "MeshStoreView", "meshes/triangle", triangle());
+                REQUIRE(world.store() == store);
+                REQUIRE(store->resources_.size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("world writers reach shared stores only through the cache", "[shared_resources]") {
+    GIVEN("a cache holding one mesh and two worlds viewing it") {
+        cask::SharedResources shared;
+        uint32_t handle = shared.load<MeshData>("meshes/triangle", triangle);
+        shared.apply_staged();
+        SharedWorld first(&shared);
+        SharedWorld second(&shared);
+        cask::register_shared_resource_store<MeshData>(first.view, "MeshStoreView");
+        cask::register_shared_resource_store<MeshData>(second.view, "MeshStoreView");
+
+        WHEN("a world loads a key through load_resource") {
+            int loads = 0;
+            auto load = [&loads] {
+                ++loads;
+                return triangle();
+            };
+            uint32_t loaded = cask::load_resource<MeshData>(first.view, "MeshStoreView", "meshes/other", load);
+            uint32_t again = cask::load_resource<MeshData>(second.view, "MeshStoreView", "meshes/other", load);
+
+            THEN("the cache loads it once for both worlds") {
+                REQUIRE(loads == 1);
+                REQUIRE(loaded == again);
+                REQUIRE(second.store()->resources_.size() == 1);
+                REQUIRE(shared.apply_staged() == 1);
+                REQUIRE(second.store()->resources_.size() == 2);
+            }
+        }
+
+        WHEN("a world replaces a shared resource") {
+            MeshData quad = triangle();
+            quad.indices = {0, 1, 2, 2, 1, 3};
+            REQUIRE(cask::replace_resource<MeshData>(first.view, "MeshStoreView", "meshes/triangle", quad));
+
+            THEN("the write is staged until the host applies it") {
+                REQUIRE(shared.staged() == 1);
+                REQUIRE(second.store()->resources_[handle].indices.size() == 3);
+                REQUIRE(shared.apply_staged() == 1);
+                REQUIRE(second.store()->resources_[handle].indices.size() == 6);
+            }
+        }
+
+        WHEN("a detached world replaces a resource") {
+            cask::detach_resource_store<MeshData>(first.view, "MeshStoreView");
+            MeshData quad = triangle();
+            quad.indices = {0, 1, 2, 2, 1, 3};
+            cask::replace_resource<MeshData>(first.view, "MeshStoreView", "meshes/triangle", quad);
+
+            THEN("only its own copy changes") {
+                REQUIRE(shared.staged() == 0);
+                REQUIRE(first.store()->resources_[handle].indices.size() == 6);
+                REQUIRE(second.store()->resources_[handle].indices.size() == 3);
+            }
+        }
+    }
+}
+
+SCENARIO("deserialized resources reach shared stores through the cache", "[shared_resources]") {
+    GIVEN("a cache holding one applied mesh and one pending load") {
+        cask::SharedResources shared;
+        shared.load<MeshData>("meshes/triangle", triangle);
+        shared.apply_staged();
+        uint32_t pending = shared.load<MeshData>("meshes/pending", triangle);
+        ResourceStore<MeshData> draft;
+
+        WHEN("a deserializer fills a draft with one known and one new key") {
+            uint32_t added = 0;
+            shared.merge<MeshData>(draft, [&] {
+                MeshData quad = triangle();
+                quad.indices = {0, 1, 2, 2, 1, 3};
+                draft.resources_[draft.key_to_handle_.at("meshes/triangle")] = quad;
+                added = uint32_t(draft.resources_.size());
+                draft.key_to_handle_["meshes/new"] = added;
+                draft.resources_.push_back(triangle());
+                return std::vector<std::string>{"meshes/triangle", "meshes/new"};
+            });
+
+            THEN("handles continue after pending loads and nothing is written until applied") {
+                REQUIRE(added == pending + 1);
+                REQUIRE(shared.store<MeshData>()->resources_.size() == 1);
+                REQUIRE(draft.resources_.empty());
+            }
+
+            THEN("applying publishes every write at its handle") {
+                shared.apply_staged();
+                auto store = shared.store<MeshData>();
+                REQUIRE(store->resources_.size() == 3);
+                REQUIRE(store->resources_[0].indices.size() == 6);
+                REQUIRE(store->key_to_handle_.at("meshes/pending") == pending);
+                REQUIRE(store->key_to_handle_.at("meshes/new") == added);
+            }
+        }
+    }
+}
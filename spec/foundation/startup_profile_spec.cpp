@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/world/world.hpp>
+#include <cask/world/abi_internal.hpp>
+#include <cask/foundation/startup_profile.hpp>
+
+struct FakePlugin {
+    std::vector<const char*> defines;
+    std::vector<const char*> requires_;
+    PluginInfo info;
+
+    FakePlugin(const char* name, std::vector<const char*> defined, std::vector<const char*> required)
+        : defines(std::move(defined))
+        , requires_(std::move(required)) {
+        info = PluginInfo{name, defines.data(), requires_.data(), defines.size(), requires_.size(),
+                          nullptr, nullptr, nullptr, nullptr};
+    }
+};
+
+SCENARIO("scoped init profile records into a bound StartupProfile", "[startup_profile]") {
+    GIVEN("a world with a StartupProfile") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        cask::StartupProfile profile;
+        uint32_t profile_id = world.register_component("StartupProfile");
+        world.bind(profile_id, &profile);
+
+        WHEN("an init scope closes") {
+            {
+                cask::ScopedInitProfile scope(handle, "event");
+            }
+
+            THEN("a sample is recorded for the plugin") {
+                REQUIRE(profile.samples_.size() == 1);
+                REQUIRE(profile.find("event") != nullptr);
+                REQUIRE(profile.find("event")->milliseconds >= 0.0);
+            }
+        }
+    }
+
+    GIVEN("a world without a StartupProfile") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+
+        THEN("the scope is inert") {
+            cask::ScopedInitProfile scope(handle, "event");
+            REQUIRE(scope.profile_ == nullptr);
+        }
+    }
+}
+
+SCENARIO("startup report finds the critical path through the dependency graph", "[startup_profile]") {
+    GIVEN("foundation-shaped plugins with recorded init times") {
+        FakePlugin event("event", {"EventSwapper"}, {});
+        FakePlugin interpolation("interpolation", {"FrameAdvancer"}, {});
+        FakePlugin entity("entity", {"EntityTable", "DestroyEntityQueue"}, {"EventSwapper"});
+        FakePlugin identity("identity", {"EntityRegistry"}, {"EntityTable", "DestroyEntityQueue", "EventSwapper"});
+        FakePlugin serialization("serialization", {"SerializationRegistry"}, {"EntityTable", "EntityRegistry"});
+        PluginInfo* plugins[] = {&event.info, &interpolation.info, &entity.info, &identity.info, &serialization.info};
+
+        cask::StartupProfile profile;
+        profile.record("event", 1.0, 100);
+        profile.record("interpolation", 20.0, 10);
+        profile.record("entity", 2.0, 0);
+        profile.record("identity", 3.0, 0);
+        profile.record("serialization", 4.0, 0);
+
+        WHEN("the report is built") {
+            auto report = cask::build_startup_report(profile, plugins, 5);
+
+            THEN("totals sum every init") {
+                REQUIRE(report.total_milliseconds == 30.0);
+                REQUIRE(report.total_heap_bytes == 110);
+            }
+
+            THEN("the critical path is the slowest dependency chain") {
+                REQUIRE(report.critical_path == std::vector<std::string>{"interpolation"});
+                REQUIRE(report.critical_path_milliseconds == 20.0);
+            }
+
+            THEN("plugins are grouped into waves that could initialize concurrently") {
+                REQUIRE(report.waves.size() == 4);
+                REQUIRE(report.waves[0] == std::vector<std::string>{"event", "interpolation"});
+                REQUIRE(report.waves[1] == std::vector<std::string>{"entity"});
+                REQUIRE(report.waves[2] == std::vector<std::string>{"identity"});
+                REQUIRE(report.waves[3] == std::vector<std::string>{"serialization"});
+            }
+
+            THEN("the description lists the critical path") {
+                auto text = cask::describe_startup_report(report);
+                REQUIRE(text.find("critical path: interpolation") != std::string::npos);
+            }
+        }
+
+        WHEN("the independent plugin is fast") {
+            profile.samples_[1].milliseconds = 0.5;
+            auto report = cask::build_startup_report(profile, plugins, 5);
+
+            THEN("the critical path follows the dependency chain") {
+                REQUIRE(report.critical_path == std::vector<std::string>{"event", "entity", "identity", "serialization"});
+                REQUIRE(report.critical_path_milliseconds == 10.0);
+            }
+        }
+    }
+}
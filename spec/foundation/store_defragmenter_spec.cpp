@@ -0,0 +1,274 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/ecs/component_store.hpp>
+#include <cask/foundation/store_defragmenter.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+static std::vector<uint32_t> scrambled(uint32_t count) {
+    std::vector<uint32_t> entities;
+    for (uint32_t entity = 0; entity < count; ++entity) {
+        entities.push_back((entity * 7919u) % count);
+    }
+    return entities;
+}
+
+static bool ascending(const ComponentStore<uint32_t>& store) {
+    return std::is_sorted(store.entities_.begin(), store.entities_.end());
+}
+
+static bool intact(ComponentStore<uint32_t>& store, uint32_t count) {
+    if (store.size() != count) return false;
+    for (uint32_t entity = 0; entity < count; ++entity) {
+        if (!store.has(entity) || store.get(entity) != entity * 10) return false;
+    }
+    return true;
+}
+
+SCENARIO("a store defragmenter sorts a store into entity order", "[store_defragmenter]") {
+    GIVEN("a store filled in scrambled entity order") {
+        ComponentStore<uint32_t> values;
+        for (uint32_t entity : scrambled(1000)) {
+            values.insert(entity, entity * 10);
+        }
+        cask::StoreDefragmenter defragmenter;
+        defragmenter.add(&values);
+
+        WHEN("it steps without a budget limit") {
+            bool remaining = defragmenter.step(std::chrono::seconds(10));
+
+            THEN("the dense arrays are in ascending entity order") {
+                REQUIRE_FALSE(remaining);
+                REQUIRE(ascending(values));
+                REQUIRE(intact(values, 1000));
+                REQUIRE(defragmenter.settled());
+                REQUIRE(defragmenter.passes_ == 1);
+            }
+
+            THEN("another step does no work") {
+                size_t moves = defragmenter.moves_;
+                REQUIRE_FALSE(defragmenter.step());
+                REQUIRE(defragmenter.moves_ == moves);
+            }
+        }
+
+        WHEN("it steps with a zero budget") {
+            size_t steps = 0;
+            while (defragmenter.step(std::chrono::nanoseconds(0))) {
+                ++steps;
+                REQUIRE(intact(values, 1000));
+            }
+
+            THEN("the work is spread across several steps") {
+                REQUIRE(steps > 1);
+                REQUIRE(ascending(values));
+                REQUIRE(intact(values, 1000));
+            }
+        }
+
+        WHEN("the store changes size in the middle of a pass") {
+            defragmenter.step(std::chrono::nanoseconds(0));
+            values.remove(500);
+            values.insert(1000, 10000);
+            values.insert(500, 5000);
+            while (defragmenter.step(std::chrono::nanoseconds(0))) {}
+
+            THEN("the pass restarts and the final order covers the new entities") {
+                REQUIRE(ascending(values));
+                REQUIRE(values.size() == 1001);
+                REQUIRE(values.get(1000) == 10000);
+                REQUIRE(values.get(500) == 5000);
+            }
+        }
+    }
+
+    GIVEN("a large scrambled store") {
+        ComponentStore<uint32_t> values;
+        for (uint32_t entity : scrambled(20000)) {
+            values.insert(entity, entity * 10);
+        }
+        cask::StoreDefragmenter defragmenter;
+        defragmenter.add(&values);
+
+        WHEN("it steps with a zero budget") {
+            size_t steps = 0;
+            while (defragmenter.step(std::chrono::nanoseconds(0)) && defragmenter.moves_ == 0) {
+                ++steps;
+            }
+
+            THEN("ordering the store is spread across several steps before anything moves") {
+                REQUIRE(steps > 1);
+                while (defragmenter.step(std::chrono::nanoseconds(0))) {}
+                REQUIRE(ascending(values));
+                REQUIRE(intact(values, 20000));
+            }
+        }
+    }
+
+    GIVEN("a sorted store") {
+        ComponentStore<uint32_t> values;
+        for (uint32_t entity = 0; entity < 1000; ++entity) {
+            values.insert(entity, entity * 10);
+        }
+        cask::StoreDefragmenter defragmenter;
+        defragmenter.add(&values);
+        defragmenter.step(std::chrono::seconds(10));
+
+        WHEN("an entity near the end is removed and a new one inserted") {
+            values.remove(990);
+            values.insert(2000, 20000);
+            defragmenter.step(std::chrono::seconds(10));
+
+            THEN("only the disturbed tail is moved") {
+                REQUIRE(ascending(values));
+                REQUIRE(defragmenter.moves_ <= 30);
+            }
+        }
+
+        WHEN("an entity is removed and reinserted so the size is unchanged") {
+            values.remove(10);
+            values.insert(10, 100);
+
+            THEN("the store is no longer settled and is sorted again") {
+                REQUIRE_FALSE(defragmenter.settled());
+                defragmenter.step(std::chrono::seconds(10));
+                REQUIRE(defragmenter.settled());
+                REQUIRE(ascending(values));
+                REQUIRE(intact(values, 1000));
+            }
+        }
+
+        WHEN("a tracked write generation advances") {
+            cask::StoreGenerations generations;
+            cask::StoreDefragmenter watched;
+            watched.generations_ = &generations;
+            watched.add(&values);
+            watched.step(std::chrono::seconds(10));
+            generations.touch(&values);
+
+            THEN("the store is checked again") {
+                REQUIRE_FALSE(watched.settled());
+                watched.step(std::chrono::seconds(10));
+                REQUIRE(watched.settled());
+                REQUIRE(watched.moves_ == 0);
+            }
+        }
+    }
+
+    GIVEN("an empty store") {
+        ComponentStore<uint32_t> values;
+        cask::StoreDefragmenter defragmenter;
+        defragmenter.add(&values);
+
+        THEN("stepping settles immediately") {
+            REQUIRE_FALSE(defragmenter.step());
+            REQUIRE(defragmenter.settled());
+        }
+    }
+}
+
+SCENARIO("a store defragmenter co-sorts stores into a shared order", "[store_defragmenter]") {
+    GIVEN("two stores holding the same entities in different orders") {
+        ComponentStore<uint32_t> values;
+        ComponentStore<float> weights;
+        auto order = scrambled(256);
+        for (uint32_t entity : order) {
+            values.insert(entity, entity * 10);
+        }
+        std::reverse(order.begin(), order.end());
+        for (uint32_t entity : order) {
+            weights.insert(entity, float(entity));
+        }
+        cask::StoreDefragmenter defragmenter;
+        defragmenter.add(&values);
+        defragmenter.add(&weights);
+
+        WHEN("both are defragmented") {
+            defragmenter.step(std::chrono::seconds(10));
+
+            THEN("index i refers to the same entity in both stores") {
+                REQUIRE(values.entities_ == weights.entities_);
+                for (size_t index = 0; index < weights.size(); ++index) {
+                    REQUIRE(weights.components_[index] == float(weights.entities_[index]));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("a store defragmenter sorts a store by key", "[store_defragmenter]") {
+    GIVEN("a store defragmented by descending component value") {
+        ComponentStore<uint32_t> values;
+        for (uint32_t entity : scrambled(300)) {
+            values.insert(entity, entity * 10);
+        }
+        cask::StoreDefragmenter defragmenter;
+        defragmenter.add(&values, [](uint32_t value) { return -int64_t(value); });
+
+        WHEN("it steps to completion") {
+            defragmenter.step(std::chrono::seconds(10));
+
+            THEN("components are ordered by the key") {
+                REQUIRE(std::is_sorted(values.components_.rbegin(), values.components_.rend()));
+                REQUIRE(intact(values, 300));
+            }
+
+            THEN("changing the values and invalidating re-sorts the store") {
+                values.get(0) = 100000;
+                defragmenter.invalidate(&values);
+                REQUIRE_FALSE(defragmenter.settled());
+                defragmenter.step(std::chrono::seconds(10));
+                REQUIRE(values.entities_.front() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("a store defragmenter swaps positions in place", "[store_defragmenter]") {
+    GIVEN("a scrambled store whose write generation is tracked") {
+        ComponentStore<uint32_t> values;
+        for (uint32_t entity : scrambled(512)) {
+            values.insert(entity, entity * 10);
+        }
+        cask::StoreGenerations generations;
+        cask::StoreDefragmenter defragmenter;
+        defragmenter.generations_ = &generations;
+        defragmenter.add(&values);
+
+        WHEN("it is defragmented") {
+            defragmenter.step(std::chrono::seconds(10));
+
+            THEN("the store is sorted without advancing its write generation") {
+                REQUIRE(ascending(values));
+                REQUIRE(intact(values, 512));
+                REQUIRE(generations.generation(&values) == 0);
+                REQUIRE(defragmenter.settled());
+            }
+
+            THEN("each misplaced entity costs at most one swap") {
+                REQUIRE(defragmenter.moves_ < 512);
+            }
+        }
+
+        WHEN("the store is added again with a key") {
+            defragmenter.add(&values, [](uint32_t value) { return ~value; });
+            defragmenter.step(std::chrono::seconds(10));
+
+            THEN("the later registration replaces the earlier one") {
+                REQUIRE(defragmenter.stores_.size() == 1);
+                REQUIRE(std::is_sorted(values.entities_.rbegin(), values.entities_.rend()));
+            }
+        }
+
+        WHEN("the store is removed") {
+            defragmenter.remove(&values);
+
+            THEN("it is no longer touched") {
+                REQUIRE_FALSE(defragmenter.tracks(&values));
+                REQUIRE_FALSE(defragmenter.step(std::chrono::seconds(10)));
+                REQUIRE_FALSE(ascending(values));
+            }
+        }
+    }
+}
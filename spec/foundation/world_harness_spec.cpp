@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cask/world.hpp>
+#include <cask/foundation/world_harness.hpp>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+struct HarnessCounter {
+    size_t ticks = 0;
+    size_t frames = 0;
+    bool frame_before_tick = false;
+    std::set<std::thread::id> threads;
+    std::atomic<int> concurrent{0};
+    bool overlapped = false;
+};
+
+static std::atomic<size_t> harness_shutdowns{0};
+
+static void counter_init(WorldHandle handle) {
+    cask::WorldView world(handle);
+    world.register_component<HarnessCounter>("HarnessCounter");
+}
+
+static void counter_tick(WorldHandle handle) {
+    auto* counter = static_cast<HarnessCounter*>(world_resolve_component(handle, "HarnessCounter"));
+    if (counter->concurrent.fetch_add(1) != 0) counter->overlapped = true;
+    ++counter->ticks;
+    counter->threads.insert(std::this_thread::get_id());
+    counter->concurrent.fetch_sub(1);
+}
+
+static void counter_frame(WorldHandle handle, float, float) {
+    auto* counter = static_cast<HarnessCounter*>(world_resolve_component(handle, "HarnessCounter"));
+    if (++counter->frames != counter->ticks) counter->frame_before_tick = true;
+}
+
+static void counter_shutdown(WorldHandle) {
+    ++harness_shutdowns;
+}
+
+static const char* counter_components[] = {"HarnessCounter"};
+
+static PluginInfo counter_plugin = {
+    "counter",
+    counter_components,
+    nullptr,
+    1,
+    0,
+    counter_init,
+    counter_tick,
+    counter_frame,
+    counter_shutdown
+};
+
+static HarnessCounter* counter_of(cask::HostedWorld& hosted) {
+    return static_cast<HarnessCounter*>(hosted.world.resolve("HarnessCounter"));
+}
+
+SCENARIO("a world harness steps every world once per tick", "[world_harness]") {
+    GIVEN("a harness with eight worlds") {
+        cask::WorldHarness harness({&counter_plugin});
+        std::vector<size_t> setup_order;
+        harness.spawn(8, [&setup_order](cask::HostedWorld&, size_t index) { setup_order.push_back(index); });
+
+        THEN("each world was set up and initialized") {
+            REQUIRE(harness.size() == 8);
+            REQUIRE(setup_order == std::vector<size_t>{0, 1, 2, 3, 4, 5, 6, 7});
+            for (auto& hosted : harness.worlds_) {
+                REQUIRE(counter_of(*hosted) != nullptr);
+            }
+        }
+
+        WHEN("it steps ten ticks on three threads") {
+            auto report = harness.step(10, 3);
+
+            THEN("every world ticked ten times without overlapping itself") {
+                for (auto& hosted : harness.worlds_) {
+                    REQUIRE(counter_of(*hosted)->ticks == 10);
+                    REQUIRE_FALSE(counter_of(*hosted)->overlapped);
+                }
+            }
+
+            THEN("each world stayed on one thread") {
+                for (auto& hosted : harness.worlds_) {
+                    REQUIRE(counter_of(*hosted)->threads.size() == 1);
+                }
+            }
+
+            THEN("every world ran its frame stage after each tick") {
+                for (auto& hosted : harness.worlds_) {
+                    REQUIRE(counter_of(*hosted)->frames == 10);
+                    REQUIRE_FALSE(counter_of(*hosted)->frame_before_tick);
+                }
+            }
+
+            THEN("stepping again reuses the same threads") {
+                harness.step(10, 3);
+                REQUIRE(harness.pool_.size() == 2);
+                for (auto& hosted : harness.worlds_) {
+                    REQUIRE(counter_of(*hosted)->ticks == 20);
+                    REQUIRE(counter_of(*hosted)->threads.size() == 1);
+                }
+            }
+
+            THEN("the report covers every world tick") {
+                REQUIRE(report.worlds == 8);
+                REQUIRE(report.threads == 3);
+                REQUIRE(report.ticks == 10);
+                REQUIRE(report.world_ticks_per_second > 0.0);
+                REQUIRE(report.p50_us <= report.p99_us);
+                REQUIRE(report.p99_us <= report.p999_us);
+                REQUIRE(report.p999_us <= report.max_us);
+            }
+        }
+
+        WHEN("a between-ticks hook is set") {
+            size_t calls = 0;
+            bool worlds_in_step = true;
+            harness.between_ticks_ = [&] {
+                ++calls;
+                size_t ticked = counter_of(*harness.worlds_[0])->ticks;
+                for (auto& hosted : harness.worlds_) {
+                    if (counter_of(*hosted)->ticks != ticked) worlds_in_step = false;
+                }
+            };
+            harness.step(5, 3);
+
+            THEN("it runs once per tick after every world has ticked") {
+                REQUIRE(calls == 5);
+                REQUIRE(worlds_in_step);
+            }
+        }
+
+        WHEN("more threads than worlds are requested") {
+            auto report = harness.step(1, 64);
+
+            THEN("the pool is capped at the world count") {
+                REQUIRE(report.threads == 8);
+            }
+        }
+
+        WHEN("it measures scaling up to four threads") {
+            auto reports = harness.scaling(2, 4);
+
+            THEN("it runs with one, two and four threads") {
+                REQUIRE(reports.size() == 3);
+                REQUIRE(reports[0].threads == 1);
+                REQUIRE(reports[1].threads == 2);
+                REQUIRE(reports[2].threads == 4);
+            }
+        }
+    }
+}
+
+SCENARIO("a world harness shuts its worlds down", "[world_harness]") {
+    GIVEN("a harness with three worlds") {
+        harness_shutdowns = 0;
+        {
+            cask::WorldHarness harness({&counter_plugin});
+            harness.spawn(3);
+
+            WHEN("it is shut down") {
+                harness.shutdown();
+
+                THEN("each world's plugins are shut down and the worlds are released") {
+                    REQUIRE(harness_shutdowns == 3);
+                    REQUIRE(harness.size() == 0);
+                }
+            }
+        }
+
+        THEN("destroying the harness shuts down any remaining worlds") {
+            REQUIRE(harness_shutdowns == 3);
+        }
+    }
+}
+
+SCENARIO("percentiles are read from sorted samples", "[world_harness]") {
+    GIVEN("one hundred and one ordered samples") {
+        std::vector<double> samples;
+        for (int value = 0; value <= 100; ++value) {
+            samples.push_back(double(value));
+        }
+
+        THEN("percentiles index into the sorted range") {
+            REQUIRE(cask::percentile(samples, 0.5) == 50.0);
+            REQUIRE(cask::percentile(samples, 0.99) == 99.0);
+            REQUIRE(cask::percentile(samples, 1.0) == 100.0);
+            REQUIRE(cask::percentile({}, 0.5) == 0.0);
+        }
+    }
+}
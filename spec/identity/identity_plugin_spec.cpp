@@ -5,6 +5,7 @@
 #include <cask/ecs/entity_events.hpp>
 #include <cask/event/event_swapper.hpp>
 #include <cask/event/event_queue.hpp>
+#include <cask/foundation/rollback.hpp>
 #include <cstring>
 
 struct IdentityTestContext : PluginTestContext {
@@ -36,11 +37,12 @@ SCENARIO("identity plugin reports its metadata", "[identity]") {
             REQUIRE(std::strcmp(info->name, "identity") == 0);
         }
 
-        THEN("it defines EntityRegistry and IdentityPluginState") {
-            REQUIRE(info->defines_count == 2);
+        THEN("it defines EntityRegistry Prefabs and IdentityPluginState") {
+            REQUIRE(info->defines_count == 3);
             REQUIRE(info->defines_components != nullptr);
             REQUIRE(std::strcmp(info->defines_components[0], "EntityRegistry") == 0);
-            REQUIRE(std::strcmp(info->defines_components[1], "IdentityPluginState") == 0);
+            REQUIRE(std::strcmp(info->defines_components[1], "Prefabs") == 0);
+            REQUIRE(std::strcmp(info->defines_components[2], "IdentityPluginState") == 0);
         }
 
         THEN("it requires EntityTable DestroyEntityQueue and EventSwapper") {
@@ -56,8 +58,8 @@ SCENARIO("identity plugin reports its metadata", "[identity]") {
             REQUIRE(info->tick_fn != nullptr);
         }
 
-        THEN("it does not provide a shutdown function") {
-            REQUIRE(info->shutdown_fn == nullptr);
+        THEN("it provides a shutdown function") {
+            REQUIRE(info->shutdown_fn != nullptr);
         }
 
         THEN("it does not provide a frame function") {
@@ -77,6 +79,10 @@ SCENARIO("identity plugin initializes EntityRegistry", "[identity]") {
                 REQUIRE(context.registry() != nullptr);
             }
 
+            THEN("Prefabs is registered and retrievable") {
+                REQUIRE(context.world.resolve("Prefabs") != nullptr);
+            }
+
             context.shutdown();
         }
     }
@@ -170,3 +176,26 @@ SCENARIO("identity plugin isolates state across worlds", "[identity]") {
         context1.shutdown();
     }
 }
+
+SCENARIO("identity plugin tracks its registry and destroy cursor for rollback", "[identity]") {
+    GIVEN("an initialized identity plugin and a bound Rollback") {
+        IdentityTestContext context;
+        cask::Rollback rollback;
+        uint32_t rollback_id = context.world.register_component("Rollback");
+        context.world.bind(rollback_id, &rollback);
+        context.init();
+
+        THEN("the registry and the destroy cursor are tracked") {
+            REQUIRE(rollback.tracks(context.registry()));
+            REQUIRE(rollback.tracked() == 2);
+        }
+
+        WHEN("the plugin shuts down") {
+            context.shutdown();
+
+            THEN("both are untracked") {
+                REQUIRE(rollback.tracked() == 0);
+            }
+        }
+    }
+}
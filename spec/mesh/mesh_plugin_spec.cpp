@@ -5,9 +5,25 @@
 #include <cask/ecs/component_store.hpp>
 #include <cask/event/event_queue.hpp>
 #include <cask/resource/resource_loader_registry.hpp>
+#include <cask/foundation/mesh_optimizer.hpp>
+#include <cask/foundation/shared_resources.hpp>
+#include <cask/foundation/mesh_instances.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
 #include <cstring>
 
 struct MeshTestContext : CompactableTestContext {
+    cask::EntityWatchers watchers;
+    cask::StoreGenerations generations;
+
+    MeshTestContext() {
+        watchers.attach(compactor);
+        uint32_t watchers_id = world.register_component("EntityWatchers");
+        world.bind(watchers_id, &watchers);
+        uint32_t generations_id = world.register_component("StoreGenerations");
+        world.bind(generations_id, &generations);
+    }
+
     ResourceStore<MeshData>* mesh_store() {
         uint32_t store_id = world.register_component("MeshStore");
         return world.get<ResourceStore<MeshData>>(store_id);
@@ -22,6 +38,15 @@ struct MeshTestContext : CompactableTestContext {
         uint32_t registry_id = world.register_component("MeshLoaderRegistry");
         return world.get<cask::ResourceLoaderRegistry<MeshData>>(registry_id);
     }
+
+    cask::MeshOptimizer* mesh_optimizer() {
+        uint32_t optimizer_id = world.register_component("MeshOptimizer");
+        return world.get<cask::MeshOptimizer>(optimizer_id);
+    }
+
+    cask::MeshInstances* mesh_instances() {
+        return static_cast<cask::MeshInstances*>(world.resolve("MeshInstances"));
+    }
 };
 
 SCENARIO("mesh plugin reports its metadata", "[mesh]") {
@@ -33,28 +58,33 @@ SCENARIO("mesh plugin reports its metadata", "[mesh]") {
             REQUIRE(std::strcmp(info->name, "mesh") == 0);
         }
 
-        THEN("it defines MeshStore, MeshComponents, and MeshLoaderRegistry") {
-            REQUIRE(info->defines_count == 3);
+        THEN("it defines MeshStore, MeshComponents, MeshLoaderRegistry, MeshOptimizer, MeshStoreView, and MeshInstances") {
+            REQUIRE(info->defines_count == 6);
             REQUIRE(info->defines_components != nullptr);
             REQUIRE(std::strcmp(info->defines_components[0], "MeshStore") == 0);
             REQUIRE(std::strcmp(info->defines_components[1], "MeshComponents") == 0);
             REQUIRE(std::strcmp(info->defines_components[2], "MeshLoaderRegistry") == 0);
+            REQUIRE(std::strcmp(info->defines_components[3], "MeshOptimizer") == 0);
+            REQUIRE(std::strcmp(info->defines_components[4], "MeshStoreView") == 0);
+            REQUIRE(std::strcmp(info->defines_components[5], "MeshInstances") == 0);
         }
 
-        THEN("it requires EntityCompactor") {
-            REQUIRE(info->requires_count == 1);
+        THEN("it requires EntityCompactor, EntityWatchers and StoreGenerations") {
+            REQUIRE(info->requires_count == 3);
             REQUIRE(info->requires_components != nullptr);
             REQUIRE(std::strcmp(info->requires_components[0], "EntityCompactor") == 0);
+            REQUIRE(std::strcmp(info->requires_components[1], "EntityWatchers") == 0);
+            REQUIRE(std::strcmp(info->requires_components[2], "StoreGenerations") == 0);
         }
 
         THEN("it provides an init function") {
             REQUIRE(info->init_fn != nullptr);
         }
 
-        THEN("it does not provide tick frame or shutdown functions") {
-            REQUIRE(info->tick_fn == nullptr);
+        THEN("it provides tick and shutdown functions but no frame function") {
+            REQUIRE(info->tick_fn != nullptr);
             REQUIRE(info->frame_fn == nullptr);
-            REQUIRE(info->shutdown_fn == nullptr);
+            REQUIRE(info->shutdown_fn != nullptr);
         }
     }
 }
@@ -97,6 +127,70 @@ SCENARIO("mesh plugin initializes MeshLoaderRegistry", "[mesh]") {
     }
 }
 
+SCENARIO("mesh plugin initializes MeshOptimizer", "[mesh]") {
+    GIVEN("a world with EntityCompactor and the mesh plugin") {
+        MeshTestContext context;
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("MeshOptimizer is registered with deduplication and reordering enabled") {
+                auto* optimizer = context.mesh_optimizer();
+                REQUIRE(optimizer != nullptr);
+                REQUIRE(optimizer->deduplicate);
+                REQUIRE(optimizer->reorder);
+            }
+
+            context.shutdown();
+        }
+    }
+}
+
+SCENARIO("mesh plugin runs the optimizer over loaded meshes", "[mesh]") {
+    GIVEN("an initialized mesh plugin and a loader producing an unindexed quad") {
+        MeshTestContext context;
+        context.init();
+        auto* loaders = context.mesh_loader_registry();
+        auto* optimizer = context.mesh_optimizer();
+        loaders->add("quad", [](const nlohmann::json&) {
+            MeshData mesh;
+            mesh.vertices = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 0};
+            mesh.indices = {0, 1, 2, 3, 4, 5};
+            return mesh;
+        });
+        nlohmann::json entry = {{"loader", "quad"}};
+
+        WHEN("the loader was registered after init and the plugin ticks") {
+            optimizer->vertex_stride = 3;
+            context.tick();
+            MeshData mesh = loaders->load(entry);
+
+            THEN("the loaded mesh comes back deduplicated") {
+                REQUIRE(mesh.vertices.size() == 12);
+                REQUIRE(mesh.indices.size() == 6);
+                REQUIRE(optimizer->meshes_optimized == 1);
+            }
+
+            THEN("later ticks do not wrap the loader twice") {
+                REQUIRE(optimizer->wrap_loaders(*loaders) == 0);
+            }
+        }
+
+        WHEN("no vertex stride is configured") {
+            context.tick();
+            MeshData mesh = loaders->load(entry);
+
+            THEN("the mesh is left as the loader produced it") {
+                REQUIRE(mesh.vertices.size() == 18);
+                REQUIRE(optimizer->meshes_optimized == 0);
+                REQUIRE(optimizer->meshes_rejected == 0);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
 SCENARIO("mesh plugin wires MeshComponents into EntityCompactor", "[mesh]") {
     GIVEN("an initialized mesh plugin") {
         MeshTestContext context;
@@ -126,6 +220,74 @@ SCENARIO("mesh plugin wires MeshComponents into EntityCompactor", "[mesh]") {
     }
 }
 
+SCENARIO("mesh plugin indexes mesh instances", "[mesh]") {
+    GIVEN("an initialized mesh plugin with entities assigned to two meshes") {
+        MeshTestContext context;
+        context.init();
+        auto* instances = context.mesh_instances();
+        uint32_t first = context.table.create();
+        uint32_t second = context.table.create();
+        uint32_t third = context.table.create();
+        instances->assign(first, MeshHandle{0});
+        instances->assign(second, MeshHandle{1});
+        instances->assign(third, MeshHandle{0});
+
+        THEN("each mesh lists its entities and MeshComponents holds their handles") {
+            REQUIRE(instances->instances(MeshHandle{0}).size() == 2);
+            REQUIRE(instances->instances(MeshHandle{1}).size() == 1);
+            REQUIRE(context.mesh_components()->get(third).id == 0);
+        }
+
+        WHEN("an entity is compacted") {
+            EventQueue<DestroyEvent> destroy_queue;
+            destroy_queue.emit(DestroyEvent{first});
+            destroy_queue.swap();
+            size_t rebuilds = instances->rebuilds_;
+            context.compactor.compact(destroy_queue);
+
+            THEN("it leaves its batch without a rebuild") {
+                auto batch = instances->instances(MeshHandle{0});
+                REQUIRE(batch.size() == 1);
+                REQUIRE(batch[0] == third);
+                REQUIRE(instances->rebuilds_ == rebuilds);
+            }
+        }
+
+        WHEN("a handle is rewritten in place and the store generation is touched") {
+            context.mesh_components()->get(second) = MeshHandle{0};
+            context.generations.touch(context.mesh_components());
+
+            THEN("the index picks up the change on the next read") {
+                REQUIRE(instances->instances(MeshHandle{0}).size() == 3);
+                REQUIRE(instances->instances(MeshHandle{1}).empty());
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("mesh plugin shutdown leaves EntityWatchers", "[mesh]") {
+    GIVEN("an initialized mesh plugin") {
+        MeshTestContext context;
+        context.init();
+        REQUIRE(context.watchers.size() == 1);
+        REQUIRE(context.generations.observers_.size() == 1);
+
+        WHEN("shutdown is called") {
+            context.shutdown();
+
+            THEN("MeshInstances no longer watches compacted entities") {
+                REQUIRE(context.watchers.size() == 0);
+            }
+
+            THEN("MeshInstances no longer observes MeshComponents writes") {
+                REQUIRE(context.generations.observers_.empty());
+            }
+        }
+    }
+}
+
 SCENARIO("mesh plugin shutdown allows reinit on fresh world", "[mesh]") {
     GIVEN("an initialized mesh plugin") {
         MeshTestContext context;
@@ -153,3 +315,42 @@ SCENARIO("mesh plugin shutdown allows reinit on fresh world", "[mesh]") {
         }
     }
 }
+
+SCENARIO("mesh plugin views a process-wide MeshStore when SharedResources is present", "[mesh]") {
+    GIVEN("two worlds bound to the same SharedResources") {
+        cask::SharedResources shared;
+        MeshTestContext first;
+        MeshTestContext second;
+        for (auto* context : {&first, &second}) {
+            uint32_t shared_id = context->world.register_component("SharedResources");
+            context->world.bind(shared_id, &shared);
+        }
+
+        WHEN("both worlds initialize the mesh plugin") {
+            first.init();
+            second.init();
+
+            THEN("they resolve the same MeshStore") {
+                REQUIRE(first.mesh_store() == second.mesh_store());
+                REQUIRE(first.mesh_store() == shared.store<MeshData>().get());
+                REQUIRE(shared.viewers<MeshData>() == 2);
+            }
+
+            first.shutdown();
+            second.shutdown();
+        }
+
+        WHEN("one of the worlds shuts down") {
+            first.init();
+            second.init();
+            second.shutdown();
+
+            THEN("it releases its view") {
+                REQUIRE(shared.viewers<MeshData>() == 1);
+                REQUIRE(first.mesh_store() != nullptr);
+            }
+
+            first.shutdown();
+        }
+    }
+}
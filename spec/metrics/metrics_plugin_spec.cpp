@@ -0,0 +1,191 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../plugin_test_context.hpp"
+#include <cask/resource/project_root.hpp>
+#include <cask/event/event_swapper.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <cask/foundation/register_event_queue.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+struct MetricsTestContext : PluginTestContext {
+    ProjectRoot root;
+    EventSwapper swapper;
+    cask::EventQueueCatalog catalog;
+
+    MetricsTestContext() {
+        char directory[] = "/tmp/cask_metrics_plugin_spec_XXXXXX";
+        root.path = mkdtemp(directory);
+        uint32_t root_id = world.register_component("ProjectRoot");
+        world.bind(root_id, &root);
+        uint32_t swapper_id = world.register_component("EventSwapper");
+        world.bind(swapper_id, &swapper);
+        uint32_t catalog_id = world.register_component("EventQueueCatalog");
+        world.bind(catalog_id, &catalog);
+    }
+
+    ~MetricsTestContext() {
+        std::filesystem::remove_all(root.path);
+    }
+
+    cask::Metrics* metrics() {
+        return static_cast<cask::Metrics*>(world.resolve("Metrics"));
+    }
+
+    std::string exported() {
+        std::ifstream in(std::filesystem::path(root.path) / "metrics.prom");
+        std::stringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+};
+
+struct Ping {
+    int value;
+};
+
+SCENARIO("metrics plugin reports its metadata", "[metrics]") {
+    GIVEN("the metrics plugin") {
+        PluginInfo* info = get_plugin_info();
+
+        THEN("the plugin name is metrics") {
+            REQUIRE(std::strcmp(info->name, "metrics") == 0);
+        }
+
+        THEN("it defines Metrics and MetricsPluginState") {
+            REQUIRE(info->defines_count == 2);
+            REQUIRE(std::strcmp(info->defines_components[0], "Metrics") == 0);
+            REQUIRE(std::strcmp(info->defines_components[1], "MetricsPluginState") == 0);
+        }
+
+        THEN("it requires ProjectRoot and EventSwapper") {
+            REQUIRE(info->requires_count == 2);
+            REQUIRE(std::strcmp(info->requires_components[0], "ProjectRoot") == 0);
+            REQUIRE(std::strcmp(info->requires_components[1], "EventSwapper") == 0);
+        }
+
+        THEN("it provides init, tick and shutdown functions") {
+            REQUIRE(info->init_fn != nullptr);
+            REQUIRE(info->tick_fn != nullptr);
+            REQUIRE(info->frame_fn == nullptr);
+            REQUIRE(info->shutdown_fn != nullptr);
+        }
+    }
+}
+
+SCENARIO("metrics plugin exports under ProjectRoot", "[metrics]") {
+    GIVEN("an initialized metrics plugin") {
+        MetricsTestContext context;
+        context.init();
+
+        THEN("Metrics writes to metrics.prom in the project root") {
+            REQUIRE(context.metrics()->path_ == std::filesystem::path(context.root.path) / "metrics.prom");
+        }
+
+        WHEN("a counter is incremented and tick is called") {
+            context.metrics()->counter("cask_test_total", "Test counter.").add(3);
+            context.tick();
+
+            THEN("the snapshot file holds the counter in Prometheus text format") {
+                auto text = context.exported();
+                REQUIRE(text.find("# TYPE cask_test_total counter") != std::string::npos);
+                REQUIRE(text.find("cask_test_total 3") != std::string::npos);
+            }
+        }
+
+        WHEN("tick is called twice within the interval") {
+            context.tick();
+            context.tick();
+
+            THEN("only one snapshot is written") {
+                REQUIRE(context.metrics()->writes_ == 1);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("metrics plugin samples event queues registered after it", "[metrics]") {
+    GIVEN("an initialized metrics plugin and a registered queue") {
+        MetricsTestContext context;
+        context.init();
+        cask::WorldView view(context.handle);
+        auto* queue = cask::register_event_queue<Ping>(view, "PingQueue");
+
+        WHEN("events are emitted, swapped and the plugin ticks") {
+            queue->emit(Ping{1});
+            queue->emit(Ping{2});
+            context.swapper.swap_all();
+            context.tick();
+            context.swapper.swap_all();
+            context.tick();
+
+            THEN("the delivered counter accumulates and the depth gauge tracks the last swap") {
+                auto label = cask::metric_label("queue", "PingQueue");
+                REQUIRE(context.metrics()->counter("cask_events_delivered_total", "", label).value() == 2);
+                REQUIRE(context.metrics()->gauge("cask_event_queue_depth", "", label).value() == 0);
+            }
+        }
+
+        WHEN("the queue is unobserved") {
+            cask::unobserve_event_queue(context.handle, queue);
+
+            THEN("it is no longer sampled or cataloged") {
+                REQUIRE(context.metrics()->queues_.empty());
+                REQUIRE(context.catalog.queues_.empty());
+            }
+        }
+
+        cask::unobserve_event_queue(context.handle, queue);
+        context.world.destroy("PingQueue");
+        context.shutdown();
+    }
+}
+
+SCENARIO("metrics plugin samples event queues registered before it", "[metrics]") {
+    GIVEN("a queue registered before the metrics plugin initializes") {
+        MetricsTestContext context;
+        cask::WorldView view(context.handle);
+        auto* queue = cask::register_event_queue<Ping>(view, "PingQueue");
+        context.init();
+
+        WHEN("events are emitted, swapped and the plugin ticks") {
+            queue->emit(Ping{1});
+            context.swapper.swap_all();
+            context.tick();
+
+            THEN("the queue is observed once and its events are counted") {
+                auto label = cask::metric_label("queue", "PingQueue");
+                REQUIRE(context.metrics()->queues_.size() == 1);
+                REQUIRE(context.metrics()->counter("cask_events_delivered_total", "", label).value() == 1);
+            }
+        }
+
+        cask::unobserve_event_queue(context.handle, queue);
+        context.world.destroy("PingQueue");
+        context.shutdown();
+    }
+}
+
+SCENARIO("metrics plugin writes a final snapshot on shutdown", "[metrics]") {
+    GIVEN("an initialized metrics plugin with a long interval") {
+        MetricsTestContext context;
+        context.init();
+        context.metrics()->interval_ = std::chrono::hours(1);
+        context.tick();
+        context.metrics()->counter("cask_late_total", "Late counter.").add();
+
+        WHEN("shutdown is called") {
+            context.shutdown();
+
+            THEN("the file holds the latest values") {
+                REQUIRE(context.exported().find("cask_late_total 1") != std::string::npos);
+            }
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../plugin_test_context.hpp"
+#include <cask/resource/project_root.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/resource_loader_registry.hpp>
+#include <cask/foundation/pack_archive.hpp>
+#include <cask/foundation/register_asset_loader.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+struct PackTestContext : PluginTestContext {
+    ProjectRoot root;
+
+    PackTestContext() {
+        char directory[] = "/tmp/cask_pack_plugin_spec_XXXXXX";
+        root.path = mkdtemp(directory);
+        uint32_t root_id = world.register_component("ProjectRoot");
+        world.bind(root_id, &root);
+    }
+
+    ~PackTestContext() {
+        std::filesystem::remove_all(root.path);
+    }
+
+    cask::AssetReader* reader() {
+        return static_cast<cask::AssetReader*>(world.resolve("AssetReader"));
+    }
+};
+
+SCENARIO("pack plugin reports its metadata", "[pack]") {
+    GIVEN("the pack plugin") {
+        PluginInfo* info = get_plugin_info();
+
+        THEN("the plugin name is pack") {
+            REQUIRE(std::strcmp(info->name, "pack") == 0);
+        }
+
+        THEN("it defines AssetReader") {
+            REQUIRE(info->defines_count == 1);
+            REQUIRE(std::strcmp(info->defines_components[0], "AssetReader") == 0);
+        }
+
+        THEN("it requires ProjectRoot") {
+            REQUIRE(info->requires_count == 1);
+            REQUIRE(std::strcmp(info->requires_components[0], "ProjectRoot") == 0);
+        }
+
+        THEN("it provides only an init function") {
+            REQUIRE(info->init_fn != nullptr);
+            REQUIRE(info->tick_fn == nullptr);
+            REQUIRE(info->frame_fn == nullptr);
+            REQUIRE(info->shutdown_fn == nullptr);
+        }
+    }
+}
+
+SCENARIO("pack plugin opens the project pack when present", "[pack]") {
+    GIVEN("a project root containing assets.pack") {
+        PackTestContext context;
+        std::filesystem::create_directories(context.root.path + "/source");
+        std::ofstream(context.root.path + "/source/crate.obj") << "v 0 0 0";
+        REQUIRE(cask::write_pack(context.root.path + "/source", context.root.path + "/assets.pack"));
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("AssetReader serves files from the archive") {
+                REQUIRE(context.reader() != nullptr);
+                REQUIRE(context.reader()->archive_.is_open());
+                REQUIRE(context.reader()->read("crate.obj").from_pack);
+            }
+
+            context.shutdown();
+        }
+    }
+}
+
+SCENARIO("pack plugin falls back to loose files without a pack", "[pack]") {
+    GIVEN("a project root with only loose files") {
+        PackTestContext context;
+        std::ofstream(context.root.path + "/crate.obj") << "v 0 0 0";
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("AssetReader reads loose files relative to ProjectRoot") {
+                REQUIRE_FALSE(context.reader()->archive_.is_open());
+                auto asset = context.reader()->read("crate.obj");
+                REQUIRE(asset.found());
+                REQUIRE_FALSE(asset.from_pack);
+            }
+
+            context.shutdown();
+        }
+    }
+}
+
+SCENARIO("asset loaders read source files through AssetReader", "[pack]") {
+    GIVEN("an initialized pack plugin, a mesh loader registry and a loose source file") {
+        PackTestContext context;
+        cask::ResourceLoaderRegistry<MeshData> loaders;
+        uint32_t loaders_id = context.world.register_component("MeshLoaderRegistry");
+        context.world.bind(loaders_id, &loaders);
+        std::ofstream(context.root.path + "/crate.bin") << "abcd";
+        context.init();
+        cask::WorldView view(context.handle);
+        bool decoded = false;
+        REQUIRE(cask::register_asset_loader<MeshData>(view, "bytes", [&decoded](std::span<const uint8_t> bytes, const nlohmann::json&) {
+            decoded = bytes.size() == 4 && bytes[0] == 'a';
+            MeshData mesh;
+            mesh.indices.assign(bytes.begin(), bytes.end());
+            return mesh;
+        }));
+        nlohmann::json entry = {{"loader", "bytes"}, {"path", "crate.bin"}};
+
+        WHEN("the registered loader runs") {
+            MeshData mesh = loaders.load(entry);
+
+            THEN("it decodes the loose file") {
+                REQUIRE(decoded);
+                REQUIRE(mesh.indices.size() == 4);
+            }
+        }
+
+        WHEN("the source file is missing") {
+            nlohmann::json missing = {{"loader", "bytes"}, {"path", "barrel.bin"}};
+
+            THEN("the loader throws instead of decoding nothing") {
+                REQUIRE_THROWS(loaders.load(missing));
+            }
+        }
+
+        context.shutdown();
+    }
+
+    GIVEN("a world without an AssetReader") {
+        PackTestContext context;
+        cask::WorldView view(context.handle);
+
+        THEN("no loader is registered") {
+            REQUIRE_FALSE(cask::register_asset_loader<MeshData>(view, "bytes", [](std::span<const uint8_t>, const nlohmann::json&) {
+                return MeshData{};
+            }));
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../plugin_test_context.hpp"
+#include <cask/foundation/frame_profiler.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+struct ProfilerTestContext : PluginTestContext {
+    cask::FrameProfiler* profiler() {
+        return static_cast<cask::FrameProfiler*>(world.resolve("FrameProfiler"));
+    }
+};
+
+SCENARIO("profiler plugin reports its metadata", "[profiler]") {
+    GIVEN("the profiler plugin") {
+        PluginInfo* info = get_plugin_info();
+
+        THEN("the plugin name is profiler") {
+            REQUIRE(std::strcmp(info->name, "profiler") == 0);
+        }
+
+        THEN("it defines FrameProfiler") {
+            REQUIRE(info->defines_count == 1);
+            REQUIRE(std::strcmp(info->defines_components[0], "FrameProfiler") == 0);
+        }
+
+        THEN("it requires no components") {
+            REQUIRE(info->requires_count == 0);
+            REQUIRE(info->requires_components == nullptr);
+        }
+
+        THEN("it provides only an init function") {
+            REQUIRE(info->init_fn != nullptr);
+            REQUIRE(info->tick_fn == nullptr);
+            REQUIRE(info->frame_fn == nullptr);
+            REQUIRE(info->shutdown_fn == nullptr);
+        }
+    }
+}
+
+SCENARIO("profiler plugin initializes FrameProfiler with tracing opt-in", "[profiler]") {
+    GIVEN("a world and the profiler plugin with CASK_FRAME_PROFILER unset") {
+        unsetenv("CASK_FRAME_PROFILER");
+        ProfilerTestContext context;
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("FrameProfiler is registered and disabled") {
+                REQUIRE(context.profiler() != nullptr);
+                REQUIRE_FALSE(context.profiler()->enabled());
+            }
+
+            context.shutdown();
+        }
+    }
+
+    GIVEN("CASK_FRAME_PROFILER is set to 1") {
+        setenv("CASK_FRAME_PROFILER", "1", 1);
+        ProfilerTestContext context;
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("FrameProfiler starts enabled") {
+                REQUIRE(context.profiler()->enabled());
+            }
+
+            context.shutdown();
+        }
+
+        unsetenv("CASK_FRAME_PROFILER");
+    }
+
+    GIVEN("CASK_FRAME_PROFILER is set to 0") {
+        setenv("CASK_FRAME_PROFILER", "0", 1);
+        ProfilerTestContext context;
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("FrameProfiler starts disabled") {
+                REQUIRE_FALSE(context.profiler()->enabled());
+            }
+
+            context.shutdown();
+        }
+
+        unsetenv("CASK_FRAME_PROFILER");
+    }
+}
+
+SCENARIO("trace scopes record into per-thread buffers", "[profiler]") {
+    GIVEN("an initialized profiler") {
+        ProfilerTestContext context;
+        context.init();
+        auto* profiler = context.profiler();
+        profiler->set_enabled(true);
+        cask::ProfilerBinding binding;
+
+        THEN("a binding resolves the profiler once") {
+            REQUIRE(binding.resolve(context.handle) == profiler);
+            REQUIRE(binding.bound_);
+        }
+
+        WHEN("scopes close on two threads") {
+            {
+                cask::TraceScope scope(binding.resolve(context.handle), "event_tick");
+            }
+            std::thread worker([profiler] {
+                cask::TraceScope scope(profiler, "worker_job");
+            });
+            worker.join();
+
+            THEN("each thread has its own buffer") {
+                REQUIRE(profiler->buffers_.size() == 2);
+                REQUIRE(profiler->event_count() == 2);
+            }
+
+            THEN("the Chrome trace lists both events as complete events") {
+                std::ostringstream output;
+                profiler->write_chrome_trace(output);
+                auto trace = output.str();
+                REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+                REQUIRE(trace.find("\"name\":\"event_tick\",\"ph\":\"X\"") != std::string::npos);
+                REQUIRE(trace.find("\"name\":\"worker_job\"") != std::string::npos);
+            }
+        }
+
+        WHEN("the profiler is disabled") {
+            profiler->set_enabled(false);
+            {
+                cask::TraceScope scope(binding.resolve(context.handle), "event_tick");
+            }
+
+            THEN("nothing is recorded") {
+                REQUIRE(profiler->event_count() == 0);
+            }
+        }
+
+        WHEN("a thread records into two profilers in turn") {
+            cask::FrameProfiler other;
+            for (int round = 0; round < 3; ++round) {
+                cask::TraceScope first(profiler, "first");
+                cask::TraceScope second(&other, "second");
+            }
+
+            THEN("each profiler keeps one buffer for the thread") {
+                REQUIRE(profiler->buffers_.size() == 1);
+                REQUIRE(other.buffers_.size() == 1);
+                REQUIRE(profiler->event_count() == 3);
+                REQUIRE(other.event_count() == 3);
+            }
+        }
+
+        WHEN("a trace is exported while another thread records") {
+            std::atomic<bool> stop{false};
+            std::thread worker([profiler, &stop] {
+                while (!stop.load()) {
+                    cask::TraceScope scope(profiler, "worker_job");
+                }
+            });
+            std::ostringstream output;
+            for (int round = 0; round < 20; ++round) {
+                output.str(std::string());
+                profiler->write_chrome_trace(output);
+                profiler->clear();
+            }
+            stop = true;
+            worker.join();
+
+            THEN("the export stays well formed") {
+                auto trace = output.str();
+                REQUIRE(trace.rfind("]}") == trace.size() - 2);
+            }
+        }
+
+        WHEN("more events are recorded than the ring holds") {
+            for (size_t index = 0; index < cask::TraceBuffer::capacity + 10; ++index) {
+                cask::TraceScope scope(profiler, "burst");
+            }
+
+            THEN("only the newest events are kept") {
+                REQUIRE(profiler->event_count() == cask::TraceBuffer::capacity);
+            }
+        }
+
+        context.shutdown();
+    }
+
+    GIVEN("a world without a profiler") {
+        PluginTestContext context;
+
+        THEN("trace scopes are inert") {
+            cask::ProfilerBinding binding;
+            cask::TraceScope scope(binding.resolve(context.handle), "event_tick");
+            REQUIRE(scope.profiler_ == nullptr);
+        }
+    }
+}
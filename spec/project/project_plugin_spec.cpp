@@ -1,8 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include "../plugin_test_context.hpp"
 #include <cask/resource/project_root.hpp>
+#include <cask/foundation/project_filesystem.hpp>
 #include <cstring>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 
 SCENARIO("project plugin registers ProjectRoot on init", "[project]") {
     GIVEN("a fresh world with the project plugin") {
@@ -92,9 +95,10 @@ SCENARIO("project plugin reports correct metadata", "[project]") {
             REQUIRE(std::strcmp(info->name, "project") == 0);
         }
 
-        THEN("it defines ProjectRoot") {
-            REQUIRE(info->defines_count == 1);
+        THEN("it defines ProjectRoot and ProjectFilesystem") {
+            REQUIRE(info->defines_count == 2);
             REQUIRE(std::strcmp(info->defines_components[0], "ProjectRoot") == 0);
+            REQUIRE(std::strcmp(info->defines_components[1], "ProjectFilesystem") == 0);
         }
 
         THEN("it requires no components") {
@@ -105,8 +109,8 @@ SCENARIO("project plugin reports correct metadata", "[project]") {
             REQUIRE(info->init_fn != nullptr);
         }
 
-        THEN("it does not provide a tick function") {
-            REQUIRE(info->tick_fn == nullptr);
+        THEN("it provides a tick function") {
+            REQUIRE(info->tick_fn != nullptr);
         }
 
         THEN("it does not provide a frame function") {
@@ -118,3 +122,57 @@ SCENARIO("project plugin reports correct metadata", "[project]") {
         }
     }
 }
+
+SCENARIO("project plugin indexes the project tree into ProjectFilesystem", "[project]") {
+    GIVEN("a project root containing nested files") {
+        char directory[] = "/tmp/cask_project_spec_XXXXXX";
+        std::string root_path = mkdtemp(directory);
+        std::filesystem::create_directories(root_path + "/meshes");
+        std::ofstream(root_path + "/meshes/crate.obj") << "v 0 0 0";
+        std::ofstream(root_path + "/scene.json") << "{}";
+
+        PluginTestContext context;
+        ProjectRoot root{root_path};
+        uint32_t root_id = context.world.register_component("ProjectRoot");
+        context.world.bind(root_id, &root);
+
+        WHEN("init is called") {
+            context.init();
+            auto* filesystem = static_cast<cask::ProjectFilesystem*>(context.world.resolve("ProjectFilesystem"));
+
+            THEN("ProjectFilesystem is registered and rooted at ProjectRoot") {
+                REQUIRE(filesystem != nullptr);
+                REQUIRE(filesystem->root_ == root_path);
+            }
+
+            THEN("the tree is not walked during init") {
+                REQUIRE_FALSE(filesystem->indexed_);
+            }
+
+            THEN("files are indexed by relative path with their sizes") {
+                REQUIRE(filesystem->exists("scene.json"));
+                REQUIRE(filesystem->exists("meshes/crate.obj"));
+                REQUIRE(filesystem->find("meshes/crate.obj")->size == 7);
+            }
+
+            THEN("missing files are not indexed") {
+                REQUIRE_FALSE(filesystem->exists("meshes/barrel.obj"));
+            }
+        }
+
+        WHEN("a queried file is rewritten and the plugin ticks") {
+            context.init();
+            auto* filesystem = static_cast<cask::ProjectFilesystem*>(context.world.resolve("ProjectFilesystem"));
+            filesystem->refresh_interval_ = std::chrono::milliseconds(0);
+            REQUIRE(filesystem->find("meshes/crate.obj")->size == 7);
+            std::ofstream(root_path + "/meshes/crate.obj") << "v 0 0 0 1";
+            context.tick();
+
+            THEN("the index holds the new size") {
+                REQUIRE(filesystem->find("meshes/crate.obj")->size == 9);
+            }
+        }
+
+        std::filesystem::remove_all(root_path);
+    }
+}
@@ -8,6 +8,7 @@
 #include <cask/ecs/entity_events.hpp>
 #include <cask/event/event_queue.hpp>
 #include <cask/foundation/register_component_store.hpp>
+#include <cask/foundation/memory_report.hpp>
 
 struct TestComponent {
     int value;
@@ -68,3 +69,51 @@ SCENARIO("registered component store is wired to the EntityCompactor", "[registr
         }
     }
 }
+
+SCENARIO("registered component store is tracked by the world MemoryReport", "[registration]") {
+    GIVEN("a world with an EntityCompactor and a MemoryReport") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        cask::WorldView view(handle);
+
+        auto* compactor = view.register_component<EntityCompactor>("EntityCompactor");
+        EntityTable table;
+        compactor->table_ = &table;
+        auto* report = view.register_component<cask::MemoryReport>("MemoryReport");
+
+        WHEN("register_component_store is called") {
+            cask::register_component_store<TestComponent>(view, "TestComponents");
+
+            THEN("the report has an entry for the store") {
+                REQUIRE(report->entries_.size() == 1);
+                REQUIRE(report->entries_[0].name == "TestComponents");
+            }
+        }
+    }
+}
+
+SCENARIO("registered component store is defragmented by default", "[registration]") {
+    GIVEN("a world with an EntityCompactor and a StoreDefragmenter") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        cask::WorldView view(handle);
+
+        auto* compactor = view.register_component<EntityCompactor>("EntityCompactor");
+        EntityTable table;
+        compactor->table_ = &table;
+        auto* defragmenter = view.register_component<cask::StoreDefragmenter>("StoreDefragmenter");
+
+        WHEN("register_component_store is called") {
+            auto* store = cask::register_component_store<TestComponent>(view, "TestComponents");
+
+            THEN("the defragmenter tracks the store") {
+                REQUIRE(defragmenter->tracks(store));
+            }
+
+            THEN("unregistering the store removes it from the defragmenter") {
+                cask::unregister_component_store(handle, "TestComponents", store);
+                REQUIRE_FALSE(defragmenter->tracks(store));
+            }
+        }
+    }
+}
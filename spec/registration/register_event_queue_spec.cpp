@@ -54,3 +54,50 @@ SCENARIO("registered event queue is wired to the EventSwapper", "[registration]"
         }
     }
 }
+
+SCENARIO("registered event queue advances its generation when EventGenerations is present", "[registration]") {
+    GIVEN("a world with an EventSwapper, EventGenerations and a registered event queue") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        cask::WorldView view(handle);
+
+        auto* swapper = view.register_component<EventSwapper>("EventSwapper");
+        view.register_component<cask::EventGenerations>("EventGenerations");
+        auto* queue = cask::register_event_queue<TestEvent>(view, "TestEventQueue");
+        auto cursor = cask::event_cursor(view, queue);
+
+        WHEN("an event is emitted and the swapper swaps all") {
+            queue->emit(TestEvent{42});
+            swapper->swap_all();
+
+            THEN("the cursor reads the event once") {
+                auto events = cursor.read();
+                REQUIRE(events.size() == 1);
+                REQUIRE(events[0].value == 42);
+                REQUIRE(cursor.read().empty());
+            }
+        }
+    }
+}
+
+SCENARIO("unregistering an event queue untracks it", "[registration]") {
+    GIVEN("a world with a rollback, a memory report and a registered event queue") {
+        World world;
+        WorldHandle handle = handle_from_world(&world);
+        cask::WorldView view(handle);
+
+        view.register_component<EventSwapper>("EventSwapper");
+        auto* rollback = view.register_component<cask::Rollback>("Rollback");
+        auto* report = view.register_component<cask::MemoryReport>("MemoryReport");
+        auto* queue = cask::register_event_queue<TestEvent>(view, "TestEventQueue");
+
+        WHEN("the queue is unregistered") {
+            cask::unregister_event_queue(handle, "TestEventQueue", queue);
+
+            THEN("neither the rollback nor the memory report refer to it") {
+                REQUIRE_FALSE(rollback->tracks(queue));
+                REQUIRE(report->entries_.empty());
+            }
+        }
+    }
+}
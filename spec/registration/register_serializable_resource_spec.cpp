@@ -14,6 +14,7 @@
 #include <cask/resource/resource_sources.hpp>
 #include <cask/resource/resource_descriptor.hpp>
 #include <cask/foundation/register_serializable_resource.hpp>
+#include <cask/foundation/store_generations.hpp>
 
 struct TestResource {
     int value;
@@ -182,3 +183,56 @@ SCENARIO("resource sources round-trip invokes registered loaders", "[resource_re
         }
     }
 }
+
+SCENARIO("deserializing resource sources advances their write generation", "[resource_registration]") {
+    GIVEN("a world with StoreGenerations and a registered serializable resource") {
+        SerializableResourceContext context;
+        auto* generations = context.view.register_component<cask::StoreGenerations>("StoreGenerations");
+        context.loader_registry()->add("test", [](const nlohmann::json& entry_json) {
+            return TestResource{entry_json["val"].get<int>()};
+        });
+        auto* sources = cask::register_serializable_resource<TestResource>(context.view);
+
+        WHEN("sources are deserialized") {
+            sources->entries["item_a"] = {{"loader", "test"}, {"val", 7}};
+            auto& sources_entry = context.registry()->get("TestResourceSources");
+            auto serialized = sources_entry.serialize(sources);
+            sources->entries.clear();
+            sources_entry.deserialize(serialized, sources, nlohmann::json{});
+
+            THEN("the sources' write generation advances") {
+                REQUIRE(generations->generation(sources) == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("deserializing resource sources in a world viewing a shared store stages the loads in the cache", "[resource_registration]") {
+    GIVEN("a world whose resource store view is attached to SharedResources") {
+        SerializableResourceContext context;
+        cask::SharedResources shared;
+        auto* view = context.view.register_component<cask::SharedResourceView<TestResource>>("TestResourceStoreView");
+        view->cache_ = &shared;
+        view->shared_ = shared.store<TestResource>();
+        context.loader_registry()->add("test", [](const nlohmann::json& entry_json) {
+            return TestResource{entry_json["val"].get<int>()};
+        });
+        auto* sources = cask::register_serializable_resource<TestResource>(context.view);
+
+        WHEN("sources are deserialized") {
+            sources->entries["item_a"] = {{"loader", "test"}, {"val", 7}};
+            auto& sources_entry = context.registry()->get("TestResourceSources");
+            auto serialized = sources_entry.serialize(sources);
+            sources->entries.clear();
+            sources_entry.deserialize(serialized, sources, nlohmann::json{});
+
+            THEN("the shared store is untouched until the host applies the staged load") {
+                REQUIRE(shared.staged() == 1);
+                REQUIRE(view->shared_->resources_.empty());
+                shared.apply_staged();
+                auto handle_value = view->shared_->key_to_handle_.at("item_a");
+                REQUIRE(view->shared_->resources_[handle_value].value == 7);
+            }
+        }
+    }
+}
@@ -12,6 +12,8 @@
 #include <cask/schema/describe.hpp>
 #include <cask/schema/cask_component.hpp>
 #include <cask/foundation/register_serializable_store.hpp>
+#include <cask/foundation/prefab.hpp>
+#include <vector>
 
 CASK_COMPONENT(TestValue,
     (float, health),
@@ -35,11 +37,16 @@ struct SerializableStoreContext {
 
         view.register_component<EventSwapper>("EventSwapper");
         view.register_component<cask::SerializationRegistry>("SerializationRegistry");
+        view.register_component<cask::Prefabs>("Prefabs");
     }
 
     cask::SerializationRegistry* registry() {
         return view.resolve<cask::SerializationRegistry>("SerializationRegistry");
     }
+
+    cask::Prefabs* prefabs() {
+        return view.resolve<cask::Prefabs>("Prefabs");
+    }
 };
 
 SCENARIO("registering a serializable store makes it resolvable from the world", "[registration]") {
@@ -136,3 +143,53 @@ SCENARIO("serializable store entry has correct dependencies", "[registration]")
         }
     }
 }
+
+SCENARIO("serializable store can be filled by prefabs", "[registration]") {
+    GIVEN("a world with a registered serializable store") {
+        SerializableStoreContext context;
+        auto value_entry = TestValue::describe();
+        auto* store = cask::register_serializable_store<TestValue>(
+            context.view, "TestValueComponents", value_entry);
+
+        WHEN("a prefab is compiled from the value's serialized form") {
+            TestValue value{75.0f, 9};
+            nlohmann::json entity;
+            entity["TestValueComponents"] = value_entry.serialize(&value);
+            context.prefabs()->compile("scored", entity);
+            std::vector<uint32_t> created;
+            context.prefabs()->instantiate("scored", context.table, 2, created);
+
+            THEN("the store is known to Prefabs") {
+                REQUIRE(context.prefabs()->store_count() == 1);
+            }
+
+            THEN("instances hold the deserialized value") {
+                REQUIRE(created.size() == 2);
+                REQUIRE(store->get(created[1]).health == 75.0f);
+                REQUIRE(store->get(created[1]).score == 9);
+            }
+        }
+    }
+}
+
+SCENARIO("unregistering a serializable store untracks it", "[registration]") {
+    GIVEN("a world with a rollback, store generations, a memory report and a registered store") {
+        SerializableStoreContext context;
+        auto* rollback = context.view.register_component<cask::Rollback>("Rollback");
+        auto* generations = context.view.register_component<cask::StoreGenerations>("StoreGenerations");
+        auto* report = context.view.register_component<cask::MemoryReport>("MemoryReport");
+        auto* store = cask::register_serializable_store<TestValue>(
+            context.view, "TestValueComponents", TestValue::describe());
+
+        WHEN("the store is unregistered") {
+            cask::unregister_serializable_store(context.handle, "TestValueComponents", store);
+
+            THEN("no foundation index refers to it") {
+                REQUIRE_FALSE(rollback->tracks(store));
+                REQUIRE(generations->generations_.count(store) == 0);
+                REQUIRE(report->entries_.empty());
+                REQUIRE(context.prefabs()->store_count() == 0);
+            }
+        }
+    }
+}
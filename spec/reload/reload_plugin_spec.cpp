@@ -0,0 +1,339 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../plugin_test_context.hpp"
+#include <cask/resource/project_root.hpp>
+#include <cask/resource/resource_store.hpp>
+#include <cask/resource/resource_sources.hpp>
+#include <cask/resource/resource_loader_registry.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/resource/texture_data.hpp>
+#include <cask/foundation/asset_reloader.hpp>
+#include <cask/foundation/shared_resources.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+struct ReloadTestContext : PluginTestContext {
+    ProjectRoot root;
+    ResourceStore<MeshData> mesh_store;
+    cask::ResourceLoaderRegistry<MeshData> mesh_loaders;
+    ResourceSources<MeshData> mesh_sources;
+    ResourceStore<TextureData> texture_store;
+    cask::ResourceLoaderRegistry<TextureData> texture_loaders;
+    int mesh_loads = 0;
+
+    ReloadTestContext() {
+        char directory[] = "/tmp/cask_reload_spec_XXXXXX";
+        root.path = mkdtemp(directory);
+
+        bind("ProjectRoot", &root);
+        bind("MeshStore", &mesh_store);
+        bind("MeshLoaderRegistry", &mesh_loaders);
+        bind("MeshSources", &mesh_sources);
+        bind("TextureStore", &texture_store);
+        bind("TextureLoaderRegistry", &texture_loaders);
+
+        mesh_loaders.add("counting", [this](const nlohmann::json&) {
+            ++mesh_loads;
+            return MeshData{};
+        });
+    }
+
+    ~ReloadTestContext() {
+        std::filesystem::remove_all(root.path);
+    }
+
+    void bind(const char* name, void* component) {
+        uint32_t component_id = world.register_component(name);
+        world.bind(component_id, component);
+    }
+
+    void add_mesh(const std::string& key, const std::string& relative_path) {
+        write(relative_path, "v 0 0 0");
+        mesh_sources.entries[key] = {{"loader", "counting"}, {"path", relative_path}};
+        mesh_store.key_to_handle_[key] = uint32_t(mesh_store.resources_.size());
+        mesh_store.resources_.push_back(MeshData{});
+    }
+
+    void write(const std::string& relative_path, const std::string& contents) {
+        std::filesystem::path path = std::filesystem::path(root.path) / relative_path;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << contents;
+    }
+
+    cask::AssetReloader* reloader() {
+        return static_cast<cask::AssetReloader*>(world.resolve("AssetReloader"));
+    }
+
+    bool tick_until_mesh_loads(int expected) {
+        for (int attempt = 0; attempt < 200; ++attempt) {
+            tick();
+            if (mesh_loads >= expected && reloader()->reloads_applied_ >= size_t(expected)) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    }
+};
+
+SCENARIO("reload plugin reports its metadata", "[reload]") {
+    GIVEN("the reload plugin") {
+        PluginInfo* info = get_plugin_info();
+
+        THEN("the plugin name is reload") {
+            REQUIRE(info->name != nullptr);
+            REQUIRE(std::strcmp(info->name, "reload") == 0);
+        }
+
+        THEN("it defines AssetReloader and ReloadPluginState") {
+            REQUIRE(info->defines_count == 2);
+            REQUIRE(std::strcmp(info->defines_components[0], "AssetReloader") == 0);
+            REQUIRE(std::strcmp(info->defines_components[1], "ReloadPluginState") == 0);
+        }
+
+        THEN("it requires ProjectRoot and the mesh and texture stores and loaders") {
+            REQUIRE(info->requires_count == 5);
+            REQUIRE(std::strcmp(info->requires_components[0], "ProjectRoot") == 0);
+            REQUIRE(std::strcmp(info->requires_components[1], "MeshStore") == 0);
+            REQUIRE(std::strcmp(info->requires_components[2], "MeshLoaderRegistry") == 0);
+            REQUIRE(std::strcmp(info->requires_components[3], "TextureStore") == 0);
+            REQUIRE(std::strcmp(info->requires_components[4], "TextureLoaderRegistry") == 0);
+        }
+
+        THEN("it provides init and tick functions") {
+            REQUIRE(info->init_fn != nullptr);
+            REQUIRE(info->tick_fn != nullptr);
+        }
+
+        THEN("it does not provide frame or shutdown functions") {
+            REQUIRE(info->frame_fn == nullptr);
+            REQUIRE(info->shutdown_fn == nullptr);
+        }
+    }
+}
+
+SCENARIO("reload plugin initializes AssetReloader at the project root", "[reload]") {
+    GIVEN("a world with the required components") {
+        ReloadTestContext context;
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("AssetReloader is registered with the project root") {
+                REQUIRE(context.reloader() != nullptr);
+                REQUIRE(context.reloader()->root_ == context.root.path);
+            }
+
+            context.shutdown();
+        }
+    }
+}
+
+SCENARIO("reload plugin re-decodes only changed assets", "[reload]") {
+    GIVEN("an initialized reload plugin tracking two meshes") {
+        ReloadTestContext context;
+        context.add_mesh("crate", "meshes/crate.obj");
+        context.add_mesh("barrel", "meshes/barrel.obj");
+        context.init();
+        context.reloader()->quiet_period_ = std::chrono::milliseconds(0);
+        context.tick();
+
+        WHEN("one mesh file is rewritten") {
+            context.write("meshes/crate.obj", "v 1 1 1");
+
+            THEN("exactly one reload is decoded and applied") {
+                REQUIRE(context.tick_until_mesh_loads(1));
+                REQUIRE(context.mesh_loads == 1);
+                REQUIRE(context.reloader()->reloads_scheduled_ == 1);
+            }
+
+            THEN("existing handles still resolve") {
+                REQUIRE(context.tick_until_mesh_loads(1));
+                REQUIRE(context.mesh_store.key_to_handle_.at("crate") == 0);
+                REQUIRE(context.mesh_store.resources_.size() == 2);
+            }
+        }
+
+        WHEN("an untracked file is written") {
+            context.write("meshes/notes.txt", "todo");
+            context.tick();
+
+            THEN("nothing is reloaded") {
+                REQUIRE(context.reloader()->reloads_scheduled_ == 0);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("reload plugin follows source entries that are replaced without changing the count", "[reload]") {
+    GIVEN("an initialized reload plugin tracking one mesh") {
+        ReloadTestContext context;
+        context.add_mesh("crate", "meshes/crate.obj");
+        context.init();
+        context.reloader()->quiet_period_ = std::chrono::milliseconds(0);
+        context.tick();
+
+        WHEN("the entry is renamed and pointed at a new file before the old file changes") {
+            context.mesh_sources.entries.erase("crate");
+            context.mesh_store.key_to_handle_.erase("crate");
+            context.add_mesh("box", "props/box.obj");
+            context.mesh_store.resources_.pop_back();
+            context.mesh_store.key_to_handle_["box"] = 0;
+            context.tick();
+            context.write("meshes/crate.obj", "v 1 1 1");
+            context.write("props/box.obj", "v 2 2 2");
+
+            THEN("the new entry reloads and the removed one is ignored") {
+                REQUIRE(context.tick_until_mesh_loads(1));
+                REQUIRE(context.reloader()->reloads_scheduled_ == 1);
+                REQUIRE(context.reloader()->path_to_sources_.count("meshes/crate.obj") == 0);
+            }
+        }
+
+        WHEN("a reload is requested for a key that no longer exists") {
+            auto job = context.reloader()->targets_[0].reload("missing");
+
+            THEN("no reload job is produced for the missing key") {
+                REQUIRE_FALSE(job);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("reload plugin drops reloads whose loader throws", "[reload]") {
+    GIVEN("an initialized reload plugin tracking a mesh whose loader fails and one that loads") {
+        ReloadTestContext context;
+        context.mesh_loaders.add("failing", [](const nlohmann::json&) -> MeshData {
+            throw std::runtime_error("truncated file");
+        });
+        context.add_mesh("crate", "meshes/crate.obj");
+        context.add_mesh("barrel", "meshes/barrel.obj");
+        context.mesh_sources.entries["crate"]["loader"] = "failing";
+        context.init();
+        context.reloader()->quiet_period_ = std::chrono::milliseconds(0);
+        context.tick();
+
+        WHEN("the failing mesh file is rewritten") {
+            context.write("meshes/crate.obj", "v 1 1 1");
+            for (int attempt = 0; attempt < 200 && context.reloader()->reloads_failed_ == 0; ++attempt) {
+                context.tick();
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+
+            THEN("the failure is reported with its key and nothing is applied") {
+                REQUIRE(context.reloader()->reloads_failed_ == 1);
+                REQUIRE(context.reloader()->failures_.size() == 1);
+                REQUIRE(context.reloader()->failures_[0].key == "crate");
+                REQUIRE(context.reloader()->failures_[0].error == "truncated file");
+                REQUIRE(context.reloader()->reloads_applied_ == 0);
+            }
+
+            THEN("the worker keeps reloading other assets") {
+                context.write("meshes/barrel.obj", "v 2 2 2");
+                REQUIRE(context.tick_until_mesh_loads(1));
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("reload plugin re-indexes sources by their write generation", "[reload]") {
+    GIVEN("an initialized reload plugin in a world with StoreGenerations") {
+        ReloadTestContext context;
+        cask::StoreGenerations generations;
+        context.bind("StoreGenerations", &generations);
+        context.add_mesh("crate", "meshes/crate.obj");
+        context.init();
+        context.reloader()->quiet_period_ = std::chrono::milliseconds(0);
+        context.tick();
+
+        WHEN("an entry is repointed without advancing the generation") {
+            context.add_mesh("box", "props/box.obj");
+            context.tick();
+
+            THEN("the index is not rebuilt") {
+                REQUIRE(context.reloader()->path_to_sources_.count("props/box.obj") == 0);
+            }
+        }
+
+        WHEN("the generation advances") {
+            context.add_mesh("box", "props/box.obj");
+            generations.touch(&context.mesh_sources);
+            context.tick();
+
+            THEN("the new entry is indexed") {
+                REQUIRE(context.reloader()->path_to_sources_.count("props/box.obj") == 1);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("reload plugin debounces bursts of writes", "[reload]") {
+    GIVEN("an initialized reload plugin with a long quiet period") {
+        ReloadTestContext context;
+        context.add_mesh("crate", "crate.obj");
+        context.init();
+        context.reloader()->quiet_period_ = std::chrono::hours(1);
+        context.tick();
+
+        WHEN("the file is written several times") {
+            context.write("crate.obj", "v 1 1 1");
+            context.write("crate.obj", "v 2 2 2");
+            context.tick();
+
+            THEN("the change is held back until the file goes quiet") {
+                REQUIRE(context.reloader()->reloads_scheduled_ == 0);
+                REQUIRE(context.reloader()->debouncer_.pending_.size() == 1);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("reload plugin stages reloads of shared resources", "[reload]") {
+    GIVEN("a reload plugin in a world viewing a shared mesh store") {
+        ReloadTestContext context;
+        cask::SharedResources shared;
+        cask::SharedResourceView<MeshData> view;
+        context.bind("SharedResources", &shared);
+        context.bind("MeshStoreView", &view);
+        view.cache_ = &shared;
+        view.shared_ = shared.store<MeshData>();
+        context.add_mesh("crate", "meshes/crate.obj");
+        MeshData cached;
+        cached.indices = {0, 1, 2};
+        shared.load<MeshData>("crate", [&cached] { return cached; });
+        shared.apply_staged();
+        context.init();
+        context.reloader()->quiet_period_ = std::chrono::milliseconds(0);
+        context.tick();
+
+        WHEN("the mesh file is rewritten") {
+            context.write("meshes/crate.obj", "v 1 1 1");
+            REQUIRE(context.tick_until_mesh_loads(1));
+
+            THEN("the reload waits in the cache instead of writing the shared store") {
+                REQUIRE(shared.staged() == 1);
+                REQUIRE(view.shared_->resources_[0].indices.size() == 3);
+            }
+
+            THEN("the host applies it between ticks") {
+                REQUIRE(shared.apply_staged() == 1);
+                REQUIRE(view.shared_->resources_[0].indices.empty());
+            }
+        }
+
+        context.shutdown();
+    }
+}
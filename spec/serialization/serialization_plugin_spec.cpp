@@ -51,11 +51,11 @@ SCENARIO("serialization plugin reports its metadata", "[serialization]") {
             REQUIRE(std::strcmp(info->requires_components[1], "EntityRegistry") == 0);
         }
 
-        THEN("it provides only an init function") {
+        THEN("it provides init and shutdown functions") {
             REQUIRE(info->init_fn != nullptr);
             REQUIRE(info->tick_fn == nullptr);
             REQUIRE(info->frame_fn == nullptr);
-            REQUIRE(info->shutdown_fn == nullptr);
+            REQUIRE(info->shutdown_fn != nullptr);
         }
     }
 }
@@ -0,0 +1,201 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../plugin_test_context.hpp"
+#include <cask/ecs/component_store.hpp>
+#include <cask/ecs/entity_events.hpp>
+#include <cask/event/event_queue.hpp>
+#include <cask/resource/mesh_data.hpp>
+#include <cask/foundation/bvh.hpp>
+#include <cask/foundation/entity_watchers.hpp>
+#include <cask/foundation/store_generations.hpp>
+#include <cstring>
+#include <set>
+
+struct SpatialTestContext : CompactableTestContext {
+    ComponentStore<MeshHandle> meshes;
+    cask::EntityWatchers watchers;
+    cask::StoreGenerations generations;
+
+    SpatialTestContext() {
+        uint32_t meshes_id = world.register_component("MeshComponents");
+        world.bind(meshes_id, &meshes);
+        watchers.attach(compactor);
+        uint32_t watchers_id = world.register_component("EntityWatchers");
+        world.bind(watchers_id, &watchers);
+        uint32_t generations_id = world.register_component("StoreGenerations");
+        world.bind(generations_id, &generations);
+    }
+
+    cask::MeshBounds* mesh_bounds() {
+        return static_cast<cask::MeshBounds*>(world.resolve("MeshBounds"));
+    }
+
+    ComponentStore<cask::Aabb>* world_bounds() {
+        return static_cast<ComponentStore<cask::Aabb>*>(world.resolve("WorldBounds"));
+    }
+
+    cask::Bvh* index() {
+        return static_cast<cask::Bvh*>(world.resolve("SpatialIndex"));
+    }
+
+    std::set<uint32_t> within(float low, float high) {
+        cask::Aabb region;
+        region.min[0] = region.min[1] = region.min[2] = low;
+        region.max[0] = region.max[1] = region.max[2] = high;
+        std::set<uint32_t> hits;
+        index()->query(region, [&hits](uint32_t entity) { hits.insert(entity); });
+        return hits;
+    }
+};
+
+static cask::Aabb unit_box(float offset) {
+    cask::Aabb bounds;
+    bounds.min[0] = bounds.min[1] = bounds.min[2] = offset;
+    bounds.max[0] = bounds.max[1] = bounds.max[2] = offset + 1.0f;
+    return bounds;
+}
+
+SCENARIO("spatial plugin reports its metadata", "[spatial]") {
+    GIVEN("the spatial plugin") {
+        PluginInfo* info = get_plugin_info();
+
+        THEN("the plugin name is spatial") {
+            REQUIRE(std::strcmp(info->name, "spatial") == 0);
+        }
+
+        THEN("it defines MeshBounds, WorldBounds, SpatialIndex and SpatialPluginState") {
+            REQUIRE(info->defines_count == 4);
+            REQUIRE(std::strcmp(info->defines_components[0], "MeshBounds") == 0);
+            REQUIRE(std::strcmp(info->defines_components[1], "WorldBounds") == 0);
+            REQUIRE(std::strcmp(info->defines_components[2], "SpatialIndex") == 0);
+            REQUIRE(std::strcmp(info->defines_components[3], "SpatialPluginState") == 0);
+        }
+
+        THEN("it requires MeshComponents, EntityWatchers and StoreGenerations") {
+            REQUIRE(info->requires_count == 3);
+            REQUIRE(std::strcmp(info->requires_components[0], "MeshComponents") == 0);
+            REQUIRE(std::strcmp(info->requires_components[1], "EntityWatchers") == 0);
+            REQUIRE(std::strcmp(info->requires_components[2], "StoreGenerations") == 0);
+        }
+
+        THEN("it provides init, tick and shutdown functions") {
+            REQUIRE(info->init_fn != nullptr);
+            REQUIRE(info->tick_fn != nullptr);
+            REQUIRE(info->frame_fn == nullptr);
+            REQUIRE(info->shutdown_fn != nullptr);
+        }
+    }
+}
+
+SCENARIO("spatial plugin indexes mesh entities by their mesh bounds", "[spatial]") {
+    GIVEN("an initialized spatial plugin and a mesh with recorded bounds") {
+        SpatialTestContext context;
+        context.init();
+        context.mesh_bounds()->record(3, unit_box(10.0f));
+
+        uint32_t entity = context.table.create();
+        context.meshes.insert(entity, MeshHandle{3});
+
+        WHEN("tick is called") {
+            context.tick();
+
+            THEN("the entity gets WorldBounds from its mesh") {
+                REQUIRE(context.world_bounds()->has(entity));
+                REQUIRE(context.world_bounds()->get(entity) == unit_box(10.0f));
+            }
+
+            THEN("the entity is found by a spatial query") {
+                REQUIRE(context.within(9.0f, 12.0f) == std::set<uint32_t>{entity});
+            }
+        }
+
+        WHEN("the game moves the entity's WorldBounds and tick is called") {
+            context.tick();
+            context.world_bounds()->insert(entity, unit_box(50.0f));
+            context.tick();
+
+            THEN("the index follows the new bounds") {
+                REQUIRE(context.within(9.0f, 12.0f).empty());
+                REQUIRE(context.within(49.0f, 52.0f) == std::set<uint32_t>{entity});
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("spatial plugin places meshes that change without a size change", "[spatial]") {
+    GIVEN("a mesh entity whose mesh has no bounds yet") {
+        SpatialTestContext context;
+        context.init();
+        context.mesh_bounds()->record(3, unit_box(10.0f));
+        context.mesh_bounds()->record(5, unit_box(30.0f));
+        uint32_t entity = context.table.create();
+        context.meshes.insert(entity, MeshHandle{4});
+        context.tick();
+        REQUIRE_FALSE(context.world_bounds()->has(entity));
+
+        WHEN("its mesh is rewritten to one with bounds and the write is recorded") {
+            context.meshes.insert(entity, MeshHandle{3});
+            context.generations.touch(&context.meshes);
+            context.tick();
+
+            THEN("the entity is placed") {
+                REQUIRE(context.world_bounds()->get(entity) == unit_box(10.0f));
+            }
+        }
+
+        WHEN("bounds are recorded for a mesh id below the known count") {
+            context.mesh_bounds()->record(4, unit_box(20.0f));
+            context.tick();
+
+            THEN("the entity is placed") {
+                REQUIRE(context.world_bounds()->get(entity) == unit_box(20.0f));
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("spatial plugin leaves the entity watchers on shutdown", "[spatial]") {
+    GIVEN("an initialized spatial plugin") {
+        SpatialTestContext context;
+        context.init();
+        REQUIRE(context.watchers.size() == 1);
+
+        WHEN("it shuts down") {
+            context.shutdown();
+
+            THEN("the index no longer watches entities") {
+                REQUIRE(context.watchers.size() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("spatial plugin drops compacted entities from the index", "[spatial]") {
+    GIVEN("an indexed mesh entity") {
+        SpatialTestContext context;
+        context.init();
+        context.mesh_bounds()->record(0, unit_box(0.0f));
+        uint32_t entity = context.table.create();
+        context.meshes.insert(entity, MeshHandle{0});
+        context.compactor.add(&context.meshes, remove_component<MeshHandle>);
+        context.tick();
+
+        WHEN("the entity is destroyed and compacted") {
+            EventQueue<DestroyEntity> queue;
+            queue.emit(DestroyEntity{entity});
+            queue.swap();
+            context.compactor.compact(queue);
+            context.tick();
+
+            THEN("its WorldBounds and index entry are gone") {
+                REQUIRE_FALSE(context.world_bounds()->has(entity));
+                REQUIRE_FALSE(context.index()->contains(entity));
+            }
+        }
+
+        context.shutdown();
+    }
+}
@@ -5,7 +5,11 @@
 #include <cask/ecs/component_store.hpp>
 #include <cask/event/event_queue.hpp>
 #include <cask/resource/resource_loader_registry.hpp>
+#include <cask/foundation/texture_streamer.hpp>
+#include <cask/foundation/metrics.hpp>
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 struct TextureTestContext : CompactableTestContext {
     ResourceStore<TextureData>* texture_store() {
@@ -22,8 +26,29 @@ struct TextureTestContext : CompactableTestContext {
         uint32_t registry_id = world.register_component("TextureLoaderRegistry");
         return world.get<cask::ResourceLoaderRegistry<TextureData>>(registry_id);
     }
+
+    cask::TextureStreamer* texture_streamer() {
+        uint32_t streamer_id = world.register_component("TextureStreamer");
+        return world.get<cask::TextureStreamer>(streamer_id);
+    }
 };
 
+static cask::MipLevel solid_level(uint32_t width, uint32_t height, uint8_t value) {
+    cask::MipLevel level;
+    level.width = width;
+    level.height = height;
+    level.channels = 4;
+    level.pixels.assign(size_t(width) * height * 4, value);
+    return level;
+}
+
+static cask::MipSourceFn solid_source(uint32_t extent, uint8_t value, std::vector<uint32_t>& decoded) {
+    return [extent, value, &decoded](uint32_t level) {
+        decoded.push_back(level);
+        return solid_level(std::max(extent >> level, 1u), std::max(extent >> level, 1u), value);
+    };
+}
+
 SCENARIO("texture plugin reports its metadata", "[texture]") {
     GIVEN("the texture plugin") {
         PluginInfo* info = get_plugin_info();
@@ -33,12 +58,15 @@ SCENARIO("texture plugin reports its metadata", "[texture]") {
             REQUIRE(std::strcmp(info->name, "texture") == 0);
         }
 
-        THEN("it defines TextureStore, TextureComponents, and TextureLoaderRegistry") {
-            REQUIRE(info->defines_count == 3);
+        THEN("it defines TextureStore, TextureComponents, TextureLoaderRegistry, TextureStreamer, TextureStoreView, and TexturePluginState") {
+            REQUIRE(info->defines_count == 6);
             REQUIRE(info->defines_components != nullptr);
             REQUIRE(std::strcmp(info->defines_components[0], "TextureStore") == 0);
             REQUIRE(std::strcmp(info->defines_components[1], "TextureComponents") == 0);
             REQUIRE(std::strcmp(info->defines_components[2], "TextureLoaderRegistry") == 0);
+            REQUIRE(std::strcmp(info->defines_components[3], "TextureStreamer") == 0);
+            REQUIRE(std::strcmp(info->defines_components[4], "TextureStoreView") == 0);
+            REQUIRE(std::strcmp(info->defines_components[5], "TexturePluginState") == 0);
         }
 
         THEN("it requires EntityCompactor") {
@@ -51,10 +79,13 @@ SCENARIO("texture plugin reports its metadata", "[texture]") {
             REQUIRE(info->init_fn != nullptr);
         }
 
-        THEN("it does not provide tick frame or shutdown functions") {
-            REQUIRE(info->tick_fn == nullptr);
+        THEN("it provides a tick function") {
+            REQUIRE(info->tick_fn != nullptr);
+        }
+
+        THEN("it provides a shutdown function but no frame function") {
             REQUIRE(info->frame_fn == nullptr);
-            REQUIRE(info->shutdown_fn == nullptr);
+            REQUIRE(info->shutdown_fn != nullptr);
         }
     }
 }
@@ -153,3 +184,259 @@ SCENARIO("texture plugin shutdown allows reinit on fresh world", "[texture]") {
         }
     }
 }
+
+SCENARIO("texture plugin initializes TextureStreamer", "[texture]") {
+    GIVEN("a world with EntityCompactor and the texture plugin") {
+        TextureTestContext context;
+
+        WHEN("init is called") {
+            context.init();
+
+            THEN("TextureStreamer is registered and retrievable") {
+                REQUIRE(context.texture_streamer() != nullptr);
+            }
+
+            context.shutdown();
+        }
+    }
+}
+
+SCENARIO("texture plugin tick decodes the coarsest mip first and one finer level per tick", "[texture]") {
+    GIVEN("an initialized texture plugin with a streamed 8x8 texture") {
+        TextureTestContext context;
+        context.init();
+
+        std::vector<uint32_t> decoded;
+        auto* streamer = context.texture_streamer();
+        streamer->add(0, 8, 8, solid_source(8, 200, decoded));
+
+        WHEN("tick is called once") {
+            context.tick();
+
+            THEN("only the 1x1 level is decoded and resident") {
+                auto* level = streamer->resident(0);
+                REQUIRE(level != nullptr);
+                REQUIRE(level->width == 1);
+                REQUIRE(level->height == 1);
+                REQUIRE(streamer->resident_level(0) == 3);
+                REQUIRE(decoded == std::vector<uint32_t>{3});
+                REQUIRE(streamer->resident_bytes() == 4);
+            }
+        }
+
+        WHEN("tick is called twice") {
+            context.tick();
+            context.tick();
+
+            THEN("the next finer level is decoded on the second tick") {
+                REQUIRE(streamer->resident_level(0) == 2);
+                REQUIRE(decoded == std::vector<uint32_t>{3, 2});
+            }
+        }
+
+        WHEN("tick is called until the requested level is reached") {
+            for (int tick = 0; tick < 4; ++tick) {
+                context.tick();
+            }
+
+            THEN("each level was decoded once, coarsest first") {
+                REQUIRE(streamer->resident_level(0) == 0);
+                REQUIRE(streamer->resident(0)->width == 8);
+                REQUIRE(streamer->resident(0)->pixels[0] == 200);
+                REQUIRE(decoded == std::vector<uint32_t>{3, 2, 1, 0});
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("texture plugin tick spends at most its byte budget refining", "[texture]") {
+    GIVEN("two staged 8x8 textures and a budget smaller than one 4x4 level") {
+        TextureTestContext context;
+        context.init();
+
+        std::vector<uint32_t> decoded;
+        auto* streamer = context.texture_streamer();
+        streamer->add(0, 8, 8, solid_source(8, 1, decoded));
+        streamer->add(1, 8, 8, solid_source(8, 2, decoded));
+        context.tick();
+        context.tick();
+        streamer->byte_budget_ = 32;
+
+        WHEN("one more tick runs") {
+            decoded.clear();
+            context.tick();
+
+            THEN("only one texture refines") {
+                REQUIRE(decoded == std::vector<uint32_t>{1});
+                REQUIRE(streamer->resident_level(0) + streamer->resident_level(1) == 1 + 2);
+            }
+        }
+
+        WHEN("a new texture is added") {
+            streamer->add(2, 8, 8, solid_source(8, 3, decoded));
+            decoded.clear();
+            context.tick();
+
+            THEN("its coarsest level is staged regardless of the budget") {
+                REQUIRE(streamer->resident_level(2) == 3);
+                REQUIRE(std::count(decoded.begin(), decoded.end(), 3u) == 1);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("a downsampled source decodes full resolution once per texture", "[texture]") {
+    GIVEN("an initialized texture plugin streaming an 8x8 texture from a full-resolution decoder") {
+        TextureTestContext context;
+        context.init();
+
+        int decodes = 0;
+        auto chain = cask::downsampled_source([&decodes] {
+            ++decodes;
+            return solid_level(8, 8, 40);
+        });
+        auto* streamer = context.texture_streamer();
+        streamer->add(0, 8, 8, chain);
+
+        WHEN("the texture refines from its coarsest level to full resolution") {
+            for (int tick = 0; tick < 4; ++tick) {
+                context.tick();
+            }
+
+            THEN("every level came from one decode") {
+                REQUIRE(streamer->resident_level(0) == 0);
+                REQUIRE(streamer->resident(0)->width == 8);
+                REQUIRE(streamer->resident(0)->pixels[0] == 40);
+                REQUIRE(decodes == 1);
+                REQUIRE(chain->decodes_ == 1);
+            }
+
+            THEN("the cached chain is kept until the texture settles") {
+                REQUIRE_FALSE(chain->levels_.empty());
+                context.tick();
+                REQUIRE(chain->levels_.empty());
+            }
+        }
+
+        WHEN("a finer level is requested after the chain was released") {
+            streamer->request(0, 2);
+            for (int tick = 0; tick < 3; ++tick) {
+                context.tick();
+            }
+            REQUIRE(chain->levels_.empty());
+            streamer->request(0, 0);
+            for (int tick = 0; tick < 2; ++tick) {
+                context.tick();
+            }
+
+            THEN("the decoder runs once more for the finer levels") {
+                REQUIRE(streamer->resident_level(0) == 0);
+                REQUIRE(streamer->resident(0)->pixels[0] == 40);
+                REQUIRE(decodes == 2);
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("texture streamer refuses requests for unknown textures", "[texture]") {
+    GIVEN("a streamer holding one texture") {
+        cask::TextureStreamer streamer;
+        std::vector<uint32_t> decoded;
+        streamer.add(0, 8, 8, solid_source(8, 1, decoded));
+
+        THEN("a request for another texture fails without throwing") {
+            REQUIRE_FALSE(streamer.request(7, 1));
+            REQUIRE(streamer.request(0, 1));
+        }
+    }
+}
+
+SCENARIO("texture plugin tick keeps only the requested mip levels resident", "[texture]") {
+    GIVEN("an initialized texture plugin with a texture requested at mip 2") {
+        TextureTestContext context;
+        context.init();
+
+        std::vector<uint32_t> decoded;
+        auto* streamer = context.texture_streamer();
+        streamer->add(0, 8, 8, solid_source(8, 10, decoded));
+        streamer->request(0, 2);
+
+        WHEN("the texture settles at its requested level") {
+            for (int tick = 0; tick < 3; ++tick) {
+                context.tick();
+            }
+
+            THEN("the resident level is 2x2") {
+                REQUIRE(streamer->resident_level(0) == 2);
+                REQUIRE(streamer->resident(0)->width == 2);
+            }
+
+            THEN("levels finer than the request are released") {
+                REQUIRE(streamer->resident_bytes() == (2 * 2 + 1) * 4);
+            }
+        }
+
+        WHEN("a finer level is requested after settling") {
+            for (int tick = 0; tick < 3; ++tick) {
+                context.tick();
+            }
+            streamer->request(0, 1);
+            context.tick();
+
+            THEN("only the newly requested level is decoded") {
+                REQUIRE(streamer->resident_level(0) == 1);
+                REQUIRE(streamer->resident(0)->width == 4);
+                REQUIRE(streamer->resident(0)->pixels[0] == 10);
+                REQUIRE(decoded == std::vector<uint32_t>{3, 2, 1});
+            }
+        }
+
+        context.shutdown();
+    }
+}
+
+SCENARIO("texture plugin tick counts loaded and evicted mip levels when Metrics is present", "[texture]") {
+    GIVEN("an initialized texture plugin with a bound Metrics and a texture requested at mip 2") {
+        TextureTestContext context;
+        cask::Metrics metrics;
+        uint32_t metrics_id = context.world.register_component("Metrics");
+        context.world.bind(metrics_id, &metrics);
+        context.init();
+
+        std::vector<uint32_t> decoded;
+        auto* streamer = context.texture_streamer();
+        streamer->add(0, 8, 8, solid_source(8, 10, decoded));
+        streamer->request(0, 2);
+
+        WHEN("the texture settles at its requested level") {
+            for (int tick = 0; tick < 3; ++tick) {
+                context.tick();
+            }
+
+            THEN("only the decoded levels are counted as loaded") {
+                REQUIRE(metrics.counter("cask_texture_levels_loaded_total", "").value() == 2);
+                REQUIRE(metrics.counter("cask_texture_levels_evicted_total", "").value() == 0);
+            }
+        }
+
+        WHEN("a coarser level is requested after settling") {
+            for (int tick = 0; tick < 3; ++tick) {
+                context.tick();
+            }
+            streamer->request(0, 3);
+            context.tick();
+
+            THEN("the released finer level is counted as evicted") {
+                REQUIRE(metrics.counter("cask_texture_levels_evicted_total", "").value() == 1);
+            }
+        }
+
+        context.shutdown();
+    }
+}
@@ -0,0 +1,21 @@
+#include <cask/foundation/pack_archive.hpp>
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <project_directory> <output.pack>\n", argv[0]);
+        return 1;
+    }
+    if (!cask::write_pack(argv[1], argv[2])) {
+        std::fprintf(stderr, "failed to pack %s into %s\n", argv[1], argv[2]);
+        return 1;
+    }
+    cask::PackArchive archive;
+    if (!archive.open(argv[2])) {
+        std::fprintf(stderr, "wrote %s but it could not be reopened\n", argv[2]);
+        return 1;
+    }
+    std::printf("packed %zu files into %s\n", archive.entry_count(), argv[2]);
+    return 0;
+}
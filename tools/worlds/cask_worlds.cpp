@@ -0,0 +1,85 @@
+#include <cask/abi.h>
+#include <cask/foundation/world_harness.hpp>
+#include <dlfcn.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" PluginInfo** get_plugin_infos(size_t* count);
+
+static PluginInfo* find_plugin(PluginInfo** plugins, size_t count, const char* name) {
+    for (size_t index = 0; index < count; ++index) {
+        if (std::strcmp(plugins[index]->name, name) == 0) return plugins[index];
+    }
+    return nullptr;
+}
+
+static std::vector<std::string> split_names(const char* list) {
+    std::vector<std::string> names;
+    std::string name;
+    for (const char* cursor = list; ; ++cursor) {
+        if (*cursor != ',' && *cursor != '\0') {
+            name += *cursor;
+            continue;
+        }
+        if (!name.empty()) names.push_back(name);
+        name.clear();
+        if (*cursor == '\0') return names;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* bundled_names = "event,interpolation,entity,identity";
+    int first = 1;
+    if (argc > 1 && std::strncmp(argv[1], "--plugins=", 10) == 0) {
+        bundled_names = argv[1] + 10;
+        first = 2;
+    }
+    if (argc < first + 2) {
+        std::fprintf(stderr, "usage: %s [--plugins=name,...] <worlds> <ticks> [game_plugin.so ...]\n", argv[0]);
+        return 1;
+    }
+    size_t world_count = std::strtoul(argv[first], nullptr, 10);
+    size_t ticks = std::strtoul(argv[first + 1], nullptr, 10);
+
+    size_t count = 0;
+    PluginInfo** bundled = get_plugin_infos(&count);
+    std::vector<PluginInfo*> plugins;
+    for (auto& name : split_names(bundled_names)) {
+        auto* plugin = bundled ? find_plugin(bundled, count, name.c_str()) : nullptr;
+        if (!plugin) {
+            std::fprintf(stderr, "no bundled plugin named %s; available:", name.c_str());
+            for (size_t index = 0; index < count; ++index) {
+                std::fprintf(stderr, " %s", bundled[index]->name);
+            }
+            std::fprintf(stderr, "\n");
+            return 1;
+        }
+        plugins.push_back(plugin);
+    }
+    for (int arg = first + 2; arg < argc; ++arg) {
+        void* library = dlopen(argv[arg], RTLD_NOW | RTLD_LOCAL);
+        auto* get_info = library ? reinterpret_cast<PluginInfo* (*)()>(dlsym(library, "get_plugin_info")) : nullptr;
+        if (!get_info) {
+            std::fprintf(stderr, "failed to load %s\n", argv[arg]);
+            return 1;
+        }
+        plugins.push_back(get_info());
+    }
+
+    cask::WorldHarness harness(plugins);
+    harness.spawn(world_count);
+    std::printf("%zu worlds, %zu ticks, %zu plugins\n", harness.size(), ticks, plugins.size());
+    std::printf("%8s %16s %10s %10s %10s %10s %8s\n", "threads", "world ticks/s", "p50 us", "p99 us", "p99.9 us", "max us", "scaling");
+    double baseline = 0.0;
+    for (auto& report : harness.scaling(ticks, std::thread::hardware_concurrency())) {
+        if (baseline == 0.0) baseline = report.world_ticks_per_second;
+        std::printf("%8zu %16.0f %10.2f %10.2f %10.2f %10.2f %7.2fx\n",
+            report.threads, report.world_ticks_per_second, report.p50_us, report.p99_us, report.p999_us, report.max_us,
+            baseline > 0.0 ? report.world_ticks_per_second / baseline : 0.0);
+    }
+    return 0;
+}